@@ -64,6 +64,18 @@ static void API_queryRenderedFeaturesLayerFromHighDensity(::benchmark::State& st
     }
 }
 
+static void API_queryRenderedFeaturesHover(::benchmark::State& state) {
+    QueryBenchmark bench;
+
+    // Sweeps a point diagonally across the map, as a pointer hovering over it would.
+    double position = 0;
+    while (state.KeepRunning()) {
+        bench.frontend.getRenderer()->queryRenderedFeatures(ScreenCoordinate { position, position }, {});
+        position = position < 1000 ? position + 7 : 0;
+    }
+}
+
 BENCHMARK(API_queryRenderedFeaturesAll);
 BENCHMARK(API_queryRenderedFeaturesLayerFromLowDensity);
 BENCHMARK(API_queryRenderedFeaturesLayerFromHighDensity);
+BENCHMARK(API_queryRenderedFeaturesHover);
@@ -1,5 +1,6 @@
 #include <benchmark/benchmark.h>
 
+#include <mbgl/annotation/annotation.hpp>
 #include <mbgl/map/map.hpp>
 #include <mbgl/map/map_observer.hpp>
 #include <mbgl/gl/headless_frontend.hpp>
@@ -7,12 +8,15 @@
 #include <mbgl/renderer/renderer.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/image.hpp>
+#include <mbgl/style/layer.hpp>
 #include <mbgl/storage/default_file_source.hpp>
 #include <mbgl/storage/network_status.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <random>
+
 using namespace mbgl;
 
 namespace {
@@ -49,6 +53,24 @@ static void API_renderStill_reuse_map(::benchmark::State& state) {
     }
 }
 
+static void API_renderStill_reuse_map_pan(::benchmark::State& state) {
+    RenderBenchmark bench;
+    HeadlessFrontend frontend { { 1000, 1000 }, 1, bench.fileSource, bench.threadPool };
+    Map map { frontend, MapObserver::nullObserver(), frontend.getSize(), 1, bench.fileSource, bench.threadPool, MapMode::Still };
+    prepare(map);
+    frontend.render(map);
+
+    // Moves the camera back and forth by a pixel, so every frame reprojects line labels
+    // without loading any new tiles. Compare with API_renderStill_reuse_map, which keeps
+    // the camera still.
+    double offset = 1;
+    while (state.KeepRunning()) {
+        map.moveBy({ offset, 0 });
+        offset = -offset;
+        frontend.render(map);
+    }
+}
+
 static void API_renderStill_reuse_map_switch_styles(::benchmark::State& state) {
     RenderBenchmark bench;
     HeadlessFrontend frontend { { 1000, 1000 }, 1, bench.fileSource, bench.threadPool };
@@ -62,6 +84,106 @@ static void API_renderStill_reuse_map_switch_styles(::benchmark::State& state) {
     }
 }
 
+static void API_renderStill_many_layers(::benchmark::State& state) {
+    RenderBenchmark bench;
+    HeadlessFrontend frontend { { 1000, 1000 }, 1, bench.fileSource, bench.threadPool };
+    Map map { frontend, MapObserver::nullObserver(), frontend.getSize(), 1, bench.fileSource, bench.threadPool, MapMode::Still };
+    prepare(map);
+
+    // Layers cloned with cloneRef() share their original's buckets, so this multiplies the
+    // number of draw calls without adding any layout work.
+    for (const auto* layer : map.getStyle().getLayers()) {
+        for (int i = 1; i < 5; i++) {
+            map.getStyle().addLayer(layer->cloneRef(layer->getID() + "-" + std::to_string(i)));
+        }
+    }
+    frontend.render(map);
+
+    while (state.KeepRunning()) {
+        frontend.render(map);
+    }
+}
+
+static void API_renderStill_move_annotation(::benchmark::State& state) {
+    RenderBenchmark bench;
+    HeadlessFrontend frontend { { 1000, 1000 }, 1, bench.fileSource, bench.threadPool };
+    Map map { frontend, MapObserver::nullObserver(), frontend.getSize(), 1, bench.fileSource, bench.threadPool, MapMode::Still };
+    prepare(map, { "{}" });
+    map.setLatLngZoom({ 40.726989, -73.992857 }, 10);
+    map.addAnnotationImage(std::make_unique<style::Image>("marker",
+                                                          decodeImage(util::read_file("benchmark/fixtures/api/default_marker.png")), 1.0));
+
+    // 5000 markers and 500 routes spread over a few hundred tiles around the viewport.
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> longitude(-75, -73);
+    std::uniform_real_distribution<double> latitude(40, 41.5);
+    std::vector<AnnotationID> markers;
+    for (int i = 0; i < 5000; i++) {
+        markers.push_back(map.addAnnotation(SymbolAnnotation { { longitude(random), latitude(random) }, "marker" }));
+    }
+    for (int i = 0; i < 500; i++) {
+        LineString<double> route;
+        route.emplace_back(longitude(random), latitude(random));
+        for (int j = 0; j < 20; j++) {
+            route.emplace_back(route.back().x + 0.01 * (j % 3 - 1), route.back().y + 0.01);
+        }
+        map.addAnnotation(LineAnnotation { route });
+    }
+    frontend.render(map);
+
+    while (state.KeepRunning()) {
+        const AnnotationID marker = markers[random() % markers.size()];
+        map.updateAnnotation(marker, SymbolAnnotation { { longitude(random), latitude(random) }, "marker" });
+        frontend.render(map);
+    }
+}
+
+// Time to load n markers and render the first frame with them.
+static void API_renderStill_add_annotations(::benchmark::State& state, bool bulk) {
+    RenderBenchmark bench;
+    HeadlessFrontend frontend { { 1000, 1000 }, 1, bench.fileSource, bench.threadPool };
+    Map map { frontend, MapObserver::nullObserver(), frontend.getSize(), 1, bench.fileSource, bench.threadPool, MapMode::Still };
+    prepare(map, { "{}" });
+    map.setLatLngZoom({ 40.726989, -73.992857 }, 10);
+    map.addAnnotationImage(std::make_unique<style::Image>("marker",
+                                                          decodeImage(util::read_file("benchmark/fixtures/api/default_marker.png")), 1.0));
+    frontend.render(map);
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> longitude(-180, 180);
+    std::uniform_real_distribution<double> latitude(-80, 80);
+    std::vector<Annotation> markers;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        markers.push_back(SymbolAnnotation { { longitude(random), latitude(random) }, "marker" });
+    }
+
+    while (state.KeepRunning()) {
+        AnnotationIDs ids;
+        if (bulk) {
+            ids = map.addAnnotations(markers);
+        } else {
+            for (const auto& marker : markers) {
+                ids.push_back(map.addAnnotation(marker));
+            }
+        }
+        frontend.render(map);
+
+        state.PauseTiming();
+        map.removeAnnotations(ids);
+        frontend.render(map);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void API_renderStill_add_annotations_bulk(::benchmark::State& state) {
+    API_renderStill_add_annotations(state, true);
+}
+
+static void API_renderStill_add_annotations_single(::benchmark::State& state) {
+    API_renderStill_add_annotations(state, false);
+}
+
 static void API_renderStill_recreate_map(::benchmark::State& state) {
     RenderBenchmark bench;
     
@@ -74,5 +196,10 @@ static void API_renderStill_recreate_map(::benchmark::State& state) {
 }
 
 BENCHMARK(API_renderStill_reuse_map);
+BENCHMARK(API_renderStill_reuse_map_pan);
 BENCHMARK(API_renderStill_reuse_map_switch_styles);
+BENCHMARK(API_renderStill_many_layers);
+BENCHMARK(API_renderStill_move_annotation);
+BENCHMARK(API_renderStill_add_annotations_bulk)->Arg(10000)->Arg(100000)->Arg(1000000);
+BENCHMARK(API_renderStill_add_annotations_single)->Arg(10000)->Arg(100000)->Arg(1000000);
 BENCHMARK(API_renderStill_recreate_map);
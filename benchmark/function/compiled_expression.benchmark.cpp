@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/style/conversion.hpp>
+#include <mbgl/util/rapidjson.hpp>
+#include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/style/expression/parsing_context.hpp>
+#include <mbgl/style/expression/compiled_expression.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+using namespace mbgl::style::expression;
+
+using namespace std::string_literals;
+
+// A typical data-driven road width: a zoom curve whose stops depend on the road class.
+static const char* roadWidth = R"(["interpolate", ["exponential", 1.5], ["zoom"],
+    5, ["match", ["get", "class"], ["motorway", "trunk"], 0.75, "primary", 0.5, 0.25],
+    18, ["*", ["match", ["get", "class"], ["motorway", "trunk"], 32, "primary", 26, 18], ["+", 1, 0.5]]
+])";
+
+static std::unique_ptr<Expression> parseExpression(const char* json) {
+    JSDocument document;
+    document.Parse<0>(json);
+    const JSValue* value = &document;
+    ParsingContext ctx;
+    ParseResult parsed = ctx.parse(conversion::Convertible(value));
+    return parsed ? std::move(*parsed) : nullptr;
+}
+
+static const std::vector<StubGeometryTileFeature> roads {
+    StubGeometryTileFeature(PropertyMap { { "class", "motorway"s } }),
+    StubGeometryTileFeature(PropertyMap { { "class", "primary"s } }),
+    StubGeometryTileFeature(PropertyMap { { "class", "street"s } })
+};
+
+static void Evaluate_ExpressionTree(benchmark::State& state) {
+    auto expression = parseExpression(roadWidth);
+    std::size_t i = 0;
+
+    while (state.KeepRunning()) {
+        const auto& feature = roads[i++ % roads.size()];
+        benchmark::DoNotOptimize(expression->evaluate(EvaluationContext(float(i % 20), &feature)));
+    }
+}
+
+static void Evaluate_CompiledExpression(benchmark::State& state) {
+    auto expression = parseExpression(roadWidth);
+    auto compiled = CompiledExpression::compile(*expression);
+    if (!compiled) {
+        state.SkipWithError("expression was not compiled");
+        return;
+    }
+    std::size_t i = 0;
+
+    while (state.KeepRunning()) {
+        const auto& feature = roads[i++ % roads.size()];
+        benchmark::DoNotOptimize(compiled->evaluate(EvaluationContext(float(i % 20), &feature)));
+    }
+}
+
+BENCHMARK(Evaluate_ExpressionTree);
+BENCHMARK(Evaluate_CompiledExpression);
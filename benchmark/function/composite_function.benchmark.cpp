@@ -60,10 +60,64 @@ static void Evaluate_CompositeFunction(benchmark::State& state) {
     state.SetLabel(std::to_string(stopCount).c_str());
 }
 
+// Evaluates the function over the features of a whole tile layer, one feature at a time.
+static void Evaluate_CompositeFunctionFeatures(benchmark::State& state) {
+    auto doc = createFunctionJSON(state.range(0));
+    conversion::Error error;
+    optional<CompositeFunction<float>> function = conversion::convertJSON<CompositeFunction<float>>(doc, error);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+    }
+
+    std::vector<StubGeometryTileFeature> layer;
+    for (int64_t i = 0; i < 1024; i++) {
+        layer.emplace_back(PropertyMap { { "x", i % 100 } });
+    }
+    const Range<float> zoomRange { 10.0f, 11.0f };
+
+    while(state.KeepRunning()) {
+        for (const auto& feature : layer) {
+            benchmark::DoNotOptimize(function->evaluate(zoomRange, feature, -1.0f));
+        }
+    }
+
+    state.SetLabel(std::to_string(state.range(0)).c_str());
+}
+
+// Evaluates the function over the same features as a single batch.
+static void Evaluate_CompositeFunctionBatch(benchmark::State& state) {
+    auto doc = createFunctionJSON(state.range(0));
+    conversion::Error error;
+    optional<CompositeFunction<float>> function = conversion::convertJSON<CompositeFunction<float>>(doc, error);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+    }
+
+    std::vector<StubGeometryTileFeature> layer;
+    for (int64_t i = 0; i < 1024; i++) {
+        layer.emplace_back(PropertyMap { { "x", i % 100 } });
+    }
+    std::vector<const StubGeometryTileFeature*> features;
+    for (const auto& feature : layer) {
+        features.push_back(&feature);
+    }
+    const Range<float> zoomRange { 10.0f, 11.0f };
+
+    while(state.KeepRunning()) {
+        benchmark::DoNotOptimize(function->evaluate(zoomRange, features, -1.0f));
+    }
+
+    state.SetLabel(std::to_string(state.range(0)).c_str());
+}
+
 BENCHMARK(Parse_CompositeFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
 BENCHMARK(Evaluate_CompositeFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
+BENCHMARK(Evaluate_CompositeFunctionFeatures)
+    ->Arg(1)->Arg(4)->Arg(12);
 
+BENCHMARK(Evaluate_CompositeFunctionBatch)
+    ->Arg(1)->Arg(4)->Arg(12);
@@ -54,10 +54,62 @@ static void Evaluate_SourceFunction(benchmark::State& state) {
     state.SetLabel(std::to_string(stopCount).c_str());
 }
 
+// Evaluates the function over the features of a whole tile layer, one feature at a time.
+static void Evaluate_SourceFunctionFeatures(benchmark::State& state) {
+    auto doc = createFunctionJSON(state.range(0));
+    conversion::Error error;
+    optional<SourceFunction<float>> function = conversion::convertJSON<SourceFunction<float>>(doc, error);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+    }
+
+    std::vector<StubGeometryTileFeature> layer;
+    for (int64_t i = 0; i < 1024; i++) {
+        layer.emplace_back(PropertyMap { { "x", i % 100 } });
+    }
+
+    while(state.KeepRunning()) {
+        for (const auto& feature : layer) {
+            benchmark::DoNotOptimize(function->evaluate(feature, -1.0f));
+        }
+    }
+
+    state.SetLabel(std::to_string(state.range(0)).c_str());
+}
+
+// Evaluates the function over the same features as a single batch.
+static void Evaluate_SourceFunctionBatch(benchmark::State& state) {
+    auto doc = createFunctionJSON(state.range(0));
+    conversion::Error error;
+    optional<SourceFunction<float>> function = conversion::convertJSON<SourceFunction<float>>(doc, error);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+    }
+
+    std::vector<StubGeometryTileFeature> layer;
+    for (int64_t i = 0; i < 1024; i++) {
+        layer.emplace_back(PropertyMap { { "x", i % 100 } });
+    }
+    std::vector<const StubGeometryTileFeature*> features;
+    for (const auto& feature : layer) {
+        features.push_back(&feature);
+    }
+
+    while(state.KeepRunning()) {
+        benchmark::DoNotOptimize(function->evaluate(features, -1.0f));
+    }
+
+    state.SetLabel(std::to_string(state.range(0)).c_str());
+}
+
 BENCHMARK(Parse_SourceFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
 BENCHMARK(Evaluate_SourceFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
+BENCHMARK(Evaluate_SourceFunctionFeatures)
+    ->Arg(1)->Arg(4)->Arg(12);
 
+BENCHMARK(Evaluate_SourceFunctionBatch)
+    ->Arg(1)->Arg(4)->Arg(12);
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark.hpp>
+#include <mbgl/geometry/polygon_tessellator.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// The polygons of the layers a typical style draws as fills.
+std::vector<GeometryCollection> loadPolygons() {
+    VectorTileData tile(std::make_shared<std::string>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+
+    std::vector<GeometryCollection> polygons;
+    for (const auto& name : { "water", "landuse", "landuse_overlay", "building", "park" }) {
+        if (auto layer = tile.getLayer(name)) {
+            for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                auto feature = layer->getFeature(i);
+                if (feature->getType() == FeatureType::Polygon) {
+                    polygons.push_back(feature->getGeometries());
+                }
+            }
+        }
+    }
+    return polygons;
+}
+
+std::size_t tessellate(PolygonTessellator& tessellator, const GeometryCollection& geometry) {
+    std::size_t count = 0;
+    for (const auto& polygon : tessellator.classifyRings(geometry, 500)) {
+        count += tessellator.tessellate(polygon).size();
+    }
+    return count;
+}
+
+} // namespace
+
+static void Tessellate_Polygons(benchmark::State& state) {
+    const auto polygons = loadPolygons();
+    PolygonTessellator tessellator;
+
+    const std::size_t allocations = heapAllocations();
+
+    while (state.KeepRunning()) {
+        for (const auto& geometry : polygons) {
+            benchmark::DoNotOptimize(tessellate(tessellator, geometry));
+        }
+    }
+
+    state.counters["allocations"] = double(heapAllocations() - allocations) / state.iterations();
+}
+
+// A new tessellator for every feature, so its buffers are allocated for every polygon.
+static void Tessellate_Polygons_NoReuse(benchmark::State& state) {
+    const auto polygons = loadPolygons();
+
+    const std::size_t allocations = heapAllocations();
+
+    while (state.KeepRunning()) {
+        for (const auto& geometry : polygons) {
+            PolygonTessellator tessellator;
+            benchmark::DoNotOptimize(tessellate(tessellator, geometry));
+        }
+    }
+
+    state.counters["allocations"] = double(heapAllocations() - allocations) / state.iterations();
+}
+
+BENCHMARK(Tessellate_Polygons);
+BENCHMARK(Tessellate_Polygons_NoReuse);
@@ -1,7 +1,15 @@
 #pragma once
 
+#include <cstddef>
+
 namespace mbgl {
 
 int runBenchmark(int argc, char* argv[]);
 
+// Returns the number of heap allocations the benchmark process has made so far.
+std::size_t heapAllocations();
+
+// Returns the number of bytes the benchmark process has requested from the heap so far.
+std::size_t heapBytes();
+
 } // namespace mbgl
@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark.hpp>
+#include <mbgl/tile/tile_snapshot.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/renderer/render_layer.hpp>
+#include <mbgl/renderer/transition_parameters.hpp>
+#include <mbgl/renderer/property_evaluation_parameters.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+class SnapshotBenchmark {
+public:
+    SnapshotBenchmark() {
+        auto water = std::make_unique<FillLayer>("water", "source");
+        water->setSourceLayer("water");
+        auto landuse = std::make_unique<FillLayer>("landuse", "source");
+        landuse->setSourceLayer("landuse");
+        auto road = std::make_unique<LineLayer>("road", "source");
+        road->setSourceLayer("road");
+
+        layers.push_back(std::move(water));
+        layers.push_back(std::move(landuse));
+        layers.push_back(std::move(road));
+
+        for (const auto& layer : layers) {
+            renderLayers.push_back(RenderLayer::create(layer->baseImpl));
+            renderLayers.back()->transition(TransitionParameters { Clock::time_point::max(), TransitionOptions() });
+            renderLayers.back()->evaluate(PropertyEvaluationParameters { float(tileID.overscaledZ) });
+            groups.push_back({ renderLayers.back().get() });
+        }
+    }
+
+    // Mirrors the non-symbol part of GeometryTileWorker::redoLayout().
+    TileSnapshot::Buckets layout(FeatureIndex& featureIndex) const {
+        TileSnapshot::Buckets buckets;
+        VectorTileData tile(data);
+        std::vector<std::unique_ptr<GeometryTileFeature>> features;
+        std::vector<GeometryCollection> geometries;
+        std::vector<std::size_t> indices;
+        for (const auto& group : groups) {
+            const RenderLayer& leader = *group.at(0);
+            auto geometryLayer = tile.getLayer(leader.baseImpl->sourceLayer);
+            if (!geometryLayer) {
+                continue;
+            }
+
+            featureIndex.setBucketLayerIDs(leader.getID(), { leader.getID() });
+            std::shared_ptr<Bucket> bucket = leader.createBucket(parameters, group);
+            const std::size_t featureCount = geometryLayer->featureCount();
+            features.clear();
+            geometries.clear();
+            indices.clear();
+            features.reserve(featureCount);
+            geometries.reserve(featureCount);
+            indices.reserve(featureCount);
+            for (std::size_t i = 0; i < featureCount; i++) {
+                features.push_back(geometryLayer->getFeature(i));
+                geometries.push_back(features.back()->getGeometries());
+                indices.push_back(i);
+            }
+            bucket->addFeatures(features, geometries, indices);
+            const StringIdentity sourceLayerName = featureIndex.intern(leader.baseImpl->sourceLayer);
+            const StringIdentity bucketName = featureIndex.intern(leader.getID());
+            for (std::size_t i = 0; i < features.size(); i++) {
+                featureIndex.insert(geometries[i], i, sourceLayerName, bucketName);
+            }
+
+            if (bucket->hasData()) {
+                buckets.emplace(leader.getID(), bucket);
+            }
+        }
+        return buckets;
+    }
+
+    const std::shared_ptr<const std::string> data = std::make_shared<std::string>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    const OverscaledTileID tileID { 10, 163, 395 };
+    const BucketParameters parameters { tileID, MapMode::Still, 1.0 };
+    std::vector<std::unique_ptr<Layer>> layers;
+    std::vector<std::unique_ptr<RenderLayer>> renderLayers;
+    TileSnapshot::LayerGroups groups;
+};
+
+} // namespace
+
+static void Parse_TileSnapshotLayout(benchmark::State& state) {
+    SnapshotBenchmark bench;
+    const std::size_t allocations = heapAllocations();
+
+    while (state.KeepRunning()) {
+        FeatureIndex featureIndex;
+        benchmark::DoNotOptimize(bench.layout(featureIndex));
+    }
+
+    state.counters["allocations"] = double(heapAllocations() - allocations) / state.iterations();
+}
+
+static void Parse_TileSnapshotRestore(benchmark::State& state) {
+    SnapshotBenchmark bench;
+    FeatureIndex featureIndex;
+    auto buckets = bench.layout(featureIndex);
+    const TileSnapshot::Key key { bench.tileID, 0, TileSnapshot::hashData(*bench.data) };
+    const std::string snapshot = *TileSnapshot::encode(key, bench.groups, buckets, featureIndex);
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(TileSnapshot::decode(snapshot.data(), snapshot.size(),
+                                                      key, bench.parameters, bench.groups));
+    }
+}
+
+BENCHMARK(Parse_TileSnapshotLayout);
+BENCHMARK(Parse_TileSnapshotRestore);
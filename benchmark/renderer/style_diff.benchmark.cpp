@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/renderer/style_diff.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/style/layers/line_layer_impl.hpp>
+
+#include <algorithm>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+using Layers = std::vector<ImmutableLayer>;
+
+// A large style: a few hundred layers over a single source.
+Layers makeLayers(std::size_t count) {
+    Layers layers;
+    for (std::size_t i = 0; i < count; ++i) {
+        layers.push_back(LineLayer("layer-" + std::to_string(i), "source").baseImpl);
+    }
+    return layers;
+}
+
+} // namespace
+
+// A frame of an animation that changes a paint property of a few layers.
+static void StyleDiff_Paint(benchmark::State& state) {
+    const Layers layers = makeLayers(600);
+    Immutable<Layers> before = makeMutable<Layers>(layers);
+
+    std::size_t frame = 0;
+    while (state.KeepRunning()) {
+        Mutable<Layers> after = makeMutable<Layers>(*before);
+        for (std::size_t i = 0; i < 4; ++i) {
+            auto& layer = (*after)[(frame * 4 + i * 151) % after->size()];
+            layer = makeMutable<LineLayer::Impl>(static_cast<const LineLayer::Impl&>(*layer));
+        }
+        Immutable<Layers> next = std::move(after);
+        benchmark::DoNotOptimize(diffLayers(before, next));
+        before = next;
+        frame++;
+    }
+}
+
+// Moving one layer to the top, as a "bring to front" would.
+static void StyleDiff_Move(benchmark::State& state) {
+    const Layers layers = makeLayers(600);
+    Immutable<Layers> before = makeMutable<Layers>(layers);
+
+    while (state.KeepRunning()) {
+        Mutable<Layers> after = makeMutable<Layers>(*before);
+        std::rotate(after->begin(), after->begin() + 1, after->end());
+        Immutable<Layers> next = std::move(after);
+        benchmark::DoNotOptimize(diffLayers(before, next));
+        before = next;
+    }
+}
+
+// Reloading the style replaces every layer.
+static void StyleDiff_Reload(benchmark::State& state) {
+    const Immutable<Layers> before = makeMutable<Layers>(makeLayers(600));
+    const Immutable<Layers> after = makeMutable<Layers>(makeLayers(600));
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(diffLayers(before, after));
+    }
+}
+
+BENCHMARK(StyleDiff_Paint);
+BENCHMARK(StyleDiff_Move);
+BENCHMARK(StyleDiff_Reload);
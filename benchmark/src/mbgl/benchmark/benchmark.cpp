@@ -2,8 +2,47 @@
 
 #include <benchmark/benchmark.h>
 
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::size_t> allocations { 0 };
+std::atomic<std::size_t> bytes { 0 };
+
+} // namespace
+
+// Replaces the global allocation functions so benchmarks can report how often, and how much,
+// they allocate.
+// The array and nothrow forms call these by default.
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
 namespace mbgl {
 
+std::size_t heapAllocations() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+std::size_t heapBytes() {
+    return bytes.load(std::memory_order_relaxed);
+}
+
 int runBenchmark(int argc, char* argv[]) {
     ::benchmark::Initialize(&argc, argv);
     ::benchmark::RunSpecifiedBenchmarks();
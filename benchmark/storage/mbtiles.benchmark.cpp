@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+#include <mbgl/benchmark.hpp>
+
+#include <mbgl/storage/mbtiles_archive.hpp>
+#include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/io.hpp>
+
+#include "sqlite3.hpp"
+
+#include <zlib.h>
+
+#include <cstdio>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+const std::string archivePath = "benchmark/fixtures/storage.benchmark.mbtiles";
+const std::string cachePath = "benchmark/fixtures/storage.benchmark.db";
+const std::string tilePath = "test/fixtures/api/assets/streets/10-163-395.vector.pbf";
+const std::string urlTemplate = "http://example.com/{z}-{x}-{y}.vector.pbf";
+constexpr int8_t zoom = 10;
+constexpr int32_t side = 16;
+
+std::string gzip(const std::string& raw) {
+    z_stream stream {};
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY);
+    std::string result(deflateBound(&stream, uLong(raw.size())), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(raw.data()));
+    stream.avail_in = uInt(raw.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&result[0]);
+    stream.avail_out = uInt(result.size());
+    deflate(&stream, Z_FINISH);
+    result.resize(stream.total_out);
+    deflateEnd(&stream);
+    return result;
+}
+
+// Stores the same side x side block of tiles in an MBTiles archive and in the ambient cache.
+void createFixtures() {
+    std::remove(archivePath.c_str());
+    std::remove(cachePath.c_str());
+
+    const std::string tile = util::read_file(tilePath);
+    const std::string gzipped = gzip(tile);
+
+    mapbox::sqlite::Database archive(archivePath, mapbox::sqlite::ReadWrite | mapbox::sqlite::Create);
+    archive.exec("CREATE TABLE metadata (name TEXT, value TEXT)");
+    archive.exec("CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB)");
+    archive.exec("CREATE UNIQUE INDEX tile_index ON tiles (zoom_level, tile_column, tile_row)");
+    mapbox::sqlite::Transaction transaction(archive);
+    auto insert = archive.prepare("INSERT INTO tiles VALUES (?1, ?2, ?3, ?4)");
+
+    OfflineDatabase cache(cachePath);
+    Response response;
+    response.data = std::make_shared<std::string>(tile);
+
+    for (int32_t x = 0; x < side; ++x) {
+        for (int32_t y = 0; y < side; ++y) {
+            insert.bind(1, int32_t(zoom));
+            insert.bind(2, x);
+            insert.bind(3, y);
+            insert.bindBlob(4, gzipped.data(), gzipped.size(), false);
+            insert.run();
+            insert.reset();
+
+            cache.put(Resource::tile(urlTemplate, 1, x, y, zoom, Tileset::Scheme::XYZ), response);
+        }
+    }
+
+    transaction.commit();
+}
+
+// Every copy of a tile's bytes lands in a fresh heap allocation, so the bytes allocated per lookup,
+// next to the size of the tile itself, show how often the tile was copied on its way out.
+void countBytes(benchmark::State& state, std::size_t bytes) {
+    state.counters["tileBytes"] = util::read_file(tilePath).size();
+    state.counters["allocatedBytes"] = double(heapBytes() - bytes) / state.iterations();
+}
+
+} // namespace
+
+static void Storage_MBTilesArchive_getTile(benchmark::State& state) {
+    createFixtures();
+
+    MBTilesArchive archive(archivePath);
+    int32_t i = 0;
+    const std::size_t bytes = heapBytes();
+
+    while (state.KeepRunning()) {
+        auto data = archive.getTile(zoom, i % side, (i / side) % side);
+        benchmark::DoNotOptimize(data);
+        ++i;
+    }
+
+    countBytes(state, bytes);
+
+    std::remove(archivePath.c_str());
+    std::remove(cachePath.c_str());
+}
+
+static void Storage_OfflineDatabase_getTile(benchmark::State& state) {
+    createFixtures();
+
+    OfflineDatabase cache(cachePath);
+    std::vector<Resource> resources;
+    for (int32_t i = 0; i < side * side; ++i) {
+        resources.push_back(Resource::tile(urlTemplate, 1, i % side, i / side, zoom, Tileset::Scheme::XYZ));
+    }
+    size_t i = 0;
+    const std::size_t bytes = heapBytes();
+
+    while (state.KeepRunning()) {
+        auto response = cache.get(resources[i++ % resources.size()]);
+        benchmark::DoNotOptimize(response);
+    }
+
+    countBytes(state, bytes);
+
+    std::remove(archivePath.c_str());
+    std::remove(cachePath.c_str());
+}
+
+BENCHMARK(Storage_MBTilesArchive_getTile);
+BENCHMARK(Storage_OfflineDatabase_getTile);
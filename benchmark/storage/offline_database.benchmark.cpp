@@ -0,0 +1,141 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+const std::string cachePath = "benchmark/fixtures/offline_database.benchmark.db";
+const std::string tilePath = "test/fixtures/api/assets/streets/10-163-395.vector.pbf";
+const std::string urlTemplate = "http://example.com/{z}-{x}-{y}.vector.pbf";
+constexpr int8_t zoom = 10;
+constexpr int32_t side = 16;
+
+// Large enough that the replay never evicts, so that every lookup is a hit.
+constexpr uint64_t maximumCacheSize = 1024 * 1024 * 1024;
+
+Resource tile(int32_t x, int32_t y, int8_t z) {
+    return Resource::tile(urlTemplate, 1, x, y, z, Tileset::Scheme::XYZ);
+}
+
+// Fills the cache with the side x side block of tiles that the lookups replay.
+void createCache(const Response& response) {
+    std::remove(cachePath.c_str());
+    OfflineDatabase cache(cachePath, maximumCacheSize);
+    for (int32_t i = 0; i < side * side; ++i) {
+        cache.put(tile(i % side, i / side, zoom), response);
+    }
+}
+
+// Replays cache hits for the visible tiles while another thread keeps storing responses for
+// tiles one zoom level down, as happens while panning over a partially cached area. The
+// counters report the latency of the hits in microseconds.
+template <class Get, class Put>
+void replay(benchmark::State& state, Get&& get, Put&& put, const Response& response) {
+    std::atomic<bool> writing { true };
+    std::thread writer([&] {
+        for (int32_t i = 0; writing; ++i) {
+            put(tile(i % (2 * side), (i / (2 * side)) % (2 * side), zoom + 1), response);
+        }
+    });
+
+    std::vector<Resource> resources;
+    for (int32_t i = 0; i < side * side; ++i) {
+        resources.push_back(tile(i % side, i / side, zoom));
+    }
+
+    std::vector<double> latencies;
+    size_t i = 0;
+
+    while (state.KeepRunning()) {
+        const auto start = std::chrono::steady_clock::now();
+        auto result = get(resources[i++ % resources.size()]);
+        const auto end = std::chrono::steady_clock::now();
+        benchmark::DoNotOptimize(result);
+        latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    writing = false;
+    writer.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    state.counters["p50"] = latencies[latencies.size() / 2];
+    state.counters["p99"] = latencies[latencies.size() * 99 / 100];
+}
+
+} // namespace
+
+// Lookups and writes take turns on one connection, as they did when a single thread owned the cache.
+static void Storage_OfflineDatabase_mixedReplay_sharedConnection(benchmark::State& state) {
+    Response response;
+    response.data = std::make_shared<std::string>(util::read_file(tilePath));
+    createCache(response);
+
+    {
+        OfflineDatabase cache(cachePath, maximumCacheSize);
+        std::mutex mutex;
+
+        replay(state, [&] (const Resource& resource) {
+            std::lock_guard<std::mutex> lock(mutex);
+            return cache.get(resource);
+        }, [&] (const Resource& resource, const Response& response_) {
+            std::lock_guard<std::mutex> lock(mutex);
+            cache.put(resource, response_);
+        }, response);
+    }
+
+    std::remove(cachePath.c_str());
+}
+
+// Lookups go through a read-only connection, while a separate connection on the writing thread
+// stores responses in WAL mode. Each hit is handed to that thread to record, as DefaultFileSource
+// does, so that both variants do the same work but a lookup never waits for a write.
+static void Storage_OfflineDatabase_mixedReplay_readConnection(benchmark::State& state) {
+    Response response;
+    response.data = std::make_shared<std::string>(util::read_file(tilePath));
+    createCache(response);
+
+    {
+        OfflineDatabase writer(cachePath, maximumCacheSize);
+        writer.enableConcurrentReads();
+        OfflineDatabase reader(cachePath, OfflineDatabase::ReadOnly);
+        std::mutex mutex;
+        std::vector<Resource> accessed;
+
+        replay(state, [&] (const Resource& resource) {
+            auto result = reader.get(resource);
+            std::lock_guard<std::mutex> lock(mutex);
+            accessed.push_back(resource);
+            return result;
+        }, [&] (const Resource& resource, const Response& response_) {
+            std::vector<Resource> hits;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                hits.swap(accessed);
+            }
+            for (const auto& hit : hits) {
+                writer.markAccessed(hit);
+            }
+            writer.put(resource, response_);
+        }, response);
+    }
+
+    std::remove(cachePath.c_str());
+    std::remove((cachePath + "-wal").c_str());
+    std::remove((cachePath + "-shm").c_str());
+}
+
+BENCHMARK(Storage_OfflineDatabase_mixedReplay_sharedConnection);
+BENCHMARK(Storage_OfflineDatabase_mixedReplay_readConnection);
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+// Point labels of street-label size, scattered densely over the tile and its buffer.
+std::vector<CollisionFeature> makeLabels(std::size_t count) {
+    std::vector<CollisionFeature> labels;
+    labels.reserve(count);
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-util::EXTENT / 16, util::EXTENT + util::EXTENT / 16);
+    std::uniform_real_distribution<float> width(100, 600);
+    for (std::size_t i = 0; i < count; ++i) {
+        const float halfWidth = width(random);
+        labels.emplace_back(GeometryCoordinates(), Anchor(position(random), position(random), 0, 0),
+                            -80, 80, -halfWidth, halfWidth, 1, 20, style::SymbolPlacementType::Point,
+                            IndexedSubfeature { i, 0, 0, i },
+                            CollisionFeature::AlignmentType::Curved);
+    }
+    return labels;
+}
+
+void place(benchmark::State& state, const PlacementConfig& config) {
+    const std::vector<CollisionFeature> labels = makeLabels(state.range(0));
+    const std::size_t allocations = heapAllocations();
+    std::size_t placed = 0;
+
+    while (state.KeepRunning()) {
+        CollisionTile tile(config);
+        std::vector<CollisionFeature> features = labels;
+        for (auto& feature : features) {
+            const float scale = tile.placeFeature(feature, false, true);
+            tile.insertFeature(feature, scale, false);
+            placed += scale < tile.maxScale;
+        }
+        benchmark::DoNotOptimize(tile);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["placed"] = double(placed) / state.iterations();
+    state.counters["allocations"] = double(heapAllocations() - allocations) / state.iterations();
+}
+
+} // namespace
+
+static void Placement_CollisionTile(benchmark::State& state) {
+    place(state, PlacementConfig());
+}
+
+static void Placement_CollisionTileRotated(benchmark::State& state) {
+    place(state, PlacementConfig(0.7f, 0.6f, 900, 1100));
+}
+
+BENCHMARK(Placement_CollisionTile)->Arg(1000)->Arg(10000);
+BENCHMARK(Placement_CollisionTileRotated)->Arg(1000)->Arg(10000);
@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/util/grid_index.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+using Grid = GridIndex<IndexedSubfeature>;
+
+// Fills a grid shaped like a FeatureIndex with a mix of small and tile-spanning boxes.
+void fillGrid(Grid& grid, std::size_t count) {
+    std::mt19937 random(42);
+    for (std::size_t i = 0; i < count; ++i) {
+        const int16_t x = random() % util::EXTENT;
+        const int16_t y = random() % util::EXTENT;
+        const int16_t size = i % 16 == 0 ? random() % util::EXTENT : random() % 256;
+        grid.insert(IndexedSubfeature { i, 0, 0, i },
+                    { { x, y }, { int16_t(std::min<int>(x + size, util::EXTENT)), int16_t(std::min<int>(y + size, util::EXTENT)) } });
+    }
+}
+
+const Grid::BBox point { { 2000, 2000 }, { 2010, 2010 } };
+const Grid::BBox region { { 1000, 1000 }, { 3000, 3000 } };
+
+} // namespace
+
+static void Util_GridIndexInsert(benchmark::State& state) {
+    const std::size_t allocations = heapAllocations();
+
+    while (state.KeepRunning()) {
+        Grid grid(util::EXTENT, 16, 0);
+        fillGrid(grid, 20000);
+        benchmark::DoNotOptimize(grid);
+    }
+
+    state.counters["allocations"] = double(heapAllocations() - allocations) / state.iterations();
+    state.counters["elementBytes"] = 20000 * sizeof(std::pair<IndexedSubfeature, Grid::BBox>);
+}
+
+static void Util_GridIndexQueryPoint(benchmark::State& state) {
+    Grid grid(util::EXTENT, 16, 0);
+    fillGrid(grid, 20000);
+    grid.query(point);
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(grid.query(point));
+    }
+}
+
+static void Util_GridIndexVisitPoint(benchmark::State& state) {
+    Grid grid(util::EXTENT, 16, 0);
+    fillGrid(grid, 20000);
+    grid.query(point);
+
+    while (state.KeepRunning()) {
+        std::size_t count = 0;
+        grid.query(point, [&] (const IndexedSubfeature&, const Grid::BBox&) { count++; });
+        benchmark::DoNotOptimize(count);
+    }
+}
+
+static void Util_GridIndexVisitRegion(benchmark::State& state) {
+    Grid grid(util::EXTENT, 16, 0);
+    fillGrid(grid, 20000);
+    grid.query(point);
+
+    while (state.KeepRunning()) {
+        std::size_t count = 0;
+        grid.query(region, [&] (const IndexedSubfeature&, const Grid::BBox&) { count++; });
+        benchmark::DoNotOptimize(count);
+    }
+}
+
+BENCHMARK(Util_GridIndexInsert);
+BENCHMARK(Util_GridIndexQueryPoint);
+BENCHMARK(Util_GridIndexVisitPoint);
+BENCHMARK(Util_GridIndexVisitRegion);
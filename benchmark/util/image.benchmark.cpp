@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+static void decode(benchmark::State& state, const std::string& path) {
+    const std::string data = util::read_file(path);
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(decodeImage(data));
+    }
+}
+
+static void Util_decodePNG(benchmark::State& state) {
+    decode(state, "test/fixtures/image/tile.png");
+}
+
+static void Util_decodePNGAlpha(benchmark::State& state) {
+    decode(state, "test/fixtures/image/no_profile_alpha.png");
+}
+
+static void Util_decodeJPEG(benchmark::State& state) {
+    decode(state, "test/fixtures/image/tile.jpeg");
+}
+
+BENCHMARK(Util_decodePNG);
+BENCHMARK(Util_decodePNGAlpha);
+BENCHMARK(Util_decodeJPEG);
+
+#if !defined(__ANDROID__) && !defined(__APPLE__) && !defined(QT_IMAGE_DECODERS)
+static void Util_decodeWebP(benchmark::State& state) {
+    decode(state, "test/fixtures/image/tile.webp");
+}
+
+BENCHMARK(Util_decodeWebP);
+#endif // !defined(__ANDROID__) && !defined(__APPLE__) && !defined(QT_IMAGE_DECODERS)
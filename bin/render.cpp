@@ -3,9 +3,15 @@
 #include <mbgl/util/run_loop.hpp>
 
 #include <mbgl/gl/headless_frontend.hpp>
+#include <mbgl/util/png_stream_writer.hpp>
 #include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/cache_only_file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
 #include <mbgl/style/style.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/projection.hpp>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunknown-pragmas"
@@ -16,9 +22,79 @@
 
 namespace po = boost::program_options;
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// A single image in a batch file. Each non-empty line that doesn't start with '#' reads
+//   lon lat zoom bearing pitch width height output
+struct Job {
+    double lon = 0, lat = 0;
+    double zoom = 0;
+    double bearing = 0;
+    double pitch = 0;
+    uint32_t width = 512;
+    uint32_t height = 512;
+    std::string output;
+
+    uint64_t order = 0;
+    std::chrono::duration<double, std::milli> latency {};
+    bool failed = false;
+};
+
+uint64_t interleave(uint32_t x, uint32_t y) {
+    uint64_t result = 0;
+    for (uint32_t bit = 0; bit < 32; ++bit) {
+        result |= uint64_t((x >> bit) & 1) << (2 * bit);
+        result |= uint64_t((y >> bit) & 1) << (2 * bit + 1);
+    }
+    return result;
+}
+
+std::vector<Job> readJobs(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.good()) {
+        throw std::runtime_error("Cannot read batch file " + path);
+    }
+
+    std::vector<Job> jobs;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        Job job;
+        if (!(fields >> job.lon >> job.lat >> job.zoom >> job.bearing >> job.pitch >> job.width >> job.height >> job.output)) {
+            throw std::runtime_error("Malformed batch line: " + line);
+        }
+
+        // Order jobs along a Z-order curve within each integer zoom level, so that
+        // consecutive jobs on the same frontend mostly reuse tiles that are already loaded.
+        const mbgl::Point<double> world = mbgl::Projection::project({ job.lat, job.lon }, std::pow(2.0, 16));
+        const uint32_t x = std::min<double>(std::max<double>(world.x / mbgl::util::tileSize, 0), 0xFFFF);
+        const uint32_t y = std::min<double>(std::max<double>(world.y / mbgl::util::tileSize, 0), 0xFFFF);
+        job.order = (uint64_t(std::max(0.0, std::floor(job.zoom))) << 32) | interleave(x, y);
+
+        jobs.push_back(std::move(job));
+    }
+
+    std::stable_sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) { return a.order < b.order; });
+    return jobs;
+}
+
+} // namespace
 
 int main(int argc, char *argv[]) {
     std::string style_path;
@@ -35,10 +111,20 @@ int main(int argc, char *argv[]) {
     std::string asset_root = ".";
     std::string token;
     bool debug = false;
+    bool offline = false;
+    std::string batch_file;
+    uint32_t frontends = 1;
+    uint32_t tile_size = 0;
+    uint32_t tile_overlap = 128;
 
     po::options_description desc("Allowed options");
     desc.add_options()
         ("style,s", po::value(&style_path)->required()->value_name("json"), "Map stylesheet")
+        ("batch", po::value(&batch_file)->value_name("file"), "Render every job listed in a batch file instead of a single image")
+        ("frontends", po::value(&frontends)->value_name("number")->default_value(frontends), "Number of concurrent frontends used in batch mode")
+        ("tile-size", po::value(&tile_size)->value_name("pixels")->default_value(tile_size), "Render images larger than this in tiles of this size")
+        ("tile-overlap", po::value(&tile_overlap)->value_name("pixels")->default_value(tile_overlap), "Extra margin rendered around each tile so that labels crossing tile edges are complete")
+        ("offline", po::bool_switch(&offline)->default_value(offline), "Only use resources from the cache, and fail if any is missing")
         ("lon,x", po::value(&lon)->value_name("degrees")->default_value(lon), "Longitude")
         ("lat,y", po::value(&lat)->value_name("degrees")->default_value(lat), "Latitude in degrees")
         ("zoom,z", po::value(&zoom)->value_name("number")->default_value(zoom), "Zoom level")
@@ -81,14 +167,135 @@ int main(int argc, char *argv[]) {
         fileSource.setAccessToken(std::string(token));
     }
 
-    ThreadPool threadPool(4);
-    HeadlessFrontend frontend({ width, height }, pixelRatio, fileSource, threadPool);
-    Map map(frontend, MapObserver::nullObserver(), frontend.getSize(), pixelRatio, fileSource, threadPool, MapMode::Still);
+    // Offline renders fail on the first resource that isn't cached instead of waiting for it.
+    CacheOnlyFileSource cacheOnlyFileSource(fileSource);
+    FileSource& source = offline ? static_cast<FileSource&>(cacheOnlyFileSource) : fileSource;
 
     if (style_path.find("://") == std::string::npos) {
         style_path = std::string("file://") + style_path;
     }
 
+    ThreadPool threadPool(4);
+
+    if (!batch_file.empty()) {
+        frontends = std::max(frontends, 1u);
+
+        std::vector<Job> jobs;
+        try {
+            jobs = readJobs(batch_file);
+        } catch(std::exception& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            exit(1);
+        }
+
+        // The style is fetched once and handed to every frontend. A parsed style belongs to
+        // its map and that map's thread, so each frontend still parses it.
+        std::string styleJSON;
+        std::string styleError;
+        {
+            auto styleRequest = source.request(Resource::style(style_path), [&](Response res) {
+                if (res.error) {
+                    styleError = res.error->message;
+                } else if (!res.data) {
+                    styleError = "Empty style " + style_path;
+                } else {
+                    styleJSON = *res.data;
+                }
+                loop.stop();
+            });
+            loop.run();
+        }
+        if (!styleError.empty()) {
+            std::cout << "Error: " << styleError << std::endl;
+            exit(1);
+        }
+
+        // Each frontend lives on its own thread with its own Map, and keeps its style
+        // and loaded tiles across jobs. All frontends share the file source, and with it
+        // the cache, as well as the worker pool. Tiles that one frontend has loaded are
+        // not shared with the others, though. Jobs are handed out in small contiguous
+        // chunks of the spatially sorted queue to keep neighboring jobs on the same frontend.
+        const std::size_t chunkSize = std::max<std::size_t>(1, std::min<std::size_t>(16, jobs.size() / (frontends * 4)));
+        std::atomic<std::size_t> nextChunk { 0 };
+        std::mutex outputMutex;
+
+        auto renderJobs = [&] {
+            util::RunLoop threadLoop;
+            HeadlessFrontend threadFrontend({ width, height }, pixelRatio, source, threadPool);
+            Map threadMap(threadFrontend, MapObserver::nullObserver(), threadFrontend.getSize(), pixelRatio, source, threadPool, MapMode::Still);
+            threadMap.getStyle().loadJSON(styleJSON);
+
+            for (std::size_t chunk = nextChunk++; chunk * chunkSize < jobs.size(); chunk = nextChunk++) {
+                const std::size_t end = std::min(jobs.size(), (chunk + 1) * chunkSize);
+                for (std::size_t i = chunk * chunkSize; i < end; ++i) {
+                    Job& job = jobs[i];
+                    const auto start = std::chrono::steady_clock::now();
+                    try {
+                        threadFrontend.setSize({ job.width, job.height });
+                        threadMap.setSize({ job.width, job.height });
+                        threadMap.setLatLngZoom({ job.lat, job.lon }, job.zoom);
+                        threadMap.setBearing(job.bearing);
+                        threadMap.setPitch(job.pitch);
+
+                        std::ofstream out(job.output, std::ios::binary);
+                        out << encodePNG(threadFrontend.render(threadMap));
+                    } catch(std::exception& e) {
+                        job.failed = true;
+                        std::lock_guard<std::mutex> lock(outputMutex);
+                        std::cout << job.output << ": error: " << e.what() << std::endl;
+                    }
+                    job.latency = std::chrono::steady_clock::now() - start;
+
+                    if (!job.failed) {
+                        std::lock_guard<std::mutex> lock(outputMutex);
+                        std::cout << job.output << ": " << job.latency.count() << " ms" << std::endl;
+                    }
+                }
+            }
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0; i < frontends; ++i) {
+            threads.emplace_back(renderJobs);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::vector<double> latencies;
+        std::size_t failures = 0;
+        for (const auto& job : jobs) {
+            latencies.push_back(job.latency.count());
+            failures += job.failed;
+        }
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&] (double p) {
+            return latencies.empty() ? 0.0 : latencies[std::min(latencies.size() - 1, std::size_t(p * latencies.size()))];
+        };
+
+        std::cout << jobs.size() << " jobs (" << failures << " failed) in " << elapsed.count() << " s, "
+                  << (elapsed.count() > 0 ? jobs.size() / elapsed.count() : 0.0) << " jobs/s, "
+                  << "p50 " << percentile(0.5) << " ms, p99 " << percentile(0.99) << " ms" << std::endl;
+
+        return failures ? 1 : 0;
+    }
+
+    // Images that exceed the tile size are rendered as a grid of viewports, each
+    // padded by an overlap margin, and streamed to the PNG encoder one strip at a time.
+    const bool tiled = tile_size && (width > tile_size || height > tile_size);
+    if (tiled && (bearing != 0 || pitch != 0 || std::round(pixelRatio) != pixelRatio)) {
+        std::cout << "Error: tiled rendering requires a bearing and pitch of 0 and an integer ratio" << std::endl;
+        exit(1);
+    }
+
+    const uint32_t viewport = tile_size + 2 * tile_overlap;
+    const Size frontendSize = tiled ? Size { viewport, viewport } : Size { width, height };
+
+    HeadlessFrontend frontend(frontendSize, pixelRatio, source, threadPool);
+    Map map(frontend, MapObserver::nullObserver(), frontend.getSize(), pixelRatio, source, threadPool, MapMode::Still);
+
     map.getStyle().loadURL(style_path);
     map.setLatLngZoom({ lat, lon }, zoom);
     map.setBearing(bearing);
@@ -100,7 +307,44 @@ int main(int argc, char *argv[]) {
 
     try {
         std::ofstream out(output, std::ios::binary);
-        out << encodePNG(frontend.render(map));
+        if (!tiled) {
+            out << encodePNG(frontend.render(map));
+        } else {
+            const double scale = std::pow(2.0, zoom);
+            const Point<double> center = Projection::project({ lat, lon }, scale);
+            const uint32_t ratio = std::round(pixelRatio);
+            const uint32_t imageWidth = width * ratio;
+
+            PNGStreamWriter writer(out, { imageWidth, height * ratio });
+
+            for (uint32_t top = 0; top < height; top += tile_size) {
+                const uint32_t stripHeight = std::min(tile_size, height - top);
+                PremultipliedImage strip({ imageWidth, stripHeight * ratio });
+
+                for (uint32_t left = 0; left < width; left += tile_size) {
+                    const uint32_t tileWidth = std::min(tile_size, width - left);
+
+                    // Center the padded viewport on the middle of this tile's full-size cell.
+                    const Point<double> tileCenter {
+                        center.x + left + tile_size / 2.0 - width / 2.0,
+                        center.y + top + tile_size / 2.0 - height / 2.0
+                    };
+                    map.setLatLngZoom(Projection::unproject(tileCenter, scale), zoom);
+
+                    PremultipliedImage image = frontend.render(map);
+                    PremultipliedImage::copy(image, strip,
+                                             { tile_overlap * ratio, tile_overlap * ratio },
+                                             { left * ratio, 0 },
+                                             { tileWidth * ratio, stripHeight * ratio });
+                }
+
+                for (uint32_t y = 0; y < strip.size.height; ++y) {
+                    writer.writeRow(strip.data.get() + y * strip.stride());
+                }
+            }
+
+            writer.finish();
+        }
         out.close();
     } catch(std::exception& e) {
         std::cout << "Error: " << e.what() << std::endl;
@@ -7,17 +7,25 @@ set(MBGL_BENCHMARK_FILES
 
     # function
     benchmark/function/camera_function.benchmark.cpp
+    benchmark/function/compiled_expression.benchmark.cpp
     benchmark/function/composite_function.benchmark.cpp
     benchmark/function/source_function.benchmark.cpp
 
+    # geometry
+    benchmark/geometry/polygon_tessellator.benchmark.cpp
+
     # include/mbgl
     benchmark/include/mbgl/benchmark.hpp
 
     # parse
     benchmark/parse/filter.benchmark.cpp
     benchmark/parse/tile_mask.benchmark.cpp
+    benchmark/parse/tile_snapshot.benchmark.cpp
     benchmark/parse/vector_tile.benchmark.cpp
 
+    # renderer
+    benchmark/renderer/style_diff.benchmark.cpp
+
     # src
     benchmark/src/main.cpp
 
@@ -25,6 +33,15 @@ set(MBGL_BENCHMARK_FILES
     benchmark/src/mbgl/benchmark/benchmark.cpp
     benchmark/src/mbgl/benchmark/stub_geometry_tile_feature.hpp
 
+    # storage
+    benchmark/storage/mbtiles.benchmark.cpp
+    benchmark/storage/offline_database.benchmark.cpp
+
+    # text
+    benchmark/text/collision_tile.benchmark.cpp
+
     # util
     benchmark/util/dtoa.benchmark.cpp
+    benchmark/util/grid_index.benchmark.cpp
+    benchmark/util/image.benchmark.cpp
 )
@@ -48,6 +48,8 @@ set(MBGL_CORE_FILES
     src/mbgl/geometry/feature_index.hpp
     src/mbgl/geometry/line_atlas.cpp
     src/mbgl/geometry/line_atlas.hpp
+    src/mbgl/geometry/polygon_tessellator.cpp
+    src/mbgl/geometry/polygon_tessellator.hpp
 
     # gl
     src/mbgl/gl/attribute.cpp
@@ -156,6 +158,7 @@ set(MBGL_CORE_FILES
 
     # renderer
     include/mbgl/renderer/backend_scope.hpp
+    include/mbgl/renderer/frame_statistics.hpp
     include/mbgl/renderer/mode.hpp
     include/mbgl/renderer/query.hpp
     include/mbgl/renderer/renderer.hpp
@@ -168,6 +171,8 @@ set(MBGL_CORE_FILES
     src/mbgl/renderer/cross_faded_property_evaluator.cpp
     src/mbgl/renderer/cross_faded_property_evaluator.hpp
     src/mbgl/renderer/data_driven_property_evaluator.hpp
+    src/mbgl/renderer/feature_states.cpp
+    src/mbgl/renderer/feature_states.hpp
     src/mbgl/renderer/frame_history.cpp
     src/mbgl/renderer/frame_history.hpp
     src/mbgl/renderer/group_by_layout.cpp
@@ -301,6 +306,7 @@ set(MBGL_CORE_FILES
     src/mbgl/sprite/sprite_parser.hpp
 
     # storage
+    include/mbgl/storage/cache_only_file_source.hpp
     include/mbgl/storage/default_file_source.hpp
     include/mbgl/storage/file_source.hpp
     include/mbgl/storage/network_status.hpp
@@ -310,8 +316,10 @@ set(MBGL_CORE_FILES
     include/mbgl/storage/resource_transform.hpp
     include/mbgl/storage/response.hpp
     src/mbgl/storage/asset_file_source.hpp
+    src/mbgl/storage/cache_only_file_source.cpp
     src/mbgl/storage/http_file_source.hpp
     src/mbgl/storage/local_file_source.hpp
+    src/mbgl/storage/mbtiles_file_source.hpp
     src/mbgl/storage/network_status.cpp
     src/mbgl/storage/resource.cpp
     src/mbgl/storage/resource_transform.cpp
@@ -404,6 +412,7 @@ set(MBGL_CORE_FILES
     include/mbgl/style/expression/check_subtype.hpp
     include/mbgl/style/expression/coalesce.hpp
     include/mbgl/style/expression/coercion.hpp
+    include/mbgl/style/expression/compiled_expression.hpp
     include/mbgl/style/expression/compound_expression.hpp
     include/mbgl/style/expression/expression.hpp
     include/mbgl/style/expression/find_zoom_curve.hpp
@@ -426,6 +435,7 @@ set(MBGL_CORE_FILES
     src/mbgl/style/expression/check_subtype.cpp
     src/mbgl/style/expression/coalesce.cpp
     src/mbgl/style/expression/coercion.cpp
+    src/mbgl/style/expression/compiled_expression.cpp
     src/mbgl/style/expression/compound_expression.cpp
     src/mbgl/style/expression/find_zoom_curve.cpp
     src/mbgl/style/expression/get_covering_stops.cpp
@@ -529,6 +539,8 @@ set(MBGL_CORE_FILES
     src/mbgl/text/check_max_angle.hpp
     src/mbgl/text/collision_feature.cpp
     src/mbgl/text/collision_feature.hpp
+    src/mbgl/text/collision_grid.cpp
+    src/mbgl/text/collision_grid.hpp
     src/mbgl/text/collision_tile.cpp
     src/mbgl/text/collision_tile.hpp
     src/mbgl/text/get_anchors.cpp
@@ -574,6 +586,8 @@ set(MBGL_CORE_FILES
     src/mbgl/tile/tile_loader.hpp
     src/mbgl/tile/tile_loader_impl.hpp
     src/mbgl/tile/tile_observer.hpp
+    src/mbgl/tile/tile_snapshot.cpp
+    src/mbgl/tile/tile_snapshot.hpp
     src/mbgl/tile/vector_tile.cpp
     src/mbgl/tile/vector_tile.hpp
     src/mbgl/tile/vector_tile_data.cpp
@@ -650,7 +664,6 @@ set(MBGL_CORE_FILES
     src/mbgl/util/io.cpp
     src/mbgl/util/io.hpp
     src/mbgl/util/logging.cpp
-    src/mbgl/util/longest_common_subsequence.hpp
     src/mbgl/util/mapbox.cpp
     src/mbgl/util/mapbox.hpp
     src/mbgl/util/mat2.cpp
@@ -669,6 +682,8 @@ set(MBGL_CORE_FILES
     src/mbgl/util/stopwatch.cpp
     src/mbgl/util/stopwatch.hpp
     src/mbgl/util/string.cpp
+    src/mbgl/util/string_indexer.cpp
+    src/mbgl/util/string_indexer.hpp
     src/mbgl/util/thread_local.hpp
     src/mbgl/util/throttler.cpp
     src/mbgl/util/throttler.hpp
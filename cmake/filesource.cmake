@@ -11,6 +11,8 @@ add_library(mbgl-filesource STATIC
     platform/default/asset_file_source.cpp
     src/mbgl/storage/local_file_source.hpp
     platform/default/local_file_source.cpp
+    src/mbgl/storage/mbtiles_file_source.hpp
+    platform/default/mbtiles_file_source.cpp
 
     # Offline
     include/mbgl/storage/offline.hpp
@@ -20,6 +22,10 @@ add_library(mbgl-filesource STATIC
     platform/default/mbgl/storage/offline_download.hpp
     platform/default/mbgl/storage/offline_download.cpp
 
+    # Tile archives
+    platform/default/mbgl/storage/mbtiles_archive.hpp
+    platform/default/mbgl/storage/mbtiles_archive.cpp
+
     # Database
     platform/default/sqlite3.hpp
 )
@@ -20,6 +20,9 @@ set(MBGL_TEST_FILES
     test/api/recycle_map.cpp
     test/api/zoom_history.cpp
 
+    # geometry
+    test/geometry/polygon_tessellator.test.cpp
+
     # gl
     test/gl/bucket.test.cpp
     test/gl/object.test.cpp
@@ -44,8 +47,10 @@ set(MBGL_TEST_FILES
 
     # renderer
     test/renderer/backend_scope.test.cpp
+    test/renderer/feature_states.test.cpp
     test/renderer/group_by_layout.test.cpp
     test/renderer/image_manager.test.cpp
+    test/renderer/style_diff.test.cpp
 
     # sprite
     test/sprite/sprite_loader.test.cpp
@@ -70,10 +75,12 @@ set(MBGL_TEST_FILES
 
     # storage
     test/storage/asset_file_source.test.cpp
+    test/storage/cache_only_file_source.test.cpp
     test/storage/default_file_source.test.cpp
     test/storage/headers.test.cpp
     test/storage/http_file_source.test.cpp
     test/storage/local_file_source.test.cpp
+    test/storage/mbtiles_file_source.test.cpp
     test/storage/offline.test.cpp
     test/storage/offline_database.test.cpp
     test/storage/offline_download.test.cpp
@@ -89,6 +96,7 @@ set(MBGL_TEST_FILES
     test/style/conversion/stringify.test.cpp
 
     # style/expression
+    test/style/expression/compiled_expression.test.cpp
     test/style/expression/expression.test.cpp
     test/style/expression/util.test.cpp
 
@@ -111,6 +119,7 @@ set(MBGL_TEST_FILES
     test/style/style_parser.test.cpp
 
     # text
+    test/text/collision_tile.test.cpp
     test/text/glyph_loader.test.cpp
     test/text/glyph_pbf.test.cpp
     test/text/quads.test.cpp
@@ -122,12 +131,15 @@ set(MBGL_TEST_FILES
     test/tile/raster_tile.test.cpp
     test/tile/tile_coordinate.test.cpp
     test/tile/tile_id.test.cpp
+    test/tile/tile_snapshot.test.cpp
     test/tile/vector_tile.test.cpp
 
     # util
     test/util/async_task.test.cpp
+    test/util/compression.test.cpp
     test/util/dtoa.test.cpp
     test/util/geo.test.cpp
+    test/util/grid_index.test.cpp
     test/util/http_timeout.test.cpp
     test/util/image.test.cpp
     test/util/mapbox.test.cpp
@@ -138,6 +150,7 @@ set(MBGL_TEST_FILES
     test/util/position.test.cpp
     test/util/projection.test.cpp
     test/util/run_loop.test.cpp
+    test/util/string_indexer.test.cpp
     test/util/text_conversions.test.cpp
     test/util/thread.test.cpp
     test/util/thread_local.test.cpp
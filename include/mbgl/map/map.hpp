@@ -152,6 +152,12 @@ public:
     void updateAnnotation(AnnotationID, const Annotation&);
     void removeAnnotation(AnnotationID);
 
+    // Adding, updating or removing many annotations at once is much faster than doing
+    // so one by one, and regenerates the affected tiles only once.
+    AnnotationIDs addAnnotations(const std::vector<Annotation>&);
+    void updateAnnotations(const std::vector<std::pair<AnnotationID, Annotation>>&);
+    void removeAnnotations(const AnnotationIDs&);
+
     // Tile prefetching
     //
     // When loading a map, if `PrefetchZoomDelta` is set to any number greater than 0, the map will
@@ -161,6 +167,13 @@ public:
     void setPrefetchZoomDelta(uint8_t delta);
     uint8_t getPrefetchZoomDelta() const;
 
+    // Raster tile textures
+    //
+    // Uploading opaque raster tiles in a reduced format saves GPU memory at the cost of color
+    // precision. Changing the format reloads raster sources. The default is RGBA.
+    void setRasterTextureFormat(RasterTextureFormat);
+    RasterTextureFormat getRasterTextureFormat() const;
+
     // Debug
     void setDebug(MapDebugOptions);
     void cycleDebugOptions();
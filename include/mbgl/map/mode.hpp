@@ -29,6 +29,14 @@ enum class ViewportMode : EnumType {
     FlippedY,
 };
 
+// Texture format for raster tiles. The reduced formats only apply to fully opaque tiles;
+// tiles with any transparency are always uploaded as RGBA.
+enum class RasterTextureFormat : EnumType {
+    RGBA,   // 4 bytes per pixel
+    RGB,    // 3 bytes per pixel. Lossless, but many drivers store it with 4 bytes anyway.
+    RGB565, // 2 bytes per pixel, with 5 bits for red and blue and 6 bits for green
+};
+
 enum class MapDebugOptions : EnumType {
     NoDebug     = 0,
     TileBorders = 1 << 1,
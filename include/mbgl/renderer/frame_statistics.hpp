@@ -0,0 +1,22 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+#include <cstddef>
+
+namespace mbgl {
+
+/**
+ * Statistics of a rendered frame. They describe how the frame was submitted
+ * to OpenGL, not how long the GPU took to draw it.
+ */
+class FrameStatistics {
+public:
+    /// The number of draw calls issued for the frame.
+    std::size_t drawCalls = 0;
+
+    /// The CPU time spent issuing them, from the first render pass through the end of the frame.
+    Duration submissionTime = Duration::zero();
+};
+
+} // namespace mbgl
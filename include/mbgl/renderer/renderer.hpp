@@ -1,8 +1,10 @@
 #pragma once
 
+#include <mbgl/renderer/frame_statistics.hpp>
 #include <mbgl/renderer/query.hpp>
 #include <mbgl/renderer/mode.hpp>
 #include <mbgl/annotation/annotation.hpp>
+#include <mbgl/util/feature.hpp>
 #include <mbgl/util/geo.hpp>
 #include <mbgl/util/geo.hpp>
 
@@ -43,8 +45,17 @@ public:
     AnnotationIDs queryShapeAnnotations(const ScreenBox& box) const;
     AnnotationIDs getAnnotationIDs(const std::vector<Feature>&) const;
 
+    // Feature state. States are keyed by the ID of the source, the source layer (empty for
+    // GeoJSON sources) and the feature, and are read by ["feature-state", ...] expressions.
+    // setFeatureState merges the given properties into the feature's current state.
+    void setFeatureState(const std::string& sourceID, const std::string& sourceLayerID,
+                         const std::string& featureID, const FeatureState&);
+    FeatureState getFeatureState(const std::string& sourceID, const std::string& sourceLayerID,
+                                 const std::string& featureID) const;
+
     // Debug
     void dumpDebugLogs();
+    FrameStatistics getLastFrameStatistics() const;
 
     // Memory
     void onLowMemory();
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+
+namespace mbgl {
+
+// Serves every request from the cache of another file source, and never from the network.
+// Resources that aren't cached fail with an error instead of waiting for connectivity, so
+// that a still image that depends on them fails rather than never completing. Resources
+// that are cached but stale are used anyway.
+class CacheOnlyFileSource : public FileSource {
+public:
+    // The cache must support cache-only requests, and must outlive this file source.
+    explicit CacheOnlyFileSource(FileSource& cache);
+
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+
+    bool supportsCacheOnlyRequests() const override {
+        return true;
+    }
+
+    // Tile snapshots are kept in the same cache, so they are handed through.
+    bool supportsTileSnapshots() const override {
+        return cache.supportsTileSnapshots();
+    }
+
+    void getTileSnapshot(const Resource&, uint64_t layersHash, SnapshotCallback) override;
+    void putTileSnapshot(const Resource&, uint64_t layersHash, std::shared_ptr<const std::string>) override;
+
+private:
+    FileSource& cache;
+};
+
+} // namespace mbgl
@@ -38,6 +38,10 @@ public:
         return true;
     }
 
+    bool supportsTileSnapshots() const override {
+        return true;
+    }
+
     void setAPIBaseURL(const std::string&);
     std::string getAPIBaseURL();
 
@@ -48,6 +52,10 @@ public:
 
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
 
+    // Snapshots are looked up on the database thread, and the callback is called there.
+    void getTileSnapshot(const Resource&, uint64_t layersHash, SnapshotCallback) override;
+    void putTileSnapshot(const Resource&, uint64_t layersHash, std::shared_ptr<const std::string>) override;
+
     /*
      * Retrieve all regions in the offline database.
      *
@@ -123,6 +131,13 @@ public:
      */
     void setOfflineMapboxTileCountLimit(uint64_t) const;
 
+    /*
+     * Retrieve the number of requests that joined an identical request already in flight,
+     * instead of going to the cache or the network on their own. The callback will be
+     * executed on the database thread.
+     */
+    void getDuplicateRequestCount(std::function<void (uint64_t)>) const;
+
     /*
      * Pause file request activity.
      *
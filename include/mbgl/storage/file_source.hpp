@@ -6,8 +6,10 @@
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/async_request.hpp>
 
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 
 namespace mbgl {
 
@@ -31,6 +33,24 @@ public:
     virtual bool supportsCacheOnlyRequests() const {
         return false;
     }
+
+    // When a file source can keep snapshots of laid out tiles next to the tiles in its cache,
+    // it must return true. Snapshots are opaque to the file source; they are keyed by the tile
+    // resource and by a hash of the style layers that laid the tile out.
+    virtual bool supportsTileSnapshots() const {
+        return false;
+    }
+
+    using SnapshotCallback = std::function<void (std::shared_ptr<const std::string>)>;
+
+    // Looks up a tile snapshot. The callback receives nullptr if there is none, and may be
+    // called on any thread, including this one before the method returns.
+    virtual void getTileSnapshot(const Resource&, uint64_t, SnapshotCallback callback) {
+        callback(nullptr);
+    }
+
+    virtual void putTileSnapshot(const Resource&, uint64_t, std::shared_ptr<const std::string>) {
+    }
 };
 
 } // namespace mbgl
@@ -22,6 +22,10 @@ public:
 
     void setResourceTransform(optional<ActorRef<ResourceTransform>>&&);
 
+    // Returns the URL that a request for the resource goes to, with mapbox:// URLs resolved
+    // against the API base URL and the access token.
+    std::string resolveURL(const Resource&) const;
+
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
 
     // For testing only.
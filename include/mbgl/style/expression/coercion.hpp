@@ -8,6 +8,9 @@ namespace mbgl {
 namespace style {
 namespace expression {
 
+// Converts a number or a numeric string to a number, or fails.
+EvaluationResult toNumber(const Value&);
+
 /**
  * Special form for error-coalescing coercion expressions "to-number",
  * "to-color".  Since these coercions can fail at runtime, they accept multiple
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <mbgl/style/expression/expression.hpp>
+
+#include <memory>
+
+namespace mbgl {
+namespace style {
+namespace expression {
+
+/*
+    CompiledExpression is a flat form of an Expression tree, run by a small register
+    machine instead of a recursive walk over virtual evaluate() calls.
+
+    Compilation folds every subexpression that depends on neither the zoom level nor
+    the feature into a constant, resolves the keys of ["get", ...] and ["has", ...]
+    ahead of time, and turns step, interpolate, match and case expressions into jump
+    tables. Numbers and booleans live in unboxed registers; everything else lives in
+    Value registers.
+
+    Not every expression can be compiled; compile() returns nullptr for those, and
+    callers keep evaluating the tree. A compiled expression produces the same result
+    as the tree it was compiled from, including errors.
+*/
+class CompiledExpression {
+public:
+    ~CompiledExpression();
+
+    static std::unique_ptr<CompiledExpression> compile(const Expression&);
+
+    EvaluationResult evaluate(const EvaluationContext&) const;
+
+    class Impl;
+
+private:
+    CompiledExpression(std::unique_ptr<const Impl>);
+
+    const std::unique_ptr<const Impl> impl;
+};
+
+} // namespace expression
+} // namespace style
+} // namespace mbgl
@@ -6,6 +6,7 @@
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/variant.hpp>
 #include <mbgl/util/color.hpp>
+#include <mbgl/util/feature.hpp>
 #include <mbgl/style/expression/type.hpp>
 #include <mbgl/style/expression/value.hpp>
 #include <mbgl/style/expression/parsing_context.hpp>
@@ -36,6 +37,7 @@ public:
     optional<float> zoom;
     GeometryTileFeature const * feature;
     optional<double> heatmapDensity;
+    FeatureState const * featureState = nullptr;
 };
 
 template<typename T>
@@ -70,6 +70,8 @@ public:
     {}
 
     const std::unique_ptr<Expression>& getInput() const { return input; }
+    const std::map<double, std::unique_ptr<Expression>>& getStops() const { return stops; }
+    const Interpolator& getInterpolator() const { return interpolator; }
 
     void eachChild(const std::function<void(const Expression&)>& visit) const override {
         visit(*input);
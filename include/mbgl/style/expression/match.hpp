@@ -30,6 +30,10 @@ public:
     bool operator==(const Expression& e) const override;
 
     EvaluationResult evaluate(const EvaluationContext& params) const override;
+
+    const std::unique_ptr<Expression>& getInput() const { return input; }
+    const Branches& getBranches() const { return branches; }
+    const std::unique_ptr<Expression>& getOtherwise() const { return otherwise; }
     
 private:
     
@@ -29,6 +29,7 @@ public:
     void eachChild(const std::function<void(const Expression&)>& visit) const override;
 
     const std::unique_ptr<Expression>& getInput() const { return input; }
+    const std::map<double, std::unique_ptr<Expression>>& getStops() const { return stops; }
     Range<float> getCoveringStops(const double lower, const double upper) const;
 
     bool operator==(const Expression& e) const override;
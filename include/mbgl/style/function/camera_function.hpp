@@ -6,6 +6,7 @@
 #include <mbgl/style/expression/find_zoom_curve.hpp>
 #include <mbgl/style/expression/value.hpp>
 #include <mbgl/style/expression/is_constant.hpp>
+#include <mbgl/style/expression/compiled_expression.hpp>
 #include <mbgl/style/function/convert.hpp>
 #include <mbgl/style/function/exponential_stops.hpp>
 #include <mbgl/style/function/interval_stops.hpp>
@@ -29,7 +30,8 @@ public:
     
     CameraFunction(std::unique_ptr<expression::Expression> expression_)
          : expression(std::move(expression_)),
-           zoomCurve(expression::findZoomCurveChecked(expression.get()))
+           zoomCurve(expression::findZoomCurveChecked(expression.get())),
+           compiled(expression::CompiledExpression::compile(*expression))
     {
         assert(!expression::isZoomConstant(*expression));
         assert(expression::isFeatureConstant(*expression));
@@ -40,11 +42,12 @@ public:
           expression(stops.match([&] (const auto& s) {
             return expression::Convert::toExpression(s);
           })),
-          zoomCurve(expression::findZoomCurveChecked(expression.get()))
+          zoomCurve(expression::findZoomCurveChecked(expression.get())),
+          compiled(expression::CompiledExpression::compile(*expression))
     {}
 
     T evaluate(float zoom) const {
-        const expression::EvaluationResult result = expression->evaluate(expression::EvaluationContext(zoom, nullptr));
+        const expression::EvaluationResult result = evaluateExpression(expression::EvaluationContext(zoom, nullptr));
         if (result) {
            const optional<T> typed = expression::fromExpressionValue<T>(*result);
            return typed ? *typed : T();
@@ -78,8 +81,13 @@ public:
     Stops stops;
 
 private:
+    expression::EvaluationResult evaluateExpression(const expression::EvaluationContext& context) const {
+        return compiled ? compiled->evaluate(context) : expression->evaluate(context);
+    }
+
     std::shared_ptr<expression::Expression> expression;
     const variant<const expression::InterpolateBase*, const expression::Step*> zoomCurve;
+    std::shared_ptr<const expression::CompiledExpression> compiled;
 };
 
 } // namespace style
@@ -6,6 +6,7 @@
 #include <mbgl/style/expression/find_zoom_curve.hpp>
 #include <mbgl/style/expression/value.hpp>
 #include <mbgl/style/expression/is_constant.hpp>
+#include <mbgl/style/expression/compiled_expression.hpp>
 #include <mbgl/style/function/convert.hpp>
 #include <mbgl/style/function/composite_exponential_stops.hpp>
 #include <mbgl/style/function/composite_interval_stops.hpp>
@@ -16,6 +17,7 @@
 
 #include <string>
 #include <tuple>
+#include <vector>
 
 namespace mbgl {
 
@@ -52,7 +54,8 @@ public:
 
     CompositeFunction(std::unique_ptr<expression::Expression> expression_)
     :   expression(std::move(expression_)),
-        zoomCurve(expression::findZoomCurveChecked(expression.get()))
+        zoomCurve(expression::findZoomCurveChecked(expression.get())),
+        compiled(expression::CompiledExpression::compile(*expression))
     {
         assert(!expression::isZoomConstant(*expression));
         assert(!expression::isFeatureConstant(*expression));
@@ -65,12 +68,13 @@ public:
         expression(stops.match([&] (const auto& s) {
             return expression::Convert::toExpression(property, s);
         })),
-        zoomCurve(expression::findZoomCurveChecked(expression.get()))
+        zoomCurve(expression::findZoomCurveChecked(expression.get())),
+        compiled(expression::CompiledExpression::compile(*expression))
     {}
 
     // Return the range obtained by evaluating the function at each of the zoom levels in zoomRange
     template <class Feature>
-    Range<T> evaluate(const Range<float>& zoomRange, const Feature& feature, T finalDefaultValue) {
+    Range<T> evaluate(const Range<float>& zoomRange, const Feature& feature, T finalDefaultValue) const {
         return Range<T> {
             evaluate(zoomRange.min, feature, finalDefaultValue),
             evaluate(zoomRange.max, feature, finalDefaultValue)
@@ -79,13 +83,59 @@ public:
 
     template <class Feature>
     T evaluate(float zoom, const Feature& feature, T finalDefaultValue) const {
-        const expression::EvaluationResult result = expression->evaluate(expression::EvaluationContext({zoom}, &feature));
+        const expression::EvaluationResult result = evaluateExpression(expression::EvaluationContext({zoom}, &feature));
         if (result) {
             const optional<T> typed = expression::fromExpressionValue<T>(*result);
             return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
         }
         return defaultValue ? *defaultValue : finalDefaultValue;
     }
+
+    // Like the above, for a feature in the given feature state.
+    template <class Feature>
+    Range<T> evaluate(const Range<float>& zoomRange, const Feature& feature, const FeatureState& state, T finalDefaultValue) const {
+        return Range<T> {
+            evaluate(zoomRange.min, feature, state, finalDefaultValue),
+            evaluate(zoomRange.max, feature, state, finalDefaultValue)
+        };
+    }
+
+    template <class Feature>
+    T evaluate(float zoom, const Feature& feature, const FeatureState& state, T finalDefaultValue) const {
+        expression::EvaluationContext context({zoom}, &feature);
+        context.featureState = &state;
+        const expression::EvaluationResult result = evaluateExpression(context);
+        if (result) {
+            const optional<T> typed = expression::fromExpressionValue<T>(*result);
+            return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
+        }
+        return defaultValue ? *defaultValue : finalDefaultValue;
+    }
+
+    // Evaluates the function for each of the given features, in order, at both ends of
+    // zoomRange. Each zoom level is evaluated over all features before moving on to the next.
+    template <class Feature>
+    std::vector<Range<T>> evaluate(const Range<float>& zoomRange, const std::vector<const Feature*>& features, T finalDefaultValue) const {
+        std::vector<Range<T>> result(features.size(), Range<T> { finalDefaultValue, finalDefaultValue });
+        const T fallback = defaultValue ? *defaultValue : finalDefaultValue;
+        auto evaluateAll = [&] (const auto& evaluator, float zoom, T Range<T>::*end) {
+            expression::EvaluationContext context { zoom, nullptr };
+            for (std::size_t i = 0; i < features.size(); i++) {
+                context.feature = features[i];
+                const expression::EvaluationResult evaluated = evaluator.evaluate(context);
+                const optional<T> typed = evaluated ? expression::fromExpressionValue<T>(*evaluated) : optional<T>();
+                result[i].*end = typed ? *typed : fallback;
+            }
+        };
+        if (compiled) {
+            evaluateAll(*compiled, zoomRange.min, &Range<T>::min);
+            evaluateAll(*compiled, zoomRange.max, &Range<T>::max);
+        } else {
+            evaluateAll(*expression, zoomRange.min, &Range<T>::min);
+            evaluateAll(*expression, zoomRange.max, &Range<T>::max);
+        }
+        return result;
+    }
     
     float interpolationFactor(const Range<float>& inputLevels, const float inputValue) const {
         return zoomCurve.match(
@@ -102,6 +152,10 @@ public:
         );
     }
 
+    bool isFeatureStateConstant() const {
+        return expression::isFeatureStateConstant(*expression);
+    }
+
     friend bool operator==(const CompositeFunction& lhs,
                            const CompositeFunction& rhs) {
         return *lhs.expression == *rhs.expression;
@@ -113,8 +167,13 @@ public:
     bool useIntegerZoom = false;
     
 private:
+    expression::EvaluationResult evaluateExpression(const expression::EvaluationContext& context) const {
+        return compiled ? compiled->evaluate(context) : expression->evaluate(context);
+    }
+
     std::shared_ptr<expression::Expression> expression;
     const variant<const expression::InterpolateBase*, const expression::Step*> zoomCurve;
+    std::shared_ptr<const expression::CompiledExpression> compiled;
 };
 
 } // namespace style
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/style/expression/is_constant.hpp>
+#include <mbgl/style/expression/compiled_expression.hpp>
 #include <mbgl/style/function/convert.hpp>
 #include <mbgl/style/function/exponential_stops.hpp>
 #include <mbgl/style/function/interval_stops.hpp>
@@ -10,6 +11,7 @@
 #include <mbgl/util/variant.hpp>
 
 #include <string>
+#include <vector>
 
 namespace mbgl {
 namespace style {
@@ -30,7 +32,8 @@ public:
             IdentityStops<T>>>;
 
     SourceFunction(std::unique_ptr<expression::Expression> expression_)
-        : expression(std::move(expression_))
+        : expression(std::move(expression_)),
+          compiled(expression::CompiledExpression::compile(*expression))
     {
         assert(expression::isZoomConstant(*expression));
         assert(!expression::isFeatureConstant(*expression));
@@ -44,12 +47,13 @@ public:
               return expression::Convert::fromIdentityFunction(expression::valueTypeToExpressionType<T>(), property);
           }, [&] (const auto& s) {
               return expression::Convert::toExpression(property, s);
-          }))
+          })),
+          compiled(expression::CompiledExpression::compile(*expression))
     {}
 
     template <class Feature>
     T evaluate(const Feature& feature, T finalDefaultValue) const {
-        const expression::EvaluationResult result = expression->evaluate(expression::EvaluationContext(&feature));
+        const expression::EvaluationResult result = evaluateExpression(expression::EvaluationContext(&feature));
         if (result) {
             const optional<T> typed = expression::fromExpressionValue<T>(*result);
             return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
@@ -57,11 +61,51 @@ public:
         return defaultValue ? *defaultValue : finalDefaultValue;
     }
 
+    // Evaluates the function for a feature in the given feature state.
+    template <class Feature>
+    T evaluate(const Feature& feature, const FeatureState& state, T finalDefaultValue) const {
+        expression::EvaluationContext context(&feature);
+        context.featureState = &state;
+        const expression::EvaluationResult result = evaluateExpression(context);
+        if (result) {
+            const optional<T> typed = expression::fromExpressionValue<T>(*result);
+            return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
+        }
+        return defaultValue ? *defaultValue : finalDefaultValue;
+    }
+
+    // Evaluates the function for each of the given features, in order.
+    template <class Feature>
+    std::vector<T> evaluate(const std::vector<const Feature*>& features, T finalDefaultValue) const {
+        std::vector<T> result;
+        result.reserve(features.size());
+        const T fallback = defaultValue ? *defaultValue : finalDefaultValue;
+        expression::EvaluationContext context { static_cast<const GeometryTileFeature*>(nullptr) };
+        auto evaluateAll = [&] (const auto& evaluator) {
+            for (const Feature* feature : features) {
+                context.feature = feature;
+                const expression::EvaluationResult evaluated = evaluator.evaluate(context);
+                const optional<T> typed = evaluated ? expression::fromExpressionValue<T>(*evaluated) : optional<T>();
+                result.push_back(typed ? *typed : fallback);
+            }
+        };
+        if (compiled) {
+            evaluateAll(*compiled);
+        } else {
+            evaluateAll(*expression);
+        }
+        return result;
+    }
+
     friend bool operator==(const SourceFunction& lhs,
                            const SourceFunction& rhs) {
         return *lhs.expression == *rhs.expression;
     }
 
+    bool isFeatureStateConstant() const {
+        return expression::isFeatureStateConstant(*expression);
+    }
+
     bool useIntegerZoom = false;
 
     // retained for compatibility with pre-expression function API
@@ -70,7 +114,12 @@ public:
     optional<T> defaultValue;
 
 private:
+    expression::EvaluationResult evaluateExpression(const expression::EvaluationContext& context) const {
+        return compiled ? compiled->evaluate(context) : expression->evaluate(context);
+    }
+
     std::shared_ptr<expression::Expression> expression;
+    std::shared_ptr<const expression::CompiledExpression> compiled;
 };
 
 } // namespace style
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace mbgl {
@@ -7,6 +8,7 @@ namespace util {
 
 std::string compress(const std::string& raw);
 std::string decompress(const std::string& raw);
+std::string decompress(const char* raw, std::size_t size);
 
 } // namespace util
 } // namespace mbgl
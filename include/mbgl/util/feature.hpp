@@ -12,6 +12,10 @@ using PropertyMap = mapbox::geometry::property_map;
 using FeatureIdentifier = mapbox::geometry::identifier;
 using Feature = mapbox::geometry::feature<double>;
 
+// Client-controlled state of individual features, such as "hover" or "selected", that
+// style expressions can read with ["feature-state", key].
+using FeatureState = PropertyMap;
+
 template <class T>
 optional<T> numericValue(const Value& value) {
     return value.match(
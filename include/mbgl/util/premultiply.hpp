@@ -6,6 +6,8 @@ namespace mbgl {
 namespace util {
 
 PremultipliedImage premultiply(UnassociatedImage&&);
+// Premultiplies RGBA pixel data in place.
+void premultiply(uint8_t* data, std::size_t size);
 UnassociatedImage unpremultiply(PremultipliedImage&&);
 
 } // namespace util
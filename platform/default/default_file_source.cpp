@@ -2,17 +2,26 @@
 #include <mbgl/storage/asset_file_source.hpp>
 #include <mbgl/storage/file_source_request.hpp>
 #include <mbgl/storage/local_file_source.hpp>
+#include <mbgl/storage/mbtiles_file_source.hpp>
 #include <mbgl/storage/online_file_source.hpp>
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/offline_download.hpp>
 #include <mbgl/storage/resource_transform.hpp>
 
+#include <mbgl/util/logging.hpp>
 #include <mbgl/util/platform.hpp>
+#include <mbgl/util/string.hpp>
 #include <mbgl/util/url.hpp>
 #include <mbgl/util/thread.hpp>
 #include <mbgl/util/work_request.hpp>
 
+#include "sqlite3.hpp"
+
+#include <algorithm>
 #include <cassert>
+#include <map>
+#include <tuple>
+#include <vector>
 
 namespace {
 
@@ -26,17 +35,266 @@ bool isAssetURL(const std::string& url) {
 
 namespace mbgl {
 
+namespace {
+
+// Looks up resources in the ambient cache, from a read-only connection of its own. A lookup
+// that fails, for instance because the database stayed locked for too long, counts as a miss.
+class CacheReader {
+public:
+    CacheReader(std::unique_ptr<OfflineDatabase> database_)
+        : database(std::move(database_)) {
+    }
+
+    void get(const Resource& resource, std::function<void (optional<Response>)> callback) {
+        optional<Response> response;
+        try {
+            response = database->get(resource);
+        } catch (const mapbox::sqlite::Exception& ex) {
+            Log::Error(Event::Database, "Unable to read from the offline database: %s", ex.what());
+        }
+        callback(std::move(response));
+    }
+
+    void getTileSnapshot(const Resource& resource, uint64_t layersHash, FileSource::SnapshotCallback callback) {
+        std::shared_ptr<const std::string> snapshot;
+        try {
+            snapshot = database->getTileSnapshot(resource, layersHash);
+        } catch (const mapbox::sqlite::Exception& ex) {
+            Log::Error(Event::Database, "Unable to read from the offline database: %s", ex.what());
+        }
+        callback(std::move(snapshot));
+    }
+
+private:
+    const std::unique_ptr<OfflineDatabase> database;
+};
+
+// Stores responses in the ambient cache and records hits, on a connection and a thread of its
+// own, so that neither lookups nor requests wait for writes. A write that fails is dropped.
+class CacheWriter {
+public:
+    CacheWriter(std::unique_ptr<OfflineDatabase> database_)
+        : database(std::move(database_)) {
+    }
+
+    void put(const Resource& resource, const Response& response) {
+        try {
+            database->put(resource, response);
+        } catch (const mapbox::sqlite::Exception& ex) {
+            Log::Error(Event::Database, "Unable to write to the offline database: %s", ex.what());
+        }
+    }
+
+    void markAccessed(const Resource& resource) {
+        try {
+            database->markAccessed(resource);
+        } catch (const mapbox::sqlite::Exception& ex) {
+            Log::Error(Event::Database, "Unable to write to the offline database: %s", ex.what());
+        }
+    }
+
+    void putTileSnapshot(const Resource& resource, uint64_t layersHash, std::shared_ptr<const std::string> snapshot) {
+        try {
+            database->putTileSnapshot(resource, layersHash, std::move(snapshot));
+        } catch (const mapbox::sqlite::Exception& ex) {
+            Log::Error(Event::Database, "Unable to write to the offline database: %s", ex.what());
+        }
+    }
+
+private:
+    const std::unique_ptr<OfflineDatabase> database;
+};
+
+const size_t cacheReaderCount = 2;
+
+// Keeps the latest response of a shared request, to replay to requests that join later. A 304
+// doesn't replace the data we already have; it only refreshes how long that data stays valid.
+void updateLatestResponse(optional<Response>& latest, const Response& res) {
+    if (res.notModified && latest) {
+        latest->expires = res.expires;
+        latest->mustRevalidate = res.mustRevalidate;
+    } else {
+        latest = res;
+    }
+}
+
+// What a request is sent from the cache: a usable response if there is one, and an error
+// otherwise when the cache is the only place the request may load from.
+optional<Response> responseFromCache(const Resource& resource, optional<Response> offlineResponse) {
+    if (resource.loadingMethod == Resource::LoadingMethod::CacheOnly) {
+        if (!offlineResponse) {
+            // Ensure there's always a response that we can send, so the caller knows that
+            // there's no optional data available in the cache, when it's the only place
+            // we're supposed to load from.
+            offlineResponse.emplace();
+            offlineResponse->noContent = true;
+            offlineResponse->error = std::make_unique<Response::Error>(
+                    Response::Error::Reason::NotFound, "Not found in offline database");
+        } else if (!offlineResponse->isUsable()) {
+            // Don't return resources the server requested not to show when they're stale.
+            // Even if we can't directly use the response, we may still use it to send a
+            // conditional HTTP request.
+            offlineResponse->error = std::make_unique<Response::Error>(
+                Response::Error::Reason::NotFound, "Cached resource is unusable");
+        }
+        return offlineResponse;
+    } else if (offlineResponse && offlineResponse->isUsable()) {
+        return offlineResponse;
+    }
+    return {};
+}
+
+} // namespace
+
 class DefaultFileSource::Impl {
+private:
+    // Everything about a resource that the cache or the network sees. The cache is keyed by
+    // the URL as given, and tiles by their template and coordinates, so only requests that
+    // would read the same cache entry share one.
+    using RequestKey = std::tuple<Resource::Kind,
+                                  Resource::LoadingMethod,
+                                  std::string,
+                                  optional<std::tuple<std::string, uint8_t, int32_t, int32_t, int8_t>>,
+                                  optional<Timestamp>,
+                                  optional<Timestamp>,
+                                  optional<std::string>>;
+
+    static RequestKey requestKey(const Resource& resource) {
+        optional<std::tuple<std::string, uint8_t, int32_t, int32_t, int8_t>> tile;
+        if (resource.tileData) {
+            const auto& data = *resource.tileData;
+            tile = std::make_tuple(data.urlTemplate, data.pixelRatio, data.x, data.y, data.z);
+        }
+        return RequestKey { resource.kind, resource.loadingMethod, resource.url, tile,
+                            resource.priorModified, resource.priorExpires, resource.priorEtag };
+    }
+
+    struct Waiter {
+        AsyncRequest* req;
+        ActorRef<FileSourceRequest> ref;
+
+        // Whether a cache reader sends this request what the cache had, instead of this thread.
+        bool sentFromCache = false;
+    };
+
+    struct SharedRequest {
+        uint64_t id = 0;
+        std::vector<Waiter> waiters;
+        std::unique_ptr<AsyncRequest> task;
+        optional<Response> response;
+
+        void respond(const Response& res, bool fromCache = false) {
+            updateLatestResponse(response, res);
+
+            for (auto& waiter : waiters) {
+                if (!(fromCache && waiter.sentFromCache)) {
+                    waiter.ref.invoke(&FileSourceRequest::setResponse, res);
+                }
+            }
+        }
+    };
+
+    // Requests that differ only in how they use the cache, such as a map request that missed
+    // the cache and an offline download of the same resource, still share one network request.
+    // URLs are compared once resolved, so a mapbox:// URL and the URL it resolves to share one too.
+    using NetworkKey = std::tuple<Resource::Kind,
+                                  std::string,
+                                  optional<Timestamp>,
+                                  optional<Timestamp>,
+                                  optional<std::string>>;
+
+    struct NetworkRequest {
+        std::map<uint64_t, std::function<void (const Response&)>> subscribers;
+        std::unique_ptr<AsyncRequest> task;
+        optional<Response> response;
+
+        // Whether responses go to the ambient cache. Offline downloads store them in their
+        // region instead.
+        bool cache = false;
+    };
+
+    using NetworkRequests = std::map<NetworkKey, NetworkRequest>;
+
+    // The last subscriber out cancels the network request.
+    class NetworkSubscription : public AsyncRequest {
+    public:
+        NetworkSubscription(Impl& impl_, NetworkRequests::iterator it_, uint64_t id_)
+            : impl(impl_), it(it_), id(id_) {
+        }
+
+        ~NetworkSubscription() override {
+            it->second.subscribers.erase(id);
+            if (it->second.subscribers.empty()) {
+                impl.networkRequests.erase(it);
+            }
+        }
+
+    private:
+        Impl& impl;
+        const NetworkRequests::iterator it;
+        const uint64_t id;
+    };
+
+    // What offline downloads request their resources from.
+    class SharedOnlineFileSource : public FileSource {
+    public:
+        SharedOnlineFileSource(Impl& impl_) : impl(impl_) {
+        }
+
+        std::unique_ptr<AsyncRequest> request(const Resource& resource, Callback callback) override {
+            auto req = std::make_unique<FileSourceRequest>(std::move(callback));
+
+            std::shared_ptr<AsyncRequest> subscription = impl.requestNetwork(resource, false,
+                [ref = req->actor()] (const Response& res) mutable {
+                    ref.invoke(&FileSourceRequest::setResponse, res);
+                });
+            req->onCancel([subscription] () mutable { subscription.reset(); });
+
+            return std::move(req);
+        }
+
+    private:
+        Impl& impl;
+    };
+
 public:
-    Impl(ActorRef<Impl> self, std::shared_ptr<FileSource> assetFileSource_, const std::string& cachePath, uint64_t maximumCacheSize)
-            : assetFileSource(assetFileSource_)
-            , localFileSource(std::make_unique<LocalFileSource>()) {
+    Impl(ActorRef<Impl> self_, std::shared_ptr<FileSource> assetFileSource_, const std::string& cachePath, uint64_t maximumCacheSize)
+            : self(self_)
+            , assetFileSource(assetFileSource_)
+            , localFileSource(std::make_unique<LocalFileSource>())
+            , mbtilesFileSource(std::make_unique<MBTilesFileSource>()) {
         // Initialize the Database asynchronously so as to not block Actor creation.
         self.invoke(&Impl::initializeOfflineDatabase, cachePath, maximumCacheSize);
     }
 
     void initializeOfflineDatabase(std::string cachePath, uint64_t maximumCacheSize) {
         offlineDatabase = std::make_unique<OfflineDatabase>(cachePath, maximumCacheSize);
+
+        // This connection keeps regions and offline downloads. Except for an in-memory database,
+        // which can't be shared between connections, the ambient cache is read from a pool of
+        // read-only connections and written through one more connection, each on a thread of
+        // its own, so that neither lookups nor writes queue up here.
+        if (cachePath == ":memory:") {
+            return;
+        }
+
+        // The other connections are opened here, so that if one fails, everything keeps going
+        // through this connection instead.
+        try {
+            offlineDatabase->enableConcurrentReads();
+            cacheWriter = std::make_unique<util::Thread<CacheWriter>>(
+                "DefaultFileSource::CacheWriter",
+                std::make_unique<OfflineDatabase>(cachePath, maximumCacheSize));
+            for (size_t i = 0; i < cacheReaderCount; ++i) {
+                cacheReaders.push_back(std::make_unique<util::Thread<CacheReader>>(
+                    "DefaultFileSource::CacheReader",
+                    std::make_unique<OfflineDatabase>(cachePath, OfflineDatabase::ReadOnly)));
+            }
+        } catch (...) {
+            Log::Error(Event::Database, "Unable to share the offline database: %s", util::toString(std::current_exception()).c_str());
+            cacheReaders.clear();
+            cacheWriter.reset();
+        }
     }
 
     void setAPIBaseURL(const std::string& url) {
@@ -114,63 +372,181 @@ public:
     }
 
     void request(AsyncRequest* req, Resource resource, ActorRef<FileSourceRequest> ref) {
-        auto callback = [ref] (const Response& res) mutable {
-            ref.invoke(&FileSourceRequest::setResponse, res);
+        // Identical requests share one lookup. A request that joins one already in flight is
+        // sent the latest response right away, and every response after that.
+        const RequestKey key = requestKey(resource);
+        auto it = sharedRequests.find(key);
+        if (it != sharedRequests.end()) {
+            duplicateRequests++;
+            it->second.waiters.push_back({ req, ref });
+            requests.emplace(req, it);
+            if (it->second.response) {
+                ref.invoke(&FileSourceRequest::setResponse, *it->second.response);
+            }
+            return;
+        }
+
+        it = sharedRequests.emplace(key, SharedRequest()).first;
+        it->second.id = nextSharedRequestID++;
+        it->second.waiters.push_back({ req, ref });
+        requests.emplace(req, it);
+
+        SharedRequest& shared = it->second;
+        auto callback = [&shared] (const Response& res) {
+            shared.respond(res);
         };
 
         if (isAssetURL(resource.url)) {
             //Asset request
-            tasks[req] = assetFileSource->request(resource, callback);
+            shared.task = assetFileSource->request(resource, callback);
         } else if (LocalFileSource::acceptsURL(resource.url)) {
             //Local file request
-            tasks[req] = localFileSource->request(resource, callback);
+            shared.task = localFileSource->request(resource, callback);
+        } else if (MBTilesFileSource::acceptsURL(resource.url)) {
+            //Local tile archive request
+            shared.task = mbtilesFileSource->request(resource, callback);
         } else {
-            // Try the offline database
-            if (resource.hasLoadingMethod(Resource::LoadingMethod::Cache)) {
-                auto offlineResponse = offlineDatabase->get(resource);
-
-                if (resource.loadingMethod == Resource::LoadingMethod::CacheOnly) {
-                    if (!offlineResponse) {
-                        // Ensure there's always a response that we can send, so the caller knows that
-                        // there's no optional data available in the cache, when it's the only place
-                        // we're supposed to load from.
-                        offlineResponse.emplace();
-                        offlineResponse->noContent = true;
-                        offlineResponse->error = std::make_unique<Response::Error>(
-                                Response::Error::Reason::NotFound, "Not found in offline database");
-                    } else if (!offlineResponse->isUsable()) {
-                        // Don't return resources the server requested not to show when they're stale.
-                        // Even if we can't directly use the response, we may still use it to send a
-                        // conditional HTTP request, which is why we're saving it above.
-                        offlineResponse->error = std::make_unique<Response::Error>(
-                            Response::Error::Reason::NotFound, "Cached resource is unusable");
-                    }
-                    callback(*offlineResponse);
-                } else if (offlineResponse) {
-                    // Copy over the fields so that we can use them when making a refresh request.
-                    resource.priorModified = offlineResponse->modified;
-                    resource.priorExpires = offlineResponse->expires;
-                    resource.priorEtag = offlineResponse->etag;
-                    resource.priorData = offlineResponse->data;
-
-                    if (offlineResponse->isUsable()) {
-                        callback(*offlineResponse);
-                    }
+            if (resource.hasLoadingMethod(Resource::LoadingMethod::Cache) && !cacheReaders.empty()) {
+                // The reader sends what the cache had straight to this request, so that a hit
+                // doesn't wait for whatever this thread is busy with. Requests that join in the
+                // meantime get it through cacheResponse().
+                shared.waiters.back().sentFromCache = true;
+                auto& reader = *cacheReaders[nextCacheReader++ % cacheReaders.size()];
+                reader.actor().invoke(&CacheReader::get, resource,
+                    [impl = self, ref, writer = cacheWriter->actor(), key, id = shared.id, resource] (optional<Response> offlineResponse) mutable {
+                        if (auto res = responseFromCache(resource, offlineResponse)) {
+                            ref.invoke(&FileSourceRequest::setResponse, *res);
+                        }
+                        // Read-only connections don't record hits, so the writer does, once the
+                        // hit is on its way.
+                        if (offlineResponse) {
+                            writer.invoke(&CacheWriter::markAccessed, resource);
+                        }
+                        impl.invoke(&Impl::cacheResponse, key, id, resource, std::move(offlineResponse));
+                    });
+            } else {
+                optional<Response> offlineResponse;
+                if (resource.hasLoadingMethod(Resource::LoadingMethod::Cache)) {
+                    offlineResponse = offlineDatabase->get(resource);
                 }
+                respond(shared, std::move(resource), std::move(offlineResponse));
             }
+        }
+    }
 
-            // Get from the online file source
-            if (resource.hasLoadingMethod(Resource::LoadingMethod::Network)) {
-                tasks[req] = onlineFileSource.request(resource, [=] (Response onlineResponse) mutable {
-                    this->offlineDatabase->put(resource, onlineResponse);
-                    callback(onlineResponse);
-                });
+    // Picks up a request once its lookup in the cache is done. It may have been cancelled since.
+    void cacheResponse(RequestKey key, uint64_t id, Resource resource, optional<Response> offlineResponse) {
+        auto it = sharedRequests.find(key);
+        if (it == sharedRequests.end() || it->second.id != id) {
+            return;
+        }
+
+        respond(it->second, resource, std::move(offlineResponse), true);
+    }
+
+    // Sends what the cache had, if anything, and goes to the network if the request allows.
+    // Waiters that a cache reader has already sent it to are skipped.
+    void respond(SharedRequest& shared, Resource resource, optional<Response> offlineResponse, bool sentFromCache = false) {
+        auto callback = [&shared] (const Response& res) {
+            shared.respond(res);
+        };
+
+        if (resource.hasLoadingMethod(Resource::LoadingMethod::Cache)) {
+            if (auto res = responseFromCache(resource, offlineResponse)) {
+                shared.respond(*res, sentFromCache);
+            }
+
+            if (offlineResponse && resource.loadingMethod != Resource::LoadingMethod::CacheOnly) {
+                // Copy over the fields so that we can use them when making a refresh request.
+                resource.priorModified = offlineResponse->modified;
+                resource.priorExpires = offlineResponse->expires;
+                resource.priorEtag = offlineResponse->etag;
+                resource.priorData = offlineResponse->data;
             }
         }
+
+        // Get from the online file source
+        if (resource.hasLoadingMethod(Resource::LoadingMethod::Network)) {
+            shared.task = requestNetwork(resource, true, callback);
+        }
+    }
+
+    // Joins a network request for an equivalent resource if there is one in flight, and sends
+    // a new one otherwise. A subscriber that joins is sent the latest response right away.
+    std::unique_ptr<AsyncRequest> requestNetwork(const Resource& resource, bool cache, std::function<void (const Response&)> callback) {
+        const NetworkKey key { resource.kind, onlineFileSource.resolveURL(resource),
+                               resource.priorModified, resource.priorExpires, resource.priorEtag };
+        const uint64_t id = nextNetworkSubscriberID++;
+
+        auto it = networkRequests.find(key);
+        if (it != networkRequests.end()) {
+            duplicateRequests++;
+            NetworkRequest& network = it->second;
+            network.cache = network.cache || cache;
+            network.subscribers.emplace(id, callback);
+            if (network.response) {
+                callback(*network.response);
+            }
+            return std::make_unique<NetworkSubscription>(*this, it, id);
+        }
+
+        it = networkRequests.emplace(key, NetworkRequest()).first;
+        NetworkRequest& network = it->second;
+        network.cache = cache;
+        network.subscribers.emplace(id, std::move(callback));
+        network.task = onlineFileSource.request(resource, [this, &network, resource] (Response onlineResponse) {
+            if (network.cache) {
+                put(resource, onlineResponse);
+            }
+
+            updateLatestResponse(network.response, onlineResponse);
+            for (auto& subscriber : network.subscribers) {
+                subscriber.second(onlineResponse);
+            }
+        });
+
+        return std::make_unique<NetworkSubscription>(*this, it, id);
     }
 
     void cancel(AsyncRequest* req) {
-        tasks.erase(req);
+        auto it = requests.find(req);
+        if (it == requests.end()) {
+            return;
+        }
+
+        auto shared = it->second;
+        requests.erase(it);
+
+        auto& waiters = shared->second.waiters;
+        waiters.erase(std::find_if(waiters.begin(), waiters.end(), [&] (const auto& waiter) {
+            return waiter.req == req;
+        }));
+
+        // The last one out cancels the underlying request.
+        if (waiters.empty()) {
+            sharedRequests.erase(shared);
+        }
+    }
+
+    void getDuplicateRequestCount(std::function<void (uint64_t)> callback) {
+        callback(duplicateRequests);
+    }
+
+    void getTileSnapshot(const Resource& resource, uint64_t layersHash, FileSource::SnapshotCallback callback) {
+        if (!cacheReaders.empty()) {
+            auto& reader = *cacheReaders[nextCacheReader++ % cacheReaders.size()];
+            reader.actor().invoke(&CacheReader::getTileSnapshot, resource, layersHash, std::move(callback));
+        } else {
+            callback(offlineDatabase->getTileSnapshot(resource, layersHash));
+        }
+    }
+
+    void putTileSnapshot(const Resource& resource, uint64_t layersHash, std::shared_ptr<const std::string> snapshot) {
+        if (cacheWriter) {
+            cacheWriter->actor().invoke(&CacheWriter::putTileSnapshot, resource, layersHash, std::move(snapshot));
+        } else {
+            offlineDatabase->putTileSnapshot(resource, layersHash, std::move(snapshot));
+        }
     }
 
     void setOfflineMapboxTileCountLimit(uint64_t limit) {
@@ -182,7 +558,11 @@ public:
     }
 
     void put(const Resource& resource, const Response& response) {
-        offlineDatabase->put(resource, response);
+        if (cacheWriter) {
+            cacheWriter->actor().invoke(&CacheWriter::put, resource, response);
+        } else {
+            offlineDatabase->put(resource, response);
+        }
     }
 
 private:
@@ -192,15 +572,31 @@ private:
             return *it->second;
         }
         return *downloads.emplace(regionID,
-            std::make_unique<OfflineDownload>(regionID, offlineDatabase->getRegionDefinition(regionID), *offlineDatabase, onlineFileSource)).first->second;
+            std::make_unique<OfflineDownload>(regionID, offlineDatabase->getRegionDefinition(regionID), *offlineDatabase, sharedOnlineFileSource)).first->second;
     }
 
+    ActorRef<Impl> self;
+
     // shared so that destruction is done on the creating thread
     const std::shared_ptr<FileSource> assetFileSource;
     const std::unique_ptr<FileSource> localFileSource;
+    const std::unique_ptr<FileSource> mbtilesFileSource;
+    // Declared ahead of the connections that share it, so that it is closed last.
     std::unique_ptr<OfflineDatabase> offlineDatabase;
+    std::unique_ptr<util::Thread<CacheWriter>> cacheWriter;
+    std::vector<std::unique_ptr<util::Thread<CacheReader>>> cacheReaders;
+    size_t nextCacheReader = 0;
     OnlineFileSource onlineFileSource;
-    std::unordered_map<AsyncRequest*, std::unique_ptr<AsyncRequest>> tasks;
+
+    // Declared ahead of the requests that subscribe to them, which unsubscribe on destruction.
+    NetworkRequests networkRequests;
+    uint64_t nextNetworkSubscriberID = 0;
+    SharedOnlineFileSource sharedOnlineFileSource { *this };
+
+    std::map<RequestKey, SharedRequest> sharedRequests;
+    uint64_t nextSharedRequestID = 0;
+    std::unordered_map<AsyncRequest*, std::map<RequestKey, SharedRequest>::iterator> requests;
+    uint64_t duplicateRequests = 0;
     std::unordered_map<int64_t, std::unique_ptr<OfflineDownload>> downloads;
 };
 
@@ -297,6 +693,18 @@ void DefaultFileSource::setOfflineMapboxTileCountLimit(uint64_t limit) const {
     impl->actor().invoke(&Impl::setOfflineMapboxTileCountLimit, limit);
 }
 
+void DefaultFileSource::getDuplicateRequestCount(std::function<void (uint64_t)> callback) const {
+    impl->actor().invoke(&Impl::getDuplicateRequestCount, callback);
+}
+
+void DefaultFileSource::getTileSnapshot(const Resource& resource, uint64_t layersHash, SnapshotCallback callback) {
+    impl->actor().invoke(&Impl::getTileSnapshot, resource, layersHash, callback);
+}
+
+void DefaultFileSource::putTileSnapshot(const Resource& resource, uint64_t layersHash, std::shared_ptr<const std::string> snapshot) {
+    impl->actor().invoke(&Impl::putTileSnapshot, resource, layersHash, std::move(snapshot));
+}
+
 void DefaultFileSource::pause() {
     impl->pause();
 }
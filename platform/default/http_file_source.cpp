@@ -18,6 +18,7 @@
 #include <cassert>
 #include <cstring>
 #include <cstdio>
+#include <cstdlib>
 
 static void handleError(CURLMcode code) {
     if (code != CURLM_OK) {
@@ -306,6 +307,9 @@ size_t headerMatches(const char *const header, const char *const buffer, const s
     return i == headerLength ? i : std::string::npos;
 }
 
+// Larger Content-Length values aren't trusted enough to allocate for them up front.
+static constexpr unsigned long long maximumReservedLength = 64 * 1024 * 1024;
+
 size_t HTTPRequest::headerCallback(char *const buffer, const size_t size, const size_t nmemb, void *userp) {
     assert(userp);
     auto baton = reinterpret_cast<HTTPRequest *>(userp);
@@ -335,6 +339,17 @@ size_t HTTPRequest::headerCallback(char *const buffer, const size_t size, const
         baton->retryAfter = std::string(buffer + begin, length - begin - 2); // remove \r\n
     } else if ((begin = headerMatches("x-rate-limit-reset: ", buffer, length)) != std::string::npos) {
         baton->xRateLimitReset = std::string(buffer + begin, length - begin - 2); // remove \r\n
+    } else if ((begin = headerMatches("content-length: ", buffer, length)) != std::string::npos) {
+        // Size the buffer up front so that appending the body doesn't move it around. The
+        // length is only a hint: it may be that of a redirect, or of the encoded body.
+        const std::string value { buffer + begin, length - begin - 2 }; // remove \r\n
+        const auto contentLength = std::strtoull(value.c_str(), nullptr, 10);
+        if (contentLength > 0 && contentLength <= maximumReservedLength) {
+            if (!baton->data) {
+                baton->data = std::make_shared<std::string>();
+            }
+            baton->data->reserve(contentLength);
+        }
     }
 
     return length;
@@ -0,0 +1,91 @@
+#include <mbgl/storage/mbtiles_archive.hpp>
+#include <mbgl/util/compression.hpp>
+
+#include "sqlite3.hpp"
+
+#include <rapidjson/writer.h>
+#include <rapidjson/stringbuffer.h>
+
+#include <cstdlib>
+
+namespace mbgl {
+
+MBTilesArchive::MBTilesArchive(const std::string& path)
+    : db(std::make_unique<mapbox::sqlite::Database>(path, mapbox::sqlite::ReadOnly)) {
+    // SQLite caps this at the largest map size it was compiled to support.
+    db->exec("PRAGMA mmap_size = 1099511627776");
+
+    tileStatement = std::make_unique<mapbox::sqlite::Statement>(db->prepare(
+        "SELECT tile_data FROM tiles WHERE zoom_level = ?1 AND tile_column = ?2 AND tile_row = ?3"));
+
+    auto stmt = db->prepare("SELECT name, value FROM metadata");
+    while (stmt.run()) {
+        metadata.emplace(stmt.get<std::string>(0), stmt.get<std::string>(1));
+    }
+}
+
+MBTilesArchive::~MBTilesArchive() = default;
+
+std::shared_ptr<const std::string> MBTilesArchive::getTile(int32_t z, int32_t x, int32_t row) {
+    mapbox::sqlite::Statement& stmt = *tileStatement;
+    // Leaves the statement usable if decompressing the previous tile threw.
+    stmt.reset();
+    stmt.bind(1, z);
+    stmt.bind(2, x);
+    stmt.bind(3, row);
+
+    std::shared_ptr<const std::string> data;
+    if (stmt.run()) {
+        const auto blob = stmt.getBlob(0);
+        if (blob.second >= 2 && uint8_t(blob.first[0]) == 0x1F && uint8_t(blob.first[1]) == 0x8B) {
+            data = std::make_shared<std::string>(util::decompress(blob.first, blob.second));
+        } else if (blob.first) {
+            data = std::make_shared<std::string>(blob.first, blob.second);
+        }
+    }
+    stmt.reset();
+
+    return data;
+}
+
+std::string MBTilesArchive::getTileJSON(const std::string& tileURLTemplate) const {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+    writer.StartObject();
+    writer.Key("tilejson");
+    writer.String("2.2.0");
+    writer.Key("scheme");
+    writer.String("tms");
+    writer.Key("tiles");
+    writer.StartArray();
+    writer.String(tileURLTemplate);
+    writer.EndArray();
+
+    for (const char* key : { "minzoom", "maxzoom" }) {
+        auto it = metadata.find(key);
+        if (it == metadata.end()) {
+            continue;
+        }
+        char* end = nullptr;
+        const long zoom = std::strtol(it->second.c_str(), &end, 10);
+        if (end != it->second.c_str() && *end == '\0') {
+            writer.Key(key);
+            writer.Int64(zoom);
+        }
+    }
+
+    for (const char* key : { "name", "description", "attribution", "version" }) {
+        auto it = metadata.find(key);
+        if (it != metadata.end()) {
+            writer.Key(key);
+            writer.String(it->second);
+        }
+    }
+
+    writer.EndObject();
+
+    return { buffer.GetString(), buffer.GetSize() };
+}
+
+} // namespace mbgl
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace mapbox {
+namespace sqlite {
+class Database;
+class Statement;
+} // namespace sqlite
+} // namespace mapbox
+
+namespace mbgl {
+
+// Read-only access to an MBTiles archive: an SQLite database with a `tiles` table, whose rows
+// are numbered in the TMS scheme, and a `metadata` table of name/value pairs. The database is
+// memory-mapped, so that reading a tile copies or inflates it straight out of the mapped file.
+class MBTilesArchive : private util::noncopyable {
+public:
+    // Throws mapbox::sqlite::Exception if the archive can't be opened.
+    MBTilesArchive(const std::string& path);
+    ~MBTilesArchive();
+
+    // Returns null if the archive doesn't contain the tile. Gzipped tiles are decompressed.
+    std::shared_ptr<const std::string> getTile(int32_t z, int32_t x, int32_t row);
+
+    // Returns TileJSON for the archive's metadata, with the given tile URL template.
+    std::string getTileJSON(const std::string& tileURLTemplate) const;
+
+private:
+    std::unique_ptr<mapbox::sqlite::Database> db;
+    std::unique_ptr<mapbox::sqlite::Statement> tileStatement;
+    std::unordered_map<std::string, std::string> metadata;
+};
+
+} // namespace mbgl
@@ -8,8 +8,18 @@
 
 #include "sqlite3.hpp"
 
+#include <cassert>
+
 namespace mbgl {
 
+namespace {
+
+// Read-only connections give up on a lock after this long, so that a lookup fails instead of
+// stalling its thread behind a write that holds the database.
+const Milliseconds readOnlyBusyTimeout { 100 };
+
+} // namespace
+
 OfflineDatabase::Statement::~Statement() {
     stmt.reset();
     stmt.clearBindings();
@@ -17,13 +27,36 @@ OfflineDatabase::Statement::~Statement() {
 
 OfflineDatabase::OfflineDatabase(std::string path_, uint64_t maximumCacheSize_)
     : path(std::move(path_)),
+      readOnly(false),
       maximumCacheSize(maximumCacheSize_) {
     ensureSchema();
 }
 
+constexpr OfflineDatabase::ReadOnlyTag OfflineDatabase::ReadOnly;
+
+OfflineDatabase::OfflineDatabase(std::string path_, ReadOnlyTag)
+    : path(std::move(path_)),
+      readOnly(true),
+      maximumCacheSize(0) {
+    connect(mapbox::sqlite::ReadOnly);
+}
+
 OfflineDatabase::~OfflineDatabase() {
     // Deleting these SQLite objects may result in exceptions, but we're in a destructor, so we
     // can't throw anything.
+    //
+    // WAL journaling is stored in the database file, and schema version 5 went back to the
+    // default journal mode for good (see migrateToVersion5). Leave the file as we found it.
+    // This only works once every other connection to the file is closed.
+    if (concurrentReads) {
+        try {
+            db->setBusyTimeout(readOnlyBusyTimeout);
+            db->exec("PRAGMA journal_mode = DELETE");
+        } catch (mapbox::sqlite::Exception& ex) {
+            Log::Warning(Event::Database, "Unable to restore the journal mode: %s", ex.what());
+        }
+    }
+
     try {
         statements.clear();
         db.reset();
@@ -34,7 +67,7 @@ OfflineDatabase::~OfflineDatabase() {
 
 void OfflineDatabase::connect(int flags) {
     db = std::make_unique<mapbox::sqlite::Database>(path.c_str(), flags);
-    db->setBusyTimeout(Milliseconds::max());
+    db->setBusyTimeout(readOnly ? readOnlyBusyTimeout : Milliseconds::max());
     db->exec("PRAGMA foreign_keys = ON");
 }
 
@@ -50,7 +83,8 @@ void OfflineDatabase::ensureSchema() {
             case 3: // no-op and fall through
             case 4: migrateToVersion5(); // fall through
             case 5: migrateToVersion6(); // fall through
-            case 6: return;
+            case 6: migrateToVersion7(); // fall through
+            case 7: return;
             default: break; // downgrade, delete the database
             }
 
@@ -84,13 +118,19 @@ void OfflineDatabase::ensureSchema() {
         db->exec("PRAGMA journal_mode = DELETE");
         db->exec("PRAGMA synchronous = FULL");
         db->exec(schema);
-        db->exec("PRAGMA user_version = 6");
+        db->exec("PRAGMA user_version = 7");
     } catch (...) {
         Log::Error(Event::Database, "Unexpected error creating database schema: %s", util::toString(std::current_exception()).c_str());
         throw;
     }
 }
 
+void OfflineDatabase::enableConcurrentReads() {
+    assert(!readOnly);
+    db->exec("PRAGMA journal_mode = WAL");
+    concurrentReads = true;
+}
+
 int OfflineDatabase::userVersion() {
     auto stmt = db->prepare("PRAGMA user_version");
     stmt.run();
@@ -135,6 +175,18 @@ void OfflineDatabase::migrateToVersion6() {
     transaction.commit();
 }
 
+void OfflineDatabase::migrateToVersion7() {
+    mapbox::sqlite::Transaction transaction(*db);
+    db->exec("CREATE TABLE tile_snapshots ("
+             "  tile_id INTEGER NOT NULL REFERENCES tiles(id) ON DELETE CASCADE,"
+             "  layers_hash INTEGER NOT NULL,"
+             "  data BLOB NOT NULL,"
+             "  UNIQUE (tile_id, layers_hash)"
+             ")");
+    db->exec("PRAGMA user_version = 7");
+    transaction.commit();
+}
+
 OfflineDatabase::Statement OfflineDatabase::getStatement(const char * sql) {
     auto it = statements.find(sql);
 
@@ -150,6 +202,16 @@ optional<Response> OfflineDatabase::get(const Resource& resource) {
     return result ? result->first : optional<Response>();
 }
 
+void OfflineDatabase::markAccessed(const Resource& resource) {
+    assert(!readOnly);
+    if (resource.kind == Resource::Kind::Tile) {
+        assert(resource.tileData);
+        markTileAccessed(*resource.tileData);
+    } else {
+        markResourceAccessed(resource);
+    }
+}
+
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getInternal(const Resource& resource) {
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
@@ -208,7 +270,7 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
     return { inserted, size };
 }
 
-optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
+void OfflineDatabase::markResourceAccessed(const Resource& resource) {
     // clang-format off
     Statement accessedStmt = getStatement(
         "UPDATE resources SET accessed = ?1 WHERE url = ?2");
@@ -217,6 +279,12 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
     accessedStmt->bind(1, util::now());
     accessedStmt->bind(2, resource.url);
     accessedStmt->run();
+}
+
+optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
+    if (!readOnly) {
+        markResourceAccessed(resource);
+    }
 
     // clang-format off
     Statement stmt = getStatement(
@@ -240,15 +308,17 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
     response.mustRevalidate = stmt->get<bool>(2);
     response.modified       = stmt->get<optional<Timestamp>>(3);
 
-    optional<std::string> data = stmt->get<optional<std::string>>(4);
-    if (!data) {
+    // Read the blob in place, so that it is copied or inflated exactly once, into the buffer
+    // the response shares with everyone downstream.
+    const auto data = stmt->getBlob(4);
+    if (!data.first) {
         response.noContent = true;
     } else if (stmt->get<bool>(5)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
-        size = data->length();
+        response.data = std::make_shared<std::string>(util::decompress(data.first, data.second));
+        size = data.second;
     } else {
-        response.data = std::make_shared<std::string>(*data);
-        size = data->length();
+        response.data = std::make_shared<std::string>(data.first, data.second);
+        size = data.second;
     }
 
     return std::make_pair(response, size);
@@ -359,7 +429,7 @@ bool OfflineDatabase::putResource(const Resource& resource,
     return true;
 }
 
-optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
+void OfflineDatabase::markTileAccessed(const Resource::TileData& tile) {
     // clang-format off
     Statement accessedStmt = getStatement(
         "UPDATE tiles "
@@ -378,6 +448,12 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
     accessedStmt->bind(5, tile.y);
     accessedStmt->bind(6, tile.z);
     accessedStmt->run();
+}
+
+optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
+    if (!readOnly) {
+        markTileAccessed(tile);
+    }
 
     // clang-format off
     Statement stmt = getStatement(
@@ -409,20 +485,81 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
     response.mustRevalidate  = stmt->get<bool>(2);
     response.modified        = stmt->get<optional<Timestamp>>(3);
 
-    optional<std::string> data = stmt->get<optional<std::string>>(4);
-    if (!data) {
+    const auto data = stmt->getBlob(4);
+    if (!data.first) {
         response.noContent = true;
     } else if (stmt->get<bool>(5)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
-        size = data->length();
+        response.data = std::make_shared<std::string>(util::decompress(data.first, data.second));
+        size = data.second;
     } else {
-        response.data = std::make_shared<std::string>(*data);
-        size = data->length();
+        response.data = std::make_shared<std::string>(data.first, data.second);
+        size = data.second;
     }
 
     return std::make_pair(response, size);
 }
 
+std::shared_ptr<const std::string> OfflineDatabase::getTileSnapshot(const Resource& resource, uint64_t layersHash) {
+    assert(resource.tileData);
+    const Resource::TileData& tile = *resource.tileData;
+
+    // clang-format off
+    Statement stmt = getStatement(
+        "SELECT tile_snapshots.data "
+        "FROM tiles, tile_snapshots "
+        "WHERE tiles.url_template = ?1 "
+        "  AND tiles.pixel_ratio  = ?2 "
+        "  AND tiles.x            = ?3 "
+        "  AND tiles.y            = ?4 "
+        "  AND tiles.z            = ?5 "
+        "  AND tile_snapshots.tile_id = tiles.id "
+        "  AND tile_snapshots.layers_hash = ?6 ");
+    // clang-format on
+
+    stmt->bind(1, tile.urlTemplate);
+    stmt->bind(2, tile.pixelRatio);
+    stmt->bind(3, tile.x);
+    stmt->bind(4, tile.y);
+    stmt->bind(5, tile.z);
+    stmt->bind(6, int64_t(layersHash));
+
+    if (!stmt->run()) {
+        return nullptr;
+    }
+
+    const auto data = stmt->getBlob(0);
+    return std::make_shared<std::string>(data.first, data.second);
+}
+
+void OfflineDatabase::putTileSnapshot(const Resource& resource, uint64_t layersHash, std::shared_ptr<const std::string> snapshot) {
+    assert(resource.tileData);
+    const Resource::TileData& tile = *resource.tileData;
+
+    // Snapshots count towards the cache size, and go when their tile goes. They don't evict
+    // anything themselves, which could be the very tile they belong to; the space they take is
+    // made up for by the next put().
+    // clang-format off
+    Statement stmt = getStatement(
+        "REPLACE INTO tile_snapshots (tile_id, layers_hash, data) "
+        "SELECT id, ?6, ?7 "
+        "FROM tiles "
+        "WHERE url_template = ?1 "
+        "  AND pixel_ratio  = ?2 "
+        "  AND x            = ?3 "
+        "  AND y            = ?4 "
+        "  AND z            = ?5 ");
+    // clang-format on
+
+    stmt->bind(1, tile.urlTemplate);
+    stmt->bind(2, tile.pixelRatio);
+    stmt->bind(3, tile.x);
+    stmt->bind(4, tile.y);
+    stmt->bind(5, tile.z);
+    stmt->bind(6, int64_t(layersHash));
+    stmt->bindBlob(7, snapshot->data(), snapshot->size(), false);
+    stmt->run();
+}
+
 optional<int64_t> OfflineDatabase::hasTile(const Resource::TileData& tile) {
     // clang-format off
     Statement stmt = getStatement(
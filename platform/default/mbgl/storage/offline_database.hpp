@@ -28,13 +28,32 @@ public:
     // Limits affect ambient caching (put) only; resources required by offline
     // regions are exempt.
     OfflineDatabase(std::string path, uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+
+    // Opens an existing database for lookups only, on a connection of its own. Lookups through
+    // it don't record when a resource was last used; markAccessed() on a writable instance does.
+    // They throw if the database stays locked for more than a short while.
+    struct ReadOnlyTag {};
+    static constexpr ReadOnlyTag ReadOnly {};
+    OfflineDatabase(std::string path, ReadOnlyTag);
+
     ~OfflineDatabase();
 
     optional<Response> get(const Resource&);
+    void markAccessed(const Resource&);
+
+    // Switches the database to WAL journaling, so that read-only instances neither block writes
+    // nor wait for them. The setting is stored in the database file, so the destructor switches
+    // back to the default journal mode, which requires other connections to be closed by then.
+    void enableConcurrentReads();
 
     // Return value is (inserted, stored size)
     std::pair<bool, uint64_t> put(const Resource&, const Response&);
 
+    // Snapshots of a laid out tile, keyed by a hash of the style layers. They are only stored
+    // for tiles that are in the database, and deleted along with them.
+    std::shared_ptr<const std::string> getTileSnapshot(const Resource&, uint64_t layersHash);
+    void putTileSnapshot(const Resource&, uint64_t layersHash, std::shared_ptr<const std::string>);
+
     std::vector<OfflineRegion> listRegions();
 
     OfflineRegion createRegion(const OfflineRegionDefinition&,
@@ -65,6 +84,7 @@ private:
     void migrateToVersion3();
     void migrateToVersion5();
     void migrateToVersion6();
+    void migrateToVersion7();
 
     class Statement {
     public:
@@ -81,11 +101,13 @@ private:
 
     Statement getStatement(const char *);
 
+    void markTileAccessed(const Resource::TileData&);
     optional<std::pair<Response, uint64_t>> getTile(const Resource::TileData&);
     optional<int64_t> hasTile(const Resource::TileData&);
     bool putTile(const Resource::TileData&, const Response&,
                  const std::string&, bool compressed);
 
+    void markResourceAccessed(const Resource&);
     optional<std::pair<Response, uint64_t>> getResource(const Resource&);
     optional<int64_t> hasResource(const Resource&);
     bool putResource(const Resource&, const Response&,
@@ -102,6 +124,8 @@ private:
     std::pair<int64_t, int64_t> getCompletedTileCountAndSize(int64_t regionID);
 
     const std::string path;
+    const bool readOnly;
+    bool concurrentReads = false;
     std::unique_ptr<::mapbox::sqlite::Database> db;
     std::unordered_map<const char *, std::unique_ptr<::mapbox::sqlite::Statement>> statements;
 
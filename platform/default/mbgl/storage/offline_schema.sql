@@ -49,6 +49,13 @@ CREATE TABLE region_tiles (
   UNIQUE (region_id, tile_id)
 );
 
+CREATE TABLE tile_snapshots (              -- Laid out tiles, in the format of TileSnapshot.
+  tile_id INTEGER NOT NULL REFERENCES tiles(id) ON DELETE CASCADE,
+  layers_hash INTEGER NOT NULL,               -- Hash of the style layers that laid out the tile.
+  data BLOB NOT NULL,
+  UNIQUE (tile_id, layers_hash)
+);
+
 -- Indexes for efficient eviction queries
 
 CREATE INDEX resources_accessed
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/size.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+namespace mbgl {
+
+// Encodes a PNG incrementally, one row of premultiplied RGBA pixels at a time, so that
+// images larger than what fits in memory can be written. Only the deflate state and a
+// small output buffer are held; compressed data is flushed to the stream as it's produced.
+class PNGStreamWriter : private util::noncopyable {
+public:
+    PNGStreamWriter(std::ostream&, Size);
+    ~PNGStreamWriter();
+
+    // Rows must be written top to bottom; each holds `size.width` premultiplied RGBA pixels.
+    // Throws if all rows have been written already.
+    void writeRow(const uint8_t* row);
+
+    // Writes the trailing chunks. Throws if fewer rows than the height were written.
+    void finish();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace mbgl
@@ -0,0 +1,124 @@
+#include <mbgl/storage/mbtiles_file_source.hpp>
+#include <mbgl/storage/file_source_request.hpp>
+#include <mbgl/storage/mbtiles_archive.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/url.hpp>
+
+#include "sqlite3.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+const char* protocol = "mbtiles://";
+const std::size_t protocolLength = 10;
+
+// Splits "<archive>/{z}/{x}/{y}" into the archive path and the tile coordinates.
+bool parseTileURL(const std::string& url, std::string& path, int32_t coordinates[3]) {
+    std::size_t end = url.size();
+    for (int i = 2; i >= 0; --i) {
+        const std::size_t slash = url.rfind('/', end - 1);
+        if (slash == std::string::npos || slash + 1 == end || slash < protocolLength) {
+            return false;
+        }
+        char* last = nullptr;
+        const long value = std::strtol(url.c_str() + slash + 1, &last, 10);
+        if (last != url.c_str() + end || value < 0 || value > INT32_MAX) {
+            return false;
+        }
+        coordinates[i] = int32_t(value);
+        end = slash;
+    }
+    path = url.substr(protocolLength, end - protocolLength);
+    return true;
+}
+
+} // namespace
+
+namespace mbgl {
+
+class MBTilesFileSource::Impl {
+public:
+    Response get(const Resource& resource) {
+        Response response;
+
+        std::string path;
+        int32_t tile[3];
+        const bool isTile = resource.kind == Resource::Kind::Tile;
+        if (isTile) {
+            if (!parseTileURL(resource.url, path, tile)) {
+                response.error = std::make_unique<Response::Error>(
+                    Response::Error::Reason::Other, "Invalid MBTiles tile URL");
+                return response;
+            }
+        } else {
+            path = resource.url.substr(protocolLength);
+        }
+
+        try {
+            std::lock_guard<std::mutex> lock(mutex);
+            MBTilesArchive& archive = getArchive(util::percentDecode(path));
+
+            if (isTile) {
+                response.data = archive.getTile(tile[0], tile[1], tile[2]);
+                if (!response.data) {
+                    response.noContent = true;
+                }
+            } else {
+                response.data = std::make_shared<std::string>(
+                    archive.getTileJSON(resource.url + "/{z}/{x}/{y}"));
+            }
+        } catch (const mapbox::sqlite::Exception& ex) {
+            response.error = std::make_unique<Response::Error>(
+                ex.code == mapbox::sqlite::Exception::Code::CANTOPEN
+                    ? Response::Error::Reason::NotFound
+                    : Response::Error::Reason::Other,
+                ex.what());
+        } catch (...) {
+            response.error = std::make_unique<Response::Error>(
+                Response::Error::Reason::Other,
+                util::toString(std::current_exception()));
+        }
+
+        return response;
+    }
+
+private:
+    MBTilesArchive& getArchive(const std::string& path) {
+        auto it = archives.find(path);
+        if (it == archives.end()) {
+            it = archives.emplace(path, std::make_unique<MBTilesArchive>(path)).first;
+        }
+        return *it->second;
+    }
+
+    // Archives are opened on first use and stay open. Requests may come from several threads.
+    std::mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<MBTilesArchive>> archives;
+};
+
+MBTilesFileSource::MBTilesFileSource()
+    : impl(std::make_unique<Impl>()) {
+}
+
+MBTilesFileSource::~MBTilesFileSource() = default;
+
+std::unique_ptr<AsyncRequest> MBTilesFileSource::request(const Resource& resource, Callback callback) {
+    auto req = std::make_unique<FileSourceRequest>(std::move(callback));
+
+    // The lookup is cheap enough to do right away. Sending the response through the request's
+    // own mailbox still calls back asynchronously, and not at all once the request is cancelled.
+    req->actor().invoke(&FileSourceRequest::setResponse, impl->get(resource));
+
+    return std::move(req);
+}
+
+bool MBTilesFileSource::acceptsURL(const std::string& url) {
+    return url.compare(0, protocolLength, protocol) == 0;
+}
+
+} // namespace mbgl
@@ -205,36 +205,36 @@ OnlineFileSource::OnlineFileSource()
 
 OnlineFileSource::~OnlineFileSource() = default;
 
-std::unique_ptr<AsyncRequest> OnlineFileSource::request(const Resource& resource, Callback callback) {
-    Resource res = resource;
-
+std::string OnlineFileSource::resolveURL(const Resource& resource) const {
     switch (resource.kind) {
     case Resource::Kind::Unknown:
     case Resource::Kind::Image:
-        break;
+        return resource.url;
 
     case Resource::Kind::Style:
-        res.url = mbgl::util::mapbox::normalizeStyleURL(apiBaseURL, resource.url, accessToken);
-        break;
+        return mbgl::util::mapbox::normalizeStyleURL(apiBaseURL, resource.url, accessToken);
 
     case Resource::Kind::Source:
-        res.url = util::mapbox::normalizeSourceURL(apiBaseURL, resource.url, accessToken);
-        break;
+        return util::mapbox::normalizeSourceURL(apiBaseURL, resource.url, accessToken);
 
     case Resource::Kind::Glyphs:
-        res.url = util::mapbox::normalizeGlyphsURL(apiBaseURL, resource.url, accessToken);
-        break;
+        return util::mapbox::normalizeGlyphsURL(apiBaseURL, resource.url, accessToken);
 
     case Resource::Kind::SpriteImage:
     case Resource::Kind::SpriteJSON:
-        res.url = util::mapbox::normalizeSpriteURL(apiBaseURL, resource.url, accessToken);
-        break;
+        return util::mapbox::normalizeSpriteURL(apiBaseURL, resource.url, accessToken);
 
     case Resource::Kind::Tile:
-        res.url = util::mapbox::normalizeTileURL(apiBaseURL, resource.url, accessToken);
-        break;
+        return util::mapbox::normalizeTileURL(apiBaseURL, resource.url, accessToken);
     }
 
+    return resource.url;
+}
+
+std::unique_ptr<AsyncRequest> OnlineFileSource::request(const Resource& resource, Callback callback) {
+    Resource res = resource;
+    res.url = resolveURL(resource);
+
     return std::make_unique<OnlineFileRequest>(std::move(res), std::move(callback), *impl);
 }
 
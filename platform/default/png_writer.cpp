@@ -1,6 +1,9 @@
 #include <mbgl/util/compression.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/premultiply.hpp>
+#include <mbgl/util/png_stream_writer.hpp>
+
+#include <zlib.h>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wshadow"
@@ -9,6 +12,9 @@
 
 #include <cassert>
 #include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #define NETWORK_BYTE_UINT32(value)                                                                 \
     char(value >> 24), char(value >> 16), char(value >> 8), char(value >> 0)
@@ -33,6 +39,8 @@ void addChunk(std::string& png, const char* type, const char* data = "", const u
     png.append(crc, 4);
 }
 
+const char preamble[8] = { char(0x89), 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
 } // namespace
 
 namespace mbgl {
@@ -42,9 +50,6 @@ std::string encodePNG(const PremultipliedImage& pre) {
     // Make copy of the image so that we can unpremultiply it.
     const auto src = util::unpremultiply(pre.clone());
 
-    // PNG magic bytes
-    const char preamble[8] = { char(0x89), 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
-
     // IHDR chunk for our RGBA image.
     const char ihdr[13] = {
         NETWORK_BYTE_UINT32(src.size.width),  // width
@@ -77,4 +82,114 @@ std::string encodePNG(const PremultipliedImage& pre) {
     return png;
 }
 
+class PNGStreamWriter::Impl {
+public:
+    Impl(std::ostream& out_, Size size_)
+        : out(out_), size(size_), row(1 + size.width * 4), buffer(16384) {
+        std::memset(&stream, 0, sizeof(stream));
+        if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
+            throw std::runtime_error("failed to initialize deflate");
+        }
+
+        const char ihdr[13] = {
+            NETWORK_BYTE_UINT32(size.width),  // width
+            NETWORK_BYTE_UINT32(size.height), // height
+            8,                                // bit depth == 8 bits
+            6,                                // color type == RGBA
+            0,                                // compression method == deflate
+            0,                                // filter method == default
+            0,                                // interlace method == none
+        };
+
+        std::string header(preamble, 8);
+        addChunk(header, "IHDR", ihdr, 13);
+        out.write(header.data(), header.size());
+    }
+
+    ~Impl() {
+        deflateEnd(&stream);
+    }
+
+    void writeRow(const uint8_t* src) {
+        if (rowsWritten == size.height) {
+            throw std::runtime_error("PNG has more rows than its height");
+        }
+
+        // Every scanline is prefixed with its filter type (0), and unpremultiplied on the way.
+        row[0] = 0;
+        uint8_t* dst = row.data() + 1;
+        for (uint32_t i = 0; i < size.width * 4; i += 4) {
+            const uint8_t a = src[i + 3];
+            dst[i + 0] = a ? (255 * src[i + 0] + (a / 2)) / a : src[i + 0];
+            dst[i + 1] = a ? (255 * src[i + 1] + (a / 2)) / a : src[i + 1];
+            dst[i + 2] = a ? (255 * src[i + 2] + (a / 2)) / a : src[i + 2];
+            dst[i + 3] = a;
+        }
+
+        stream.next_in = row.data();
+        stream.avail_in = uInt(row.size());
+        deflateInto(Z_NO_FLUSH);
+        rowsWritten++;
+    }
+
+    void finish() {
+        // Without this, a short image would be written as a valid-looking but truncated PNG.
+        if (rowsWritten != size.height) {
+            throw std::runtime_error("PNG has " + std::to_string(rowsWritten) + " rows, but " +
+                                     std::to_string(size.height) + " were expected");
+        }
+        stream.next_in = nullptr;
+        stream.avail_in = 0;
+        deflateInto(Z_FINISH);
+
+        std::string trailer;
+        addChunk(trailer, "IEND");
+        out.write(trailer.data(), trailer.size());
+        out.flush();
+    }
+
+private:
+    // Emits one IDAT chunk each time the output buffer fills up.
+    void deflateInto(int flush) {
+        int code;
+        do {
+            stream.next_out = buffer.data() + pending;
+            stream.avail_out = uInt(buffer.size() - pending);
+            code = deflate(&stream, flush);
+            if (code == Z_STREAM_ERROR) {
+                throw std::runtime_error("failed to deflate PNG data");
+            }
+            pending = buffer.size() - stream.avail_out;
+            if (pending == buffer.size() || (flush == Z_FINISH && pending > 0)) {
+                std::string chunk;
+                addChunk(chunk, "IDAT", reinterpret_cast<const char*>(buffer.data()), static_cast<uint32_t>(pending));
+                out.write(chunk.data(), chunk.size());
+                pending = 0;
+            }
+        } while (stream.avail_in > 0 || (flush == Z_FINISH && code != Z_STREAM_END));
+    }
+
+    std::ostream& out;
+    const Size size;
+    z_stream stream;
+    std::vector<uint8_t> row;
+    std::vector<uint8_t> buffer;
+    std::size_t pending = 0;
+    uint32_t rowsWritten = 0;
+};
+
+PNGStreamWriter::PNGStreamWriter(std::ostream& out, Size size)
+    : impl(std::make_unique<Impl>(out, size)) {
+}
+
+PNGStreamWriter::~PNGStreamWriter() = default;
+
+void PNGStreamWriter::writeRow(const uint8_t* row) {
+    impl->writeRow(row);
+}
+
+void PNGStreamWriter::finish() {
+    impl->finish();
+}
+
 } // namespace mbgl
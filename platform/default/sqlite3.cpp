@@ -322,6 +322,16 @@ template <> std::vector<uint8_t> Statement::get(int offset) {
     return { begin, end };
 }
 
+std::pair<const char*, std::size_t> Statement::getBlob(int offset) {
+    assert(impl);
+    if (sqlite3_column_type(impl->stmt, offset) == SQLITE_NULL) {
+        return { nullptr, 0 };
+    }
+    // sqlite3_column_blob returns a null pointer for empty blobs as well.
+    const auto* data = reinterpret_cast<const char *>(sqlite3_column_blob(impl->stmt, offset));
+    return { data ? data : "", size_t(sqlite3_column_bytes(impl->stmt, offset)) };
+}
+
 template <>
 std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds>
 Statement::get(int offset) {
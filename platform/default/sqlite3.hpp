@@ -5,6 +5,7 @@
 #include <stdexcept>
 #include <chrono>
 #include <memory>
+#include <utility>
 
 namespace mapbox {
 namespace sqlite {
@@ -79,6 +80,10 @@ public:
 
     template <typename T> T get(int offset);
 
+    // Blob, without copying it out of SQLite. The memory stays valid until the statement is
+    // stepped, reset or destroyed. A NULL column yields a null pointer.
+    std::pair<const char*, std::size_t> getBlob(int offset);
+
     bool run();
     void reset();
     void clearBindings();
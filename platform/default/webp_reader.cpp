@@ -10,22 +10,24 @@ extern "C"
 namespace mbgl {
 
 PremultipliedImage decodeWebP(const uint8_t* data, size_t size) {
-    int width = 0, height = 0;
-    if (WebPGetInfo(data, size, &width, &height) == 0) {
+    WebPBitstreamFeatures features;
+    if (WebPGetFeatures(data, size, &features) != VP8_STATUS_OK) {
         throw std::runtime_error("failed to retrieve WebP basic header information");
     }
 
-    int stride = width * 4;
-    size_t webpSize = stride * height;
-    auto webp = std::make_unique<uint8_t[]>(webpSize);
+    PremultipliedImage image({ static_cast<uint32_t>(features.width),
+                               static_cast<uint32_t>(features.height) });
 
-    if (!WebPDecodeRGBAInto(data, size, webp.get(), webpSize, stride)) {
+    if (!WebPDecodeRGBAInto(data, size, image.data.get(), image.bytes(), image.stride())) {
         throw std::runtime_error("failed to decode WebP data");
     }
 
-    UnassociatedImage image({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) },
-                            std::move(webp));
-    return util::premultiply(std::move(image));
+    // Opaque images come out of the decoder with all alpha values at 255.
+    if (features.has_alpha) {
+        util::premultiply(image.data.get(), image.bytes());
+    }
+
+    return image;
 }
 
 } // namespace mbgl
@@ -58,6 +58,7 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/image.cpp
         PRIVATE platform/default/jpeg_reader.cpp
         PRIVATE platform/default/png_writer.cpp
+        PRIVATE platform/default/mbgl/util/png_stream_writer.hpp
         PRIVATE platform/default/png_reader.cpp
         PRIVATE platform/default/webp_reader.cpp
 
@@ -25,6 +25,7 @@ macro(mbgl_platform_core)
         PRIVATE platform/darwin/mbgl/util/image+MGLAdditions.hpp
         PRIVATE platform/darwin/src/image.mm
         PRIVATE platform/default/png_writer.cpp
+        PRIVATE platform/default/mbgl/util/png_stream_writer.hpp
 
         # Headless view
         PRIVATE platform/default/mbgl/gl/headless_frontend.cpp
@@ -13,6 +13,7 @@
 #include <cstdio>
 #include <chrono>
 #include <limits>
+#include <map>
 
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/logging.hpp>
@@ -120,6 +121,8 @@ public:
     }
 
     QSqlQuery query;
+    // Keeps the byte arrays handed out by getBlob() alive until the next step.
+    std::map<int, QByteArray> blobs;
     int64_t lastInsertRowId = 0;
     int64_t changes = 0;
 };
@@ -323,6 +326,7 @@ bool Statement::run() {
        }
     }
 
+    impl->blobs.clear();
     const bool hasNext = impl->query.next();
     if (!hasNext) impl->query.finish();
 
@@ -349,6 +353,16 @@ template <> std::vector<uint8_t> Statement::get(int offset) {
     return blob;
 }
 
+std::pair<const char*, std::size_t> Statement::getBlob(int offset) {
+    assert(impl && impl->query.isValid());
+    QByteArray& value = impl->blobs[offset] = impl->query.value(offset).toByteArray();
+    checkQueryError(impl->query);
+    if (value.isNull()) {
+        return { nullptr, 0 };
+    }
+    return { value.constData(), size_t(value.size()) };
+}
+
 template <> mbgl::Timestamp Statement::get(int offset) {
     assert(impl && impl->query.isValid());
     QVariant value = impl->query.value(offset);
@@ -403,6 +417,7 @@ template <> optional<mbgl::Timestamp> Statement::get(int offset) {
 
 void Statement::reset() {
     assert(impl);
+    impl->blobs.clear();
     impl->query.finish();
 }
 
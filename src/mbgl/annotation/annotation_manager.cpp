@@ -9,9 +9,15 @@
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/math/clamp.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/projection.hpp>
 
 #include <boost/function_output_iterator.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace mbgl {
 
 using namespace style;
@@ -20,6 +26,49 @@ const std::string AnnotationManager::SourceID = "com.mapbox.annotations";
 const std::string AnnotationManager::PointLayerID = "com.mapbox.annotations.points";
 const std::string AnnotationManager::ShapeLayerID = "com.mapbox.annotations.shape.";
 
+namespace {
+
+using Box = mapbox::geometry::box<double>;
+
+bool isEmpty(const Box& box) {
+    return !(box.min.x <= box.max.x && box.min.y <= box.max.y);
+}
+
+// The part of the projected world that the data of a tile covers, including the
+// buffer that shapes are tiled with.
+Box tileBounds(const CanonicalTileID& tileID) {
+    const double size = 1.0 / std::pow(2.0, tileID.z);
+    const double buffer = size * ShapeAnnotationImpl::tileBuffer / util::EXTENT;
+    return {
+        { tileID.x * size - buffer, tileID.y * size - buffer },
+        { (tileID.x + 1) * size + buffer, (tileID.y + 1) * size + buffer }
+    };
+}
+
+// Shapes that cross the antimeridian are wrapped into the neighboring world copy
+// when they are tiled, so a region also covers the tiles on the other side.
+template <class Fn>
+void forEachWrap(const Box& box, Fn&& fn) {
+    for (const double wrap : { -1.0, 0.0, 1.0 }) {
+        fn(Box { { box.min.x + wrap, box.min.y }, { box.max.x + wrap, box.max.y } });
+    }
+}
+
+Box projectedBounds(const Point<double>& point) {
+    if (!std::isfinite(point.x) || !std::isfinite(point.y)) {
+        return { { 1, 1 }, { 0, 0 } };
+    }
+    const LatLng latLng { util::clamp(point.y, -util::LATITUDE_MAX, util::LATITUDE_MAX), point.x };
+    const Point<double> projected = Projection::project(latLng, 1.0 / util::tileSize);
+    return { projected, projected };
+}
+
+bool intersects(const Box& a, const Box& b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+} // namespace
+
 AnnotationManager::AnnotationManager(Style& style_)
         : style(style_) {
 };
@@ -40,7 +89,6 @@ AnnotationID AnnotationManager::addAnnotation(const Annotation& annotation, cons
     Annotation::visit(annotation, [&] (const auto& annotation_) {
         this->add(id, annotation_, maxZoom);
     });
-    dirty = true;
     return id;
 }
 
@@ -49,31 +97,103 @@ bool AnnotationManager::updateAnnotation(const AnnotationID& id, const Annotatio
     Annotation::visit(annotation, [&] (const auto& annotation_) {
         this->update(id, annotation_, maxZoom);
     });
-    return dirty;
+    return !dirtyRegions.empty();
 }
 
 void AnnotationManager::removeAnnotation(const AnnotationID& id) {
     std::lock_guard<std::mutex> lock(mutex);
     remove(id);
-    dirty = true;
+}
+
+AnnotationIDs AnnotationManager::addAnnotations(const std::vector<Annotation>& annotations, const uint8_t maxZoom) {
+    std::lock_guard<std::mutex> lock(mutex);
+    BatchScope scope(*this, annotations.size());
+    AnnotationIDs ids;
+    ids.reserve(annotations.size());
+    for (const auto& annotation : annotations) {
+        AnnotationID id = nextID++;
+        Annotation::visit(annotation, [&] (const auto& annotation_) {
+            this->add(id, annotation_, maxZoom);
+        });
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+bool AnnotationManager::updateAnnotations(const std::vector<std::pair<AnnotationID, Annotation>>& annotations, const uint8_t maxZoom) {
+    std::lock_guard<std::mutex> lock(mutex);
+    BatchScope scope(*this, annotations.size());
+    for (const auto& annotation : annotations) {
+        Annotation::visit(annotation.second, [&] (const auto& annotation_) {
+            this->update(annotation.first, annotation_, maxZoom);
+        });
+    }
+    return !dirtyRegions.empty();
+}
+
+void AnnotationManager::removeAnnotations(const AnnotationIDs& ids) {
+    std::lock_guard<std::mutex> lock(mutex);
+    BatchScope scope(*this, ids.size());
+    for (const auto& id : ids) {
+        remove(id);
+    }
+}
+
+AnnotationManager::BatchScope::BatchScope(AnnotationManager& manager_, std::size_t size)
+    : manager(manager_) {
+    manager.beginBatch(size);
+}
+
+AnnotationManager::BatchScope::~BatchScope() {
+    manager.endBatch();
+}
+
+void AnnotationManager::beginBatch(std::size_t size) {
+    assert(!batch);
+    // Rebuilding the tree costs about as much as inserting all symbols again, so it only
+    // pays off when the batch is not much smaller than the tree itself.
+    batch = Batch { size * 4 >= symbolAnnotations.size(), false };
+}
+
+void AnnotationManager::endBatch() {
+    assert(batch);
+    if (batch->symbolsChanged) {
+        std::vector<std::shared_ptr<const SymbolAnnotationImpl>> values;
+        values.reserve(symbolAnnotations.size());
+        for (const auto& symbol : symbolAnnotations) {
+            values.push_back(symbol.second);
+        }
+        // The range constructor bulk loads the tree with the packing algorithm, which is
+        // both faster than repeated insertion and yields a better balanced tree.
+        symbolTree = SymbolAnnotationTree(values);
+    }
+    batch = {};
 }
 
 void AnnotationManager::add(const AnnotationID& id, const SymbolAnnotation& annotation, const uint8_t) {
     auto impl = std::make_shared<SymbolAnnotationImpl>(id, annotation);
-    symbolTree.insert(impl);
+    if (batch && batch->packSymbols) {
+        batch->symbolsChanged = true;
+    } else {
+        symbolTree.insert(impl);
+    }
     symbolAnnotations.emplace(id, impl);
+
+    invalidate(projectedBounds(annotation.geometry));
 }
 
 void AnnotationManager::add(const AnnotationID& id, const LineAnnotation& annotation, const uint8_t maxZoom) {
     ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
         std::make_unique<LineAnnotationImpl>(id, annotation, maxZoom)).first->second;
     impl.updateStyle(*style.get().impl);
+    insert(impl);
 }
 
 void AnnotationManager::add(const AnnotationID& id, const FillAnnotation& annotation, const uint8_t maxZoom) {
     ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
         std::make_unique<FillAnnotationImpl>(id, annotation, maxZoom)).first->second;
     impl.updateStyle(*style.get().impl);
+    insert(impl);
 }
 
 void AnnotationManager::update(const AnnotationID& id, const SymbolAnnotation& annotation, const uint8_t maxZoom) {
@@ -86,8 +206,6 @@ void AnnotationManager::update(const AnnotationID& id, const SymbolAnnotation& a
     const SymbolAnnotation& existing = it->second->annotation;
 
     if (existing.geometry != annotation.geometry || existing.icon != annotation.icon) {
-        dirty = true;
-
         remove(id);
         add(id, annotation, maxZoom);
     }
@@ -100,9 +218,8 @@ void AnnotationManager::update(const AnnotationID& id, const LineAnnotation& ann
         return;
     }
 
-    shapeAnnotations.erase(it);
+    erase(it);
     add(id, annotation, maxZoom);
-    dirty = true;
 }
 
 void AnnotationManager::update(const AnnotationID& id, const FillAnnotation& annotation, const uint8_t maxZoom) {
@@ -112,24 +229,53 @@ void AnnotationManager::update(const AnnotationID& id, const FillAnnotation& ann
         return;
     }
 
-    shapeAnnotations.erase(it);
+    erase(it);
     add(id, annotation, maxZoom);
-    dirty = true;
 }
 
 void AnnotationManager::remove(const AnnotationID& id) {
     if (symbolAnnotations.find(id) != symbolAnnotations.end()) {
-        symbolTree.remove(symbolAnnotations.at(id));
+        invalidate(projectedBounds(symbolAnnotations.at(id)->annotation.geometry));
+        if (batch && batch->packSymbols) {
+            batch->symbolsChanged = true;
+        } else {
+            symbolTree.remove(symbolAnnotations.at(id));
+        }
         symbolAnnotations.erase(id);
     } else if (shapeAnnotations.find(id) != shapeAnnotations.end()) {
         auto it = shapeAnnotations.find(id);
         *style.get().impl->removeLayer(it->second->layerID);
-        shapeAnnotations.erase(it);
+        erase(it);
     } else {
         assert(false); // Should never happen
     }
 }
 
+void AnnotationManager::insert(const ShapeAnnotationImpl& impl) {
+    const Box bounds = impl.projectedBounds();
+    if (!isEmpty(bounds)) {
+        shapeTree.insert({ ShapeAnnotationBox { { bounds.min.x, bounds.min.y }, { bounds.max.x, bounds.max.y } }, impl.id });
+    }
+    invalidate(bounds);
+}
+
+void AnnotationManager::erase(ShapeAnnotationMap::iterator it) {
+    // Bounds are recomputed from the geometry, so they match the inserted ones exactly.
+    const Box bounds = it->second->projectedBounds();
+    if (!isEmpty(bounds)) {
+        shapeTree.remove({ ShapeAnnotationBox { { bounds.min.x, bounds.min.y }, { bounds.max.x, bounds.max.y } }, it->first });
+    }
+    invalidate(bounds);
+    shapeAnnotations.erase(it);
+}
+
+void AnnotationManager::invalidate(const Box& region) {
+    if (isEmpty(region)) {
+        return;
+    }
+    dirtyRegions.push_back(region);
+}
+
 std::unique_ptr<AnnotationTileData> AnnotationManager::getTileData(const CanonicalTileID& tileID) {
     if (symbolAnnotations.empty() && shapeAnnotations.empty())
         return nullptr;
@@ -138,15 +284,25 @@ std::unique_ptr<AnnotationTileData> AnnotationManager::getTileData(const Canonic
 
     auto pointLayer = tileData->addLayer(PointLayerID);
 
-    LatLngBounds tileBounds(tileID);
+    const LatLngBounds latLngBounds(tileID);
 
-    symbolTree.query(boost::geometry::index::intersects(tileBounds),
+    symbolTree.query(boost::geometry::index::intersects(latLngBounds),
         boost::make_function_output_iterator([&](const auto& val){
             val->updateLayer(tileID, *pointLayer);
         }));
 
-    for (const auto& shape : shapeAnnotations) {
-        shape.second->updateTileData(tileID, *tileData);
+    std::vector<AnnotationID> shapes;
+    forEachWrap(tileBounds(tileID), [&] (const Box& box) {
+        shapeTree.query(boost::geometry::index::intersects(ShapeAnnotationBox { { box.min.x, box.min.y }, { box.max.x, box.max.y } }),
+            boost::make_function_output_iterator([&](const auto& val){
+                shapes.push_back(val.second);
+            }));
+    });
+    std::sort(shapes.begin(), shapes.end());
+    shapes.erase(std::unique(shapes.begin(), shapes.end()), shapes.end());
+
+    for (const auto& id : shapes) {
+        shapeAnnotations.at(id)->updateTileData(tileID, *tileData);
     }
 
     return tileData;
@@ -187,12 +343,22 @@ void AnnotationManager::updateStyle() {
 
 void AnnotationManager::updateData() {
     std::lock_guard<std::mutex> lock(mutex);
-    if (dirty) {
-        for (auto& tile : tiles) {
+    if (dirtyRegions.empty()) {
+        return;
+    }
+
+    for (auto& tile : tiles) {
+        bool dirty = false;
+        forEachWrap(tileBounds(tile->id.canonical), [&] (const Box& bounds) {
+            dirty = dirty || std::any_of(dirtyRegions.begin(), dirtyRegions.end(), [&] (const Box& region) {
+                return intersects(bounds, region);
+            });
+        });
+        if (dirty) {
             tile->setData(getTileData(tile->id.canonical));
         }
-        dirty = false;
     }
+    dirtyRegions.clear();
 }
 
 void AnnotationManager::addTile(AnnotationTile& tile) {
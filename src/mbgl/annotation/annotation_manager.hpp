@@ -4,6 +4,9 @@
 #include <mbgl/annotation/symbol_annotation_impl.hpp>
 #include <mbgl/style/image.hpp>
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <mapbox/geometry/box.hpp>
 
 #include <mutex>
 #include <string>
@@ -32,6 +35,12 @@ public:
     bool updateAnnotation(const AnnotationID&, const Annotation&, const uint8_t maxZoom);
     void removeAnnotation(const AnnotationID&);
 
+    // Bulk variants of the above. The whole batch is applied under a single lock, and
+    // the tiles it touches are regenerated once.
+    AnnotationIDs addAnnotations(const std::vector<Annotation>&, const uint8_t maxZoom);
+    bool updateAnnotations(const std::vector<std::pair<AnnotationID, Annotation>>&, const uint8_t maxZoom);
+    void removeAnnotations(const AnnotationIDs&);
+
     void addImage(std::unique_ptr<style::Image>);
     void removeImage(const std::string&);
     double getTopOffsetPixelsForImage(const std::string&);
@@ -49,6 +58,16 @@ public:
     static const std::string ShapeLayerID;
 
 private:
+    using SymbolAnnotationTree = boost::geometry::index::rtree<std::shared_ptr<const SymbolAnnotationImpl>, boost::geometry::index::rstar<16, 4>>;
+    // Unlike std::unordered_map, std::map is guaranteed to sort by AnnotationID, ensuring that older annotations are below newer annotations.
+    // <https://github.com/mapbox/mapbox-gl-native/issues/5691>
+    using SymbolAnnotationMap = std::map<AnnotationID, std::shared_ptr<SymbolAnnotationImpl>>;
+    using ShapeAnnotationMap = std::map<AnnotationID, std::unique_ptr<ShapeAnnotationImpl>>;
+    // Projected bounds of every shape, so that a tile only visits the shapes it intersects.
+    using ShapeAnnotationBox = boost::geometry::model::box<boost::geometry::model::point<double, 2, boost::geometry::cs::cartesian>>;
+    using ShapeAnnotationTree = boost::geometry::index::rtree<std::pair<ShapeAnnotationBox, AnnotationID>, boost::geometry::index::rstar<16, 4>>;
+    using ImageMap = std::unordered_map<std::string, style::Image>;
+
     void add(const AnnotationID&, const SymbolAnnotation&, const uint8_t);
     void add(const AnnotationID&, const LineAnnotation&, const uint8_t);
     void add(const AnnotationID&, const FillAnnotation&, const uint8_t);
@@ -59,27 +78,53 @@ private:
 
     void remove(const AnnotationID&);
 
+    void insert(const ShapeAnnotationImpl&);
+    void erase(ShapeAnnotationMap::iterator);
+
+    // Starts a bulk operation, and ends it when going out of scope, so that an annotation
+    // that throws midway doesn't leave the manager in the middle of a batch.
+    class BatchScope {
+    public:
+        BatchScope(AnnotationManager&, std::size_t size);
+        ~BatchScope();
+
+    private:
+        AnnotationManager& manager;
+    };
+
+    void beginBatch(std::size_t size);
+    void endBatch();
+
     void updateStyle();
 
+    // Marks the tiles covering the given bounds, in projected world coordinates, for
+    // regeneration on the next call to updateData().
+    void invalidate(const mapbox::geometry::box<double>&);
+
     std::unique_ptr<AnnotationTileData> getTileData(const CanonicalTileID&);
 
     std::reference_wrapper<style::Style> style;
 
     std::mutex mutex;
 
-    bool dirty = false;
-    
-    AnnotationID nextID = 0;
+    // Regions that changed since the last updateData(). Only tiles intersecting one of
+    // them are regenerated.
+    std::vector<mapbox::geometry::box<double>> dirtyRegions;
 
-    using SymbolAnnotationTree = boost::geometry::index::rtree<std::shared_ptr<const SymbolAnnotationImpl>, boost::geometry::index::rstar<16, 4>>;
-    // Unlike std::unordered_map, std::map is guaranteed to sort by AnnotationID, ensuring that older annotations are below newer annotations.
-    // <https://github.com/mapbox/mapbox-gl-native/issues/5691>
-    using SymbolAnnotationMap = std::map<AnnotationID, std::shared_ptr<SymbolAnnotationImpl>>;
-    using ShapeAnnotationMap = std::map<AnnotationID, std::unique_ptr<ShapeAnnotationImpl>>;
-    using ImageMap = std::unordered_map<std::string, style::Image>;
+    // Set during a bulk operation. If the batch is large compared to the existing symbols,
+    // the symbol tree is rebuilt from scratch at the end instead of being updated one symbol
+    // at a time.
+    struct Batch {
+        bool packSymbols;
+        bool symbolsChanged;
+    };
+    optional<Batch> batch;
+
+    AnnotationID nextID = 0;
 
     SymbolAnnotationTree symbolTree;
     SymbolAnnotationMap symbolAnnotations;
+    ShapeAnnotationTree shapeTree;
     ShapeAnnotationMap shapeAnnotations;
     ImageMap images;
 
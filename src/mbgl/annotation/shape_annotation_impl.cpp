@@ -7,6 +7,12 @@
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/geometry.hpp>
+#include <mbgl/util/projection.hpp>
+
+#include <mapbox/geometry/for_each_point.hpp>
+
+#include <cmath>
+#include <limits>
 
 namespace mbgl {
 
@@ -29,7 +35,7 @@ void ShapeAnnotationImpl::updateTileData(const CanonicalTileID& tileID, Annotati
         }));
         mapbox::geojsonvt::Options options;
         options.maxZoom = maxZoom;
-        options.buffer = 255u;
+        options.buffer = tileBuffer;
         options.extent = util::EXTENT;
         options.tolerance = baseTolerance;
         shapeTiler = std::make_unique<mapbox::geojsonvt::GeoJSONVT>(features, options);
@@ -58,4 +64,23 @@ void ShapeAnnotationImpl::updateTileData(const CanonicalTileID& tileID, Annotati
     }
 }
 
+mapbox::geometry::box<double> ShapeAnnotationImpl::projectedBounds() const {
+    const double infinity = std::numeric_limits<double>::infinity();
+    mapbox::geometry::box<double> bounds { { infinity, infinity }, { -infinity, -infinity } };
+    ShapeAnnotationGeometry::visit(geometry(), [&] (const auto& geom) {
+        mapbox::geometry::for_each_point(geom, [&] (const Point<double>& point) {
+            if (!std::isfinite(point.x) || !std::isfinite(point.y)) {
+                return;
+            }
+            const LatLng latLng { util::clamp(point.y, -util::LATITUDE_MAX, util::LATITUDE_MAX), point.x };
+            const Point<double> projected = Projection::project(latLng, 1.0 / util::tileSize);
+            bounds.min.x = std::min(bounds.min.x, projected.x);
+            bounds.min.y = std::min(bounds.min.y, projected.y);
+            bounds.max.x = std::max(bounds.max.x, projected.x);
+            bounds.max.y = std::max(bounds.max.y, projected.y);
+        });
+    });
+    return bounds;
+}
+
 } // namespace mbgl
@@ -25,6 +25,13 @@ public:
 
     void updateTileData(const CanonicalTileID&, AnnotationTileData&);
 
+    // Bounds of the geometry in the unit square of the projected world, the same
+    // space the shape tiler works in. Not wrapped; x may leave [0, 1].
+    mapbox::geometry::box<double> projectedBounds() const;
+
+    // Buffer around each tile of shape data, in tile units.
+    static constexpr uint16_t tileBuffer = 255;
+
     const AnnotationID id;
     const uint8_t maxZoom;
     const std::string layerID;
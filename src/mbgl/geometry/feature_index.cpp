@@ -21,10 +21,14 @@ FeatureIndex::FeatureIndex()
     : grid(util::EXTENT, 16, 0) {
 }
 
+StringIdentity FeatureIndex::intern(const std::string& name) {
+    return strings.get(name);
+}
+
 void FeatureIndex::insert(const GeometryCollection& geometries,
                           std::size_t index,
-                          const std::string& sourceLayerName,
-                          const std::string& bucketName) {
+                          StringIdentity sourceLayerName,
+                          StringIdentity bucketName) {
     for (const auto& ring : geometries) {
         grid.insert(IndexedSubfeature { index, sourceLayerName, bucketName, sortIndex++ },
                     mapbox::geometry::envelope(ring));
@@ -56,20 +60,33 @@ void FeatureIndex::query(
     const float pixelsToTileUnits = util::EXTENT / tileSize / scale;
     const int16_t additionalRadius = std::min<int16_t>(util::EXTENT, additionalQueryRadius * pixelsToTileUnits);
 
-    // Query the grid index
+    // Query the grid index. Matches are referenced in place rather than copied.
     mapbox::geometry::box<int16_t> box = mapbox::geometry::envelope(queryGeometry);
-    std::vector<IndexedSubfeature> features = grid.query({ box.min - additionalRadius, box.max + additionalRadius });
 
+    std::unordered_map<std::string, const RenderLayer*> layersByID;
+    layersByID.reserve(layers.size());
+    for (const RenderLayer* layer : layers) {
+        layersByID.emplace(layer->getID(), layer);
+    }
+
+    SourceLayers sourceLayers;
+
+    std::vector<const IndexedSubfeature*> features;
+    grid.query({ box.min - additionalRadius, box.max + additionalRadius }, [&] (const IndexedSubfeature& feature, const auto&) {
+        features.push_back(&feature);
+    });
 
-    std::sort(features.begin(), features.end(), topDown);
+    std::sort(features.begin(), features.end(), [] (const IndexedSubfeature* a, const IndexedSubfeature* b) {
+        return topDown(*a, *b);
+    });
     size_t previousSortIndex = std::numeric_limits<size_t>::max();
     for (const auto& indexedFeature : features) {
 
         // If this feature is the same as the previous feature, skip it.
-        if (indexedFeature.sortIndex == previousSortIndex) continue;
-        previousSortIndex = indexedFeature.sortIndex;
+        if (indexedFeature->sortIndex == previousSortIndex) continue;
+        previousSortIndex = indexedFeature->sortIndex;
 
-        addFeature(result, indexedFeature, queryGeometry, queryOptions, geometryTileData, tileID, layers, bearing, pixelsToTileUnits);
+        addFeature(result, *indexedFeature, queryGeometry, queryOptions, geometryTileData, sourceLayers, tileID, layersByID, bearing, pixelsToTileUnits);
     }
 
     // Query symbol features, if they've been placed.
@@ -80,7 +97,7 @@ void FeatureIndex::query(
     std::vector<IndexedSubfeature> symbolFeatures = collisionTile->queryRenderedSymbols(queryGeometry, scale);
     std::sort(symbolFeatures.begin(), symbolFeatures.end(), topDownSymbols);
     for (const auto& symbolFeature : symbolFeatures) {
-        addFeature(result, symbolFeature, queryGeometry, queryOptions, geometryTileData, tileID, layers, bearing, pixelsToTileUnits);
+        addFeature(result, symbolFeature, queryGeometry, queryOptions, geometryTileData, sourceLayers, tileID, layersByID, bearing, pixelsToTileUnits);
     }
 }
 
@@ -90,32 +107,24 @@ void FeatureIndex::addFeature(
     const GeometryCoordinates& queryGeometry,
     const RenderedQueryOptions& options,
     const GeometryTileData& geometryTileData,
+    SourceLayers& sourceLayers,
     const CanonicalTileID& tileID,
-    const std::vector<const RenderLayer*>& layers,
+    const std::unordered_map<std::string, const RenderLayer*>& layers,
     const float bearing,
     const float pixelsToTileUnits) const {
 
-    auto getRenderLayer = [&] (const std::string& layerID) -> const RenderLayer* {
-        for (const auto& layer : layers) {
-            if (layer->getID() == layerID) {
-                return layer;
-            }
-        }
-        return nullptr;
-    };
-
     // Lazily calculated.
-    std::unique_ptr<GeometryTileLayer> sourceLayer;
     std::unique_ptr<GeometryTileFeature> geometryTileFeature;
 
     for (const std::string& layerID : bucketLayerIDs.at(indexedFeature.bucketName)) {
-        const RenderLayer* renderLayer = getRenderLayer(layerID);
-        if (!renderLayer) {
+        auto it = layers.find(layerID);
+        if (it == layers.end()) {
             continue;
         }
+        const RenderLayer* renderLayer = it->second;
 
         if (!geometryTileFeature) {
-            sourceLayer = geometryTileData.getLayer(indexedFeature.sourceLayerName);
+            const GeometryTileLayer* sourceLayer = getSourceLayer(geometryTileData, sourceLayers, indexedFeature.sourceLayerName);
             assert(sourceLayer);
 
             geometryTileFeature = sourceLayer->getFeature(indexedFeature.index);
@@ -135,6 +144,16 @@ void FeatureIndex::addFeature(
     }
 }
 
+const GeometryTileLayer* FeatureIndex::getSourceLayer(const GeometryTileData& geometryTileData,
+                                                     SourceLayers& sourceLayers,
+                                                     StringIdentity sourceLayerName) const {
+    auto it = sourceLayers.find(sourceLayerName);
+    if (it == sourceLayers.end()) {
+        it = sourceLayers.emplace(sourceLayerName, geometryTileData.getLayer(strings.get(sourceLayerName))).first;
+    }
+    return it->second.get();
+}
+
 optional<GeometryCoordinates> FeatureIndex::translateQueryGeometry(
         const GeometryCoordinates& queryGeometry,
         const std::array<float, 2>& translate,
@@ -158,7 +177,7 @@ optional<GeometryCoordinates> FeatureIndex::translateQueryGeometry(
 }
 
 void FeatureIndex::setBucketLayerIDs(const std::string& bucketName, const std::vector<std::string>& layerIDs) {
-    bucketLayerIDs[bucketName] = layerIDs;
+    bucketLayerIDs[strings.get(bucketName)] = layerIDs;
 }
 
 } // namespace mbgl
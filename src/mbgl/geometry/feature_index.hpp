@@ -4,7 +4,9 @@
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/util/grid_index.hpp>
 #include <mbgl/util/feature.hpp>
+#include <mbgl/util/string_indexer.hpp>
 
+#include <memory>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -20,9 +22,14 @@ class CanonicalTileID;
 class IndexedSubfeature {
 public:
     IndexedSubfeature() = delete;
+    IndexedSubfeature(std::size_t index_, StringIdentity sourceLayerName_, StringIdentity bucketName_, size_t sortIndex_)
+        : index(index_), sourceLayerName(sourceLayerName_), bucketName(bucketName_), sortIndex(sortIndex_) {}
+
     std::size_t index;
-    std::string sourceLayerName;
-    std::string bucketName;
+    // Names are interned in the FeatureIndex of the tile, since every subfeature of a layer
+    // shares the same pair.
+    StringIdentity sourceLayerName;
+    StringIdentity bucketName;
     size_t sortIndex;
 };
 
@@ -30,7 +37,11 @@ class FeatureIndex {
 public:
     FeatureIndex();
 
-    void insert(const GeometryCollection&, std::size_t index, const std::string& sourceLayerName, const std::string& bucketName);
+    // Returns the identity of a source layer or bucket name in this index. Intern names once
+    // per layer, and insert all of its features with the identities.
+    StringIdentity intern(const std::string&);
+
+    void insert(const GeometryCollection&, std::size_t index, StringIdentity sourceLayerName, StringIdentity bucketName);
 
     void query(
             std::unordered_map<std::string, std::vector<Feature>>& result,
@@ -55,20 +66,31 @@ public:
     void setBucketLayerIDs(const std::string& bucketName, const std::vector<std::string>& layerIDs);
 
 private:
+    // Source layers parsed during a single query, by name. Parsing a layer decodes its entire
+    // key and value tables, so it is done at most once per layer rather than once per candidate.
+    using SourceLayers = std::unordered_map<StringIdentity, std::unique_ptr<GeometryTileLayer>>;
+
     void addFeature(
             std::unordered_map<std::string, std::vector<Feature>>& result,
             const IndexedSubfeature&,
             const GeometryCoordinates& queryGeometry,
             const RenderedQueryOptions& options,
             const GeometryTileData&,
+            SourceLayers&,
             const CanonicalTileID&,
-            const std::vector<const RenderLayer*>&,
+            const std::unordered_map<std::string, const RenderLayer*>&,
             const float bearing,
             const float pixelsToTileUnits) const;
 
+    const GeometryTileLayer* getSourceLayer(const GeometryTileData&, SourceLayers&, StringIdentity sourceLayerName) const;
+
     GridIndex<IndexedSubfeature> grid;
     unsigned int sortIndex = 0;
 
-    std::unordered_map<std::string, std::vector<std::string>> bucketLayerIDs;
+    StringIndexer strings;
+
+    std::unordered_map<StringIdentity, std::vector<std::string>> bucketLayerIDs;
+
+    friend class TileSnapshot;
 };
 } // namespace mbgl
@@ -0,0 +1,102 @@
+#include <mbgl/geometry/polygon_tessellator.hpp>
+
+#include <mapbox/earcut.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mapbox {
+namespace util {
+template <> struct nth<0, mbgl::GeometryCoordinate> {
+    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.x; };
+};
+
+template <> struct nth<1, mbgl::GeometryCoordinate> {
+    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.y; };
+};
+} // namespace util
+} // namespace mapbox
+
+namespace mbgl {
+
+class PolygonTessellator::Impl {
+public:
+    mapbox::detail::Earcut<uint32_t> earcut;
+};
+
+PolygonTessellator::PolygonTessellator()
+    : impl(std::make_unique<Impl>()) {
+}
+
+PolygonTessellator::~PolygonTessellator() = default;
+
+PolygonTessellator::Polygon& PolygonTessellator::addPolygon() {
+    if (spare.empty()) {
+        polygons.emplace_back();
+    } else {
+        polygons.push_back(std::move(spare.back()));
+        spare.pop_back();
+        polygons.back().clear();
+    }
+    return polygons.back();
+}
+
+const std::vector<PolygonTessellator::Polygon>& PolygonTessellator::classifyRings(const GeometryCollection& rings,
+                                                                                  const uint32_t maxHoles) {
+    while (!polygons.empty()) {
+        spare.push_back(std::move(polygons.back()));
+        polygons.pop_back();
+    }
+
+    const std::size_t len = rings.size();
+
+    if (len <= 1) {
+        Polygon& polygon = addPolygon();
+        for (const auto& ring : rings) {
+            polygon.emplace_back(ring, signedArea(ring));
+        }
+        return polygons;
+    }
+
+    Polygon* polygon = nullptr;
+    int8_t ccw = 0;
+
+    for (const auto& ring : rings) {
+        const double area = signedArea(ring);
+
+        if (area == 0)
+            continue;
+
+        if (ccw == 0)
+            ccw = (area < 0 ? -1 : 1);
+
+        if (!polygon || ccw == (area < 0 ? -1 : 1)) {
+            polygon = &addPolygon();
+        }
+
+        polygon->emplace_back(ring, area);
+    }
+
+    // Keep the largest holes, as limitHoles() does. Areas were computed above, so the
+    // comparisons don't walk the rings again.
+    for (auto& p : polygons) {
+        if (p.size() > 1 + maxHoles) {
+            std::nth_element(p.begin() + 1,
+                             p.begin() + 1 + maxHoles,
+                             p.end(),
+                             [] (const Ring& a, const Ring& b) {
+                                 return std::fabs(a.area) > std::fabs(b.area);
+                             });
+            p.erase(p.begin() + 1 + maxHoles, p.end());
+        }
+    }
+
+    return polygons;
+}
+
+const std::vector<uint32_t>& PolygonTessellator::tessellate(const Polygon& polygon) {
+    impl->earcut(polygon);
+    return impl->earcut.indices;
+}
+
+} // namespace mbgl
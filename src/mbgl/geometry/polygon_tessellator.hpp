@@ -0,0 +1,67 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    Groups the rings of polygon features into polygons and triangulates them with earcut.
+
+    A tessellator refers to the rings of the geometry it is given instead of copying them, and
+    keeps all of its buffers, including earcut's, from one call to the next. A layout pass that
+    uses one tessellator for all of its features stops allocating once those buffers have grown
+    to fit its largest polygon.
+*/
+class PolygonTessellator : private util::noncopyable {
+public:
+    class Ring {
+    public:
+        using value_type = GeometryCoordinate;
+
+        Ring(const GeometryCoordinates& coordinates_, double area_)
+            : coordinates(&coordinates_), area(area_) {}
+
+        std::size_t size() const { return coordinates->size(); }
+        bool empty() const { return coordinates->empty(); }
+        const GeometryCoordinate& operator[](std::size_t i) const { return (*coordinates)[i]; }
+        GeometryCoordinates::const_iterator begin() const { return coordinates->begin(); }
+        GeometryCoordinates::const_iterator end() const { return coordinates->end(); }
+
+    private:
+        friend class PolygonTessellator;
+
+        const GeometryCoordinates* coordinates;
+        double area;
+    };
+
+    // An outer ring followed by its holes.
+    using Polygon = std::vector<Ring>;
+
+    PolygonTessellator();
+    ~PolygonTessellator();
+
+    // Equivalent to classifyRings() followed by limitHoles() on every polygon. The polygons
+    // refer to `rings`, and are valid until the next call.
+    const std::vector<Polygon>& classifyRings(const GeometryCollection& rings, uint32_t maxHoles);
+
+    // Triangulates a polygon. The indices refer to the polygon's coordinates in ring order, and
+    // are valid until the next call.
+    const std::vector<uint32_t>& tessellate(const Polygon&);
+
+private:
+    Polygon& addPolygon();
+
+    std::vector<Polygon> polygons;
+    // Polygons left over from earlier calls, kept for the capacity of their ring vectors.
+    std::vector<Polygon> spare;
+
+    class Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace mbgl
@@ -58,8 +58,13 @@ static_assert(std::is_same<RenderbufferID, GLuint>::value, "OpenGL type mismatch
 
 static_assert(std::is_same<std::underlying_type_t<TextureFormat>, GLenum>::value, "OpenGL type mismatch");
 static_assert(underlying_type(TextureFormat::RGBA) == GL_RGBA, "OpenGL type mismatch");
+static_assert(underlying_type(TextureFormat::RGB) == GL_RGB, "OpenGL type mismatch");
 static_assert(underlying_type(TextureFormat::Alpha) == GL_ALPHA, "OpenGL type mismatch");
 
+static_assert(std::is_same<std::underlying_type_t<TextureType>, GLenum>::value, "OpenGL type mismatch");
+static_assert(underlying_type(TextureType::UnsignedByte) == GL_UNSIGNED_BYTE, "OpenGL type mismatch");
+static_assert(underlying_type(TextureType::UnsignedShort565) == GL_UNSIGNED_SHORT_5_6_5, "OpenGL type mismatch");
+
 static_assert(underlying_type(UniformDataType::Float) == GL_FLOAT, "OpenGL type mismatch");
 static_assert(underlying_type(UniformDataType::FloatVec2) == GL_FLOAT_VEC2, "OpenGL type mismatch");
 static_assert(underlying_type(UniformDataType::FloatVec3) == GL_FLOAT_VEC3, "OpenGL type mismatch");
@@ -221,9 +226,9 @@ UniqueBuffer Context::createVertexBuffer(const void* data, std::size_t size, con
     return result;
 }
 
-void Context::updateVertexBuffer(UniqueBuffer& buffer, const void* data, std::size_t size) {
+void Context::updateVertexBuffer(UniqueBuffer& buffer, const void* data, std::size_t size, std::size_t offset) {
     vertexBuffer = buffer;
-    MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
+    MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
 }
 
 UniqueBuffer Context::createIndexBuffer(const void* data, std::size_t size) {
@@ -478,10 +483,10 @@ Context::createFramebuffer(const Texture& color,
 }
 
 UniqueTexture
-Context::createTexture(const Size size, const void* data, TextureFormat format, TextureUnit unit) {
+Context::createTexture(const Size size, const void* data, TextureFormat format, TextureUnit unit, TextureType type) {
     auto obj = createTexture();
     pixelStoreUnpack = { 1 };
-    updateTexture(obj, size, data, format, unit);
+    updateTexture(obj, size, data, format, unit, type);
     // We are using clamp to edge here since OpenGL ES doesn't allow GL_REPEAT on NPOT textures.
     // We use those when the pixelRatio isn't a power of two, e.g. on iPhone 6 Plus.
     MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
@@ -492,14 +497,28 @@ Context::createTexture(const Size size, const void* data, TextureFormat format,
 }
 
 void Context::updateTexture(
-    TextureID id, const Size size, const void* data, TextureFormat format, TextureUnit unit) {
+    TextureID id, const Size size, const void* data, TextureFormat format, TextureUnit unit, TextureType type) {
     activeTextureUnit = unit;
     texture[unit] = id;
     MBGL_CHECK_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLenum>(format), size.width,
-                                  size.height, 0, static_cast<GLenum>(format), GL_UNSIGNED_BYTE,
+                                  size.height, 0, static_cast<GLenum>(format), static_cast<GLenum>(type),
                                   data));
 }
 
+void Context::updateTextureRows(TextureID id,
+                                const uint32_t width,
+                                const uint32_t y,
+                                const uint32_t height,
+                                const void* data,
+                                TextureFormat format,
+                                TextureUnit unit) {
+    activeTextureUnit = unit;
+    texture[unit] = id;
+    pixelStoreUnpack = { 1 };
+    MBGL_CHECK_ERROR(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, width, height,
+                                     static_cast<GLenum>(format), GL_UNSIGNED_BYTE, data));
+}
+
 void Context::bindTexture(Texture& obj,
                           TextureUnit unit,
                           TextureFilter filter,
@@ -686,6 +705,7 @@ void Context::setColorMode(const ColorMode& color) {
 void Context::draw(PrimitiveType primitiveType,
                    std::size_t indexOffset,
                    std::size_t indexLength) {
+    drawCalls++;
     MBGL_CHECK_ERROR(glDrawElements(
         static_cast<GLenum>(primitiveType),
         static_cast<GLsizei>(indexLength),
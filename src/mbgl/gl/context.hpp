@@ -74,6 +74,16 @@ public:
         updateVertexBuffer(buffer.buffer, v.data(), v.byteSize());
     }
 
+    // Rewrites the vertices in [start, end) from the same range of `v`, which must be as
+    // long as the buffer.
+    template <class Vertex, class DrawMode>
+    void updateVertexBuffer(VertexBuffer<Vertex, DrawMode>& buffer, const VertexVector<Vertex, DrawMode>& v,
+                            std::size_t start, std::size_t end) {
+        assert(v.vertexSize() == buffer.vertexCount);
+        assert(start <= end && end <= v.vertexSize());
+        updateVertexBuffer(buffer.buffer, v.data() + start, (end - start) * sizeof(Vertex), start * sizeof(Vertex));
+    }
+
     template <class DrawMode>
     IndexBuffer<DrawMode> createIndexBuffer(IndexVector<DrawMode>&& v) {
         return IndexBuffer<DrawMode> {
@@ -130,6 +140,16 @@ public:
         obj.size = image.size;
     }
 
+    // Replaces the rows [y, y + height) of a texture with the same rows of an image of
+    // the same size. Full rows are contiguous in memory, which keeps this within GLES2.
+    template <typename Image>
+    void updateTextureRows(Texture& obj, const Image& image, uint32_t y, uint32_t height, TextureUnit unit = 0) {
+        assert(obj.size == image.size && y + height <= image.size.height);
+        auto format = image.channels == 4 ? TextureFormat::RGBA : TextureFormat::Alpha;
+        updateTextureRows(obj.texture.get(), image.size.width, y, height,
+                          image.data.get() + image.stride() * y, format, unit);
+    }
+
     // Creates an empty texture with the specified dimensions.
     Texture createTexture(const Size size,
                           TextureFormat format = TextureFormat::RGBA,
@@ -137,6 +157,15 @@ public:
         return { size, createTexture(size, nullptr, format, unit) };
     }
 
+    // Create a texture from raw pixel data of the given format and component type.
+    Texture createTexture(const Size size,
+                          const void* data,
+                          TextureFormat format,
+                          TextureType type,
+                          TextureUnit unit = 0) {
+        return { size, createTexture(size, data, format, unit, type) };
+    }
+
     void bindTexture(Texture&,
                      TextureUnit = 0,
                      TextureFilter = TextureFilter::Nearest,
@@ -162,6 +191,15 @@ public:
               std::size_t indexOffset,
               std::size_t indexLength);
 
+    // Number of draw() calls since the last resetDrawCalls(); used for frame statistics.
+    std::size_t getDrawCalls() const {
+        return drawCalls;
+    }
+
+    void resetDrawCalls() {
+        drawCalls = 0;
+    }
+
     // Actually remove the objects we marked as abandoned with the above methods.
     // Only call this while the OpenGL context is exclusive to this thread.
     void performCleanup();
@@ -196,6 +234,7 @@ public:
 
 private:
     bool cleanupOnDestruction = true;
+    std::size_t drawCalls = 0;
 
     std::unique_ptr<extension::Debugging> debugging;
     std::unique_ptr<extension::VertexArray> vertexArray;
@@ -249,10 +288,13 @@ private:
 #endif // MBGL_USE_GLES2
 
     UniqueBuffer createVertexBuffer(const void* data, std::size_t size, const BufferUsage usage);
-    void updateVertexBuffer(UniqueBuffer& buffer, const void* data, std::size_t size);
+    void updateVertexBuffer(UniqueBuffer& buffer, const void* data, std::size_t size, std::size_t offset = 0);
     UniqueBuffer createIndexBuffer(const void* data, std::size_t size);
-    UniqueTexture createTexture(Size size, const void* data, TextureFormat, TextureUnit);
-    void updateTexture(TextureID, Size size, const void* data, TextureFormat, TextureUnit);
+    UniqueTexture createTexture(Size size, const void* data, TextureFormat, TextureUnit,
+                                TextureType = TextureType::UnsignedByte);
+    void updateTexture(TextureID, Size size, const void* data, TextureFormat, TextureUnit,
+                       TextureType = TextureType::UnsignedByte);
+    void updateTextureRows(TextureID, uint32_t width, uint32_t y, uint32_t height, const void* data, TextureFormat, TextureUnit);
     UniqueFramebuffer createFramebuffer();
     UniqueRenderbuffer createRenderbuffer(RenderbufferType, Size size);
     std::unique_ptr<uint8_t[]> readFramebuffer(Size, TextureFormat, bool flip);
@@ -28,6 +28,9 @@ public:
     const uint16_t* data() const { return v.data(); }
     const std::vector<uint16_t>& vector() const { return v; }
 
+    // Replaces the contents wholesale, e.g. with previously laid out indices.
+    void assign(std::vector<uint16_t> indices) { v = std::move(indices); }
+
 private:
     std::vector<uint16_t> v;
 };
@@ -57,6 +57,7 @@ enum class TextureFilter : bool { Nearest = false, Linear = true };
 enum class TextureWrap : bool { Clamp, Repeat };
 enum class TextureFormat : uint32_t {
     RGBA = 0x1908,
+    RGB = 0x1907,
     Alpha = 0x1906,
 #if not MBGL_USE_GLES2
     Stencil = 0x1901,
@@ -64,6 +65,11 @@ enum class TextureFormat : uint32_t {
 #endif // MBGL_USE_GLES2
 };
 
+enum class TextureType : uint32_t {
+    UnsignedByte = 0x1401,
+    UnsignedShort565 = 0x8363,
+};
+
 enum class PrimitiveType {
     Points = 0x0000,
     Lines = 0x0001,
@@ -5,6 +5,7 @@
 #include <mbgl/gl/draw_mode.hpp>
 #include <mbgl/util/ignore.hpp>
 
+#include <algorithm>
 #include <vector>
 
 namespace mbgl {
@@ -22,6 +23,20 @@ public:
         util::ignore({(v.emplace_back(std::forward<Args>(args)), 0)...});
     }
 
+    // Appends copies of `vertex` until the vector holds `length` vertices.
+    void resize(std::size_t length, const Vertex& vertex) {
+        static_assert(groupSize == 1, "wrong buffer element count");
+        v.resize(length, vertex);
+    }
+
+    void reserve(std::size_t length) { v.reserve(length); }
+
+    // Overwrites the vertices in [start, end) with copies of `vertex`.
+    void fill(std::size_t start, std::size_t end, const Vertex& vertex) {
+        static_assert(groupSize == 1, "wrong buffer element count");
+        std::fill(v.begin() + start, v.begin() + end, vertex);
+    }
+
     std::size_t vertexSize() const { return v.size(); }
     std::size_t byteSize() const { return v.size() * sizeof(Vertex); }
 
@@ -30,6 +45,9 @@ public:
     const Vertex* data() const { return v.data(); }
     const std::vector<Vertex>& vector() const { return v; }
 
+    // Replaces the contents wholesale, e.g. with previously laid out vertices.
+    void assign(std::vector<Vertex> vertices) { v = std::move(vertices); }
+
 private:
     std::vector<Vertex> v;
 };
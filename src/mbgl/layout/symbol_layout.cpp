@@ -41,10 +41,13 @@ static bool has(const style::SymbolLayoutProperties::PossiblyEvaluated& layout)
 SymbolLayout::SymbolLayout(const BucketParameters& parameters,
                            const std::vector<const RenderLayer*>& layers,
                            std::unique_ptr<GeometryTileLayer> sourceLayer_,
+                           const StringIdentity sourceLayerName_,
+                           const StringIdentity bucketName_,
                            ImageDependencies& imageDependencies,
                            GlyphDependencies& glyphDependencies)
     : sourceLayer(std::move(sourceLayer_)),
-      bucketName(layers.at(0)->getID()),
+      sourceLayerName(sourceLayerName_),
+      bucketName(bucketName_),
       overscaling(parameters.tileID.overscaleFactor()),
       zoom(parameters.tileID.overscaledZ),
       mode(parameters.mode),
@@ -98,6 +101,9 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
     }
 
     // Determine glyph dependencies
+    // The font's entry is looked up on first use rather than for every character.
+    GlyphIDs* fontGlyphDependencies = nullptr;
+
     const size_t featureCount = sourceLayer->featureCount();
     for (size_t i = 0; i < featureCount; ++i) {
         auto feature = sourceLayer->getFeature(i);
@@ -145,11 +151,14 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
                                          && util::i18n::allowsVerticalWritingMode(*ft.text);
 
             // Loop through all characters of this text and collect unique codepoints.
+            if (!fontGlyphDependencies && !ft.text->empty()) {
+                fontGlyphDependencies = &glyphDependencies[layout.get<TextFont>()];
+            }
             for (char16_t chr : *ft.text) {
-                glyphDependencies[layout.get<TextFont>()].insert(chr);
+                fontGlyphDependencies->insert(chr);
                 if (canVerticalizeText) {
                     if (char16_t verticalChr = util::i18n::verticalizePunctuation(chr)) {
-                        glyphDependencies[layout.get<TextFont>()].insert(verticalChr);
+                        fontGlyphDependencies->insert(verticalChr);
                     }
                 }
             }
@@ -160,7 +169,7 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
             if (layout.get<IconImage>().isConstant()) {
                 icon = util::replaceTokens(icon, getValue);
             }
-            ft.icon = icon;
+            ft.icon = std::move(icon);
             imageDependencies.insert(*ft.icon);
         }
 
@@ -292,7 +301,7 @@ void SymbolLayout::addFeature(const std::size_t index,
                                                   ? SymbolPlacementType::Point
                                                   : layout.get<SymbolPlacement>();
     const float textRepeatDistance = symbolSpacing / 2;
-    IndexedSubfeature indexedFeature = { feature.index, sourceLayer->getName(), bucketName,
+    IndexedSubfeature indexedFeature = { feature.index, sourceLayerName, bucketName,
                                          symbolInstances.size() };
 
     auto addSymbolInstance = [&] (const GeometryCoordinates& line, Anchor& anchor) {
@@ -427,6 +436,14 @@ std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile)
         });
     }
 
+    // Paint attributes are evaluated in bulk once all symbols are placed. The ranges also
+    // carry each feature's index in its source layer, so that properties depending on
+    // feature state can be re-evaluated for single features later.
+    std::vector<FeatureVertexRange> iconRanges;
+    std::vector<FeatureVertexRange> textRanges;
+    iconRanges.reserve(symbolInstances.size());
+    textRanges.reserve(symbolInstances.size());
+
     for (SymbolInstance &symbolInstance : symbolInstances) {
 
         const bool hasText = symbolInstance.hasText;
@@ -497,10 +514,13 @@ std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile)
             }
         }
         
-        for (auto& pair : bucket->paintPropertyBinders) {
-            pair.second.first.populateVertexVectors(feature, bucket->icon.vertices.vertexSize());
-            pair.second.second.populateVertexVectors(feature, bucket->text.vertices.vertexSize());
-        }
+        iconRanges.push_back({ &feature, feature.index, bucket->icon.vertices.vertexSize() });
+        textRanges.push_back({ &feature, feature.index, bucket->text.vertices.vertexSize() });
+    }
+
+    for (auto& pair : bucket->paintPropertyBinders) {
+        pair.second.first.populateVertexVectors(iconRanges);
+        pair.second.second.populateVertexVectors(textRanges);
     }
 
     if (collisionTile.config.debug) {
@@ -7,6 +7,7 @@
 #include <mbgl/text/bidi.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/programs/symbol_program.hpp>
+#include <mbgl/util/string_indexer.hpp>
 
 #include <memory>
 #include <map>
@@ -31,6 +32,8 @@ public:
     SymbolLayout(const BucketParameters&,
                  const std::vector<const RenderLayer*>&,
                  std::unique_ptr<GeometryTileLayer>,
+                 StringIdentity sourceLayerName,
+                 StringIdentity bucketName,
                  ImageDependencies&,
                  GlyphDependencies&);
 
@@ -70,7 +73,8 @@ private:
     // Stores the layer so that we can hold on to GeometryTileFeature instances in SymbolFeature,
     // which may reference data from this object.
     const std::unique_ptr<GeometryTileLayer> sourceLayer;
-    const std::string bucketName;
+    const StringIdentity sourceLayerName;
+    const StringIdentity bucketName;
     const float overscaling;
     const float zoom;
     const MapMode mode;
@@ -54,6 +54,26 @@ namespace mbgl {
 	 * Steps 3 and 4 are done in the shaders for all labels.
 	 */
 
+    LineLabelProjectionKey::LineLabelProjectionKey(const mat4& posMatrix_, const TransformState& state, const FrameHistory& frameHistory)
+        : posMatrix(posMatrix_),
+          zoom(state.getZoom()),
+          angle(state.getAngle()),
+          cameraToCenterDistance(state.getCameraToCenterDistance()),
+          width(state.getSize().width),
+          height(state.getSize().height),
+          visibilityVersion(frameHistory.getVisibilityVersion()) {
+    }
+
+    bool LineLabelProjectionKey::operator==(const LineLabelProjectionKey& other) const {
+        return posMatrix == other.posMatrix &&
+               zoom == other.zoom &&
+               angle == other.angle &&
+               cameraToCenterDistance == other.cameraToCenterDistance &&
+               width == other.width &&
+               height == other.height &&
+               visibilityVersion == other.visibilityVersion;
+    }
+
 	/*
 	 * Returns a matrix for converting from tile units to the correct label coordinate space.
 	 */
@@ -4,6 +4,8 @@
 #include <mbgl/gl/vertex_buffer.hpp>
 #include <mbgl/programs/symbol_program.hpp>
 
+#include <cstdint>
+
 namespace mbgl {
 
     class TransformState;
@@ -15,6 +17,25 @@ namespace mbgl {
         class SymbolPropertyValues;
     } // end namespace style
 
+    // Everything besides the bucket itself that the output of reprojectLineLabels() depends on.
+    // Labels only need to be reprojected when this changes.
+    class LineLabelProjectionKey {
+    public:
+        LineLabelProjectionKey(const mat4& posMatrix, const TransformState&, const FrameHistory&);
+
+        bool operator==(const LineLabelProjectionKey&) const;
+        bool operator!=(const LineLabelProjectionKey& other) const { return !(*this == other); }
+
+    private:
+        mat4 posMatrix;
+        double zoom;
+        float angle;
+        float cameraToCenterDistance;
+        uint32_t width;
+        uint32_t height;
+        uint64_t visibilityVersion;
+    };
+
     mat4 getLabelPlaneMatrix(const mat4& posMatrix, const bool pitchWithMap, const bool rotateWithMap, const TransformState& state, const float pixelsToTileUnits);
     mat4 getGlCoordMatrix(const mat4& posMatrix, const bool pitchWithMap, const bool rotateWithMap, const TransformState& state, const float pixelsToTileUnits);
 
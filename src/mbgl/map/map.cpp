@@ -82,6 +82,7 @@ public:
     bool cameraMutated = false;
 
     uint8_t prefetchZoomDelta = util::DEFAULT_PREFETCH_ZOOM_DELTA;
+    RasterTextureFormat rasterTextureFormat = RasterTextureFormat::RGBA;
 
     bool loading = false;
     bool rendererFullyLoaded;
@@ -692,6 +693,23 @@ void Map::removeAnnotation(AnnotationID annotation) {
     impl->onUpdate();
 }
 
+AnnotationIDs Map::addAnnotations(const std::vector<Annotation>& annotations) {
+    auto result = impl->annotationManager.addAnnotations(annotations, getMaxZoom());
+    impl->onUpdate();
+    return result;
+}
+
+void Map::updateAnnotations(const std::vector<std::pair<AnnotationID, Annotation>>& annotations) {
+    if (impl->annotationManager.updateAnnotations(annotations, getMaxZoom())) {
+        impl->onUpdate();
+    }
+}
+
+void Map::removeAnnotations(const AnnotationIDs& annotations) {
+    impl->annotationManager.removeAnnotations(annotations);
+    impl->onUpdate();
+}
+
 #pragma mark - Toggles
 
 void Map::setDebug(MapDebugOptions debugOptions) {
@@ -735,6 +753,18 @@ uint8_t Map::getPrefetchZoomDelta() const {
     return impl->prefetchZoomDelta;
 }
 
+void Map::setRasterTextureFormat(RasterTextureFormat format) {
+    if (impl->rasterTextureFormat == format) {
+        return;
+    }
+    impl->rasterTextureFormat = format;
+    impl->onUpdate();
+}
+
+RasterTextureFormat Map::getRasterTextureFormat() const {
+    return impl->rasterTextureFormat;
+}
+
 bool Map::isFullyLoaded() const {
     return impl->style->impl->isLoaded() && impl->rendererFullyLoaded;
 }
@@ -768,6 +798,7 @@ void Map::Impl::onUpdate() {
         style->impl->getLayerImpls(),
         annotationManager,
         prefetchZoomDelta,
+        rasterTextureFormat,
         bool(stillImageRequest)
     };
 
@@ -67,6 +67,10 @@ public:
             .concat(paintPropertyBinders.attributeBindings(currentProperties));
 
         for (auto& segment : segments) {
+            if (segment.indexLength == 0) {
+                continue;
+            }
+
             auto vertexArrayIt = segment.vertexArrays.find(layerID);
 
             if (vertexArrayIt == segment.vertexArrays.end()) {
@@ -2,8 +2,11 @@
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/renderer/feature_states.hpp>
 
 #include <atomic>
+#include <memory>
+#include <vector>
 
 namespace mbgl {
 
@@ -24,6 +27,23 @@ public:
     virtual void addFeature(const GeometryTileFeature&,
                             const GeometryCollection&) {};
 
+    // Adds a batch of features, with their geometries and their indices in the source
+    // layer at the same positions. Buckets with data-driven paint properties override
+    // this to evaluate each property over the whole batch at once rather than feature
+    // by feature.
+    virtual void addFeatures(const std::vector<std::unique_ptr<GeometryTileFeature>>& features,
+                             const std::vector<GeometryCollection>& geometries,
+                             const std::vector<std::size_t>& /* indices */) {
+        for (std::size_t i = 0; i < features.size(); i++) {
+            addFeature(*features[i], geometries[i]);
+        }
+    }
+
+    // Re-evaluates the paint properties that depend on feature state for the features in
+    // `changes`, which are looked up in the source layer the bucket was built from. Buckets
+    // whose paint vertices change are marked for upload; their layout buffers are kept.
+    virtual void setFeatureStates(const FeatureStateChanges&, const GeometryTileLayer&) {}
+
     // As long as this bucket has a Prepare render pass, this function is getting called. Typically,
     // this only happens once when the bucket is being rendered for the first time.
     virtual void upload(gl::Context&) = 0;
@@ -22,9 +22,19 @@ CircleBucket::CircleBucket(const BucketParameters& parameters, const std::vector
     }
 }
 
+void CircleBucket::setFeatureStates(const FeatureStateChanges& changes, const GeometryTileLayer& sourceLayer) {
+    for (auto& pair : paintPropertyBinders) {
+        if (pair.second.updateVertexVectors(changes, sourceLayer)) {
+            uploaded = false;
+        }
+    }
+}
+
 void CircleBucket::upload(gl::Context& context) {
-    vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    indexBuffer = context.createIndexBuffer(std::move(triangles));
+    if (!vertexBuffer) {
+        vertexBuffer = context.createVertexBuffer(std::move(vertices));
+        indexBuffer = context.createIndexBuffer(std::move(triangles));
+    }
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(context);
@@ -39,6 +49,29 @@ bool CircleBucket::hasData() const {
 
 void CircleBucket::addFeature(const GeometryTileFeature& feature,
                               const GeometryCollection& geometry) {
+    addGeometry(geometry);
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(feature, vertices.vertexSize());
+    }
+}
+
+void CircleBucket::addFeatures(const std::vector<std::unique_ptr<GeometryTileFeature>>& features,
+                               const std::vector<GeometryCollection>& geometries,
+                               const std::vector<std::size_t>& indices) {
+    std::vector<FeatureVertexRange> ranges;
+    ranges.reserve(features.size());
+    for (std::size_t i = 0; i < features.size(); i++) {
+        addGeometry(geometries[i]);
+        ranges.push_back({ features[i].get(), indices[i], vertices.vertexSize() });
+    }
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(ranges);
+    }
+}
+
+void CircleBucket::addGeometry(const GeometryCollection& geometry) {
     constexpr const uint16_t vertexLength = 4;
 
     for (auto& circle : geometry) {
@@ -84,10 +117,6 @@ void CircleBucket::addFeature(const GeometryTileFeature& feature,
             segment.indexLength += 6;
         }
     }
-
-    for (auto& pair : paintPropertyBinders) {
-        pair.second.populateVertexVectors(feature, vertices.vertexSize());
-    }
 }
 
 template <class Property>
@@ -19,6 +19,10 @@ public:
 
     void addFeature(const GeometryTileFeature&,
                     const GeometryCollection&) override;
+    void addFeatures(const std::vector<std::unique_ptr<GeometryTileFeature>>&,
+                     const std::vector<GeometryCollection>&,
+                     const std::vector<std::size_t>&) override;
+    void setFeatureStates(const FeatureStateChanges&, const GeometryTileLayer&) override;
     bool hasData() const override;
 
     void upload(gl::Context&) override;
@@ -35,6 +39,9 @@ public:
     std::map<std::string, CircleProgram::PaintPropertyBinders> paintPropertyBinders;
 
     const MapMode mode;
+
+private:
+    void addGeometry(const GeometryCollection&);
 };
 
 } // namespace mbgl
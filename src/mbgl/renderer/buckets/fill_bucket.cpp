@@ -3,24 +3,11 @@
 #include <mbgl/renderer/bucket_parameters.hpp>
 #include <mbgl/style/layers/fill_layer_impl.hpp>
 #include <mbgl/renderer/layers/render_fill_layer.hpp>
+#include <mbgl/geometry/polygon_tessellator.hpp>
 #include <mbgl/util/math.hpp>
 
-#include <mapbox/earcut.hpp>
-
 #include <cassert>
 
-namespace mapbox {
-namespace util {
-template <> struct nth<0, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.x; };
-};
-
-template <> struct nth<1, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.y; };
-};
-} // namespace util
-} // namespace mapbox
-
 namespace mbgl {
 
 using namespace style;
@@ -40,10 +27,33 @@ FillBucket::FillBucket(const BucketParameters& parameters, const std::vector<con
 
 void FillBucket::addFeature(const GeometryTileFeature& feature,
                             const GeometryCollection& geometry) {
-    for (auto& polygon : classifyRings(geometry)) {
-        // Optimize polygons with many interior rings for earcut tesselation.
-        limitHoles(polygon, 500);
+    PolygonTessellator tessellator;
+    addGeometry(geometry, tessellator);
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(feature, vertices.vertexSize());
+    }
+}
+
+void FillBucket::addFeatures(const std::vector<std::unique_ptr<GeometryTileFeature>>& features,
+                             const std::vector<GeometryCollection>& geometries,
+                             const std::vector<std::size_t>& indices) {
+    std::vector<FeatureVertexRange> ranges;
+    ranges.reserve(features.size());
+    PolygonTessellator tessellator;
+    for (std::size_t i = 0; i < features.size(); i++) {
+        addGeometry(geometries[i], tessellator);
+        ranges.push_back({ features[i].get(), indices[i], vertices.vertexSize() });
+    }
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(ranges);
+    }
+}
 
+void FillBucket::addGeometry(const GeometryCollection& geometry, PolygonTessellator& tessellator) {
+    // Optimize polygons with many interior rings for earcut tesselation.
+    for (const auto& polygon : tessellator.classifyRings(geometry, 500)) {
         std::size_t totalVertices = 0;
 
         for (const auto& ring : polygon) {
@@ -80,7 +90,7 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
             lineSegment.indexLength += nVertices * 2;
         }
 
-        std::vector<uint32_t> indices = mapbox::earcut(polygon);
+        const std::vector<uint32_t>& indices = tessellator.tessellate(polygon);
 
         std::size_t nIndicies = indices.size();
         assert(nIndicies % 3 == 0);
@@ -102,16 +112,22 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
         triangleSegment.vertexLength += totalVertices;
         triangleSegment.indexLength += nIndicies;
     }
+}
 
+void FillBucket::setFeatureStates(const FeatureStateChanges& changes, const GeometryTileLayer& sourceLayer) {
     for (auto& pair : paintPropertyBinders) {
-        pair.second.populateVertexVectors(feature, vertices.vertexSize());
+        if (pair.second.updateVertexVectors(changes, sourceLayer)) {
+            uploaded = false;
+        }
     }
 }
 
 void FillBucket::upload(gl::Context& context) {
-    vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    lineIndexBuffer = context.createIndexBuffer(std::move(lines));
-    triangleIndexBuffer = context.createIndexBuffer(std::move(triangles));
+    if (!vertexBuffer) {
+        vertexBuffer = context.createVertexBuffer(std::move(vertices));
+        lineIndexBuffer = context.createIndexBuffer(std::move(lines));
+        triangleIndexBuffer = context.createIndexBuffer(std::move(triangles));
+    }
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(context);
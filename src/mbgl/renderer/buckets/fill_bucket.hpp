@@ -13,6 +13,7 @@
 namespace mbgl {
 
 class BucketParameters;
+class PolygonTessellator;
 
 class FillBucket : public Bucket {
 public:
@@ -20,6 +21,10 @@ public:
 
     void addFeature(const GeometryTileFeature&,
                     const GeometryCollection&) override;
+    void addFeatures(const std::vector<std::unique_ptr<GeometryTileFeature>>&,
+                     const std::vector<GeometryCollection>&,
+                     const std::vector<std::size_t>&) override;
+    void setFeatureStates(const FeatureStateChanges&, const GeometryTileLayer&) override;
     bool hasData() const override;
 
     void upload(gl::Context&) override;
@@ -37,6 +42,9 @@ public:
     optional<gl::IndexBuffer<gl::Triangles>> triangleIndexBuffer;
 
     std::map<std::string, FillProgram::PaintPropertyBinders> paintPropertyBinders;
+
+private:
+    void addGeometry(const GeometryCollection&, PolygonTessellator&);
 };
 
 } // namespace mbgl
@@ -3,31 +3,12 @@
 #include <mbgl/renderer/bucket_parameters.hpp>
 #include <mbgl/style/layers/fill_extrusion_layer_impl.hpp>
 #include <mbgl/renderer/layers/render_fill_extrusion_layer.hpp>
+#include <mbgl/geometry/polygon_tessellator.hpp>
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/constants.hpp>
 
-#include <mapbox/earcut.hpp>
-
 #include <cassert>
 
-namespace mapbox {
-namespace util {
-template <>
-struct nth<0, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) {
-        return t.x;
-    };
-};
-
-template <>
-struct nth<1, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) {
-        return t.y;
-    };
-};
-} // namespace util
-} // namespace mapbox
-
 namespace mbgl {
 
 using namespace style;
@@ -46,10 +27,35 @@ FillExtrusionBucket::FillExtrusionBucket(const BucketParameters& parameters, con
 
 void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
                                      const GeometryCollection& geometry) {
-    for (auto& polygon : classifyRings(geometry)) {
-        // Optimize polygons with many interior rings for earcut tesselation.
-        limitHoles(polygon, 500);
+    PolygonTessellator tessellator;
+    addGeometry(geometry, tessellator);
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(feature, vertices.vertexSize());
+    }
+}
+
+void FillExtrusionBucket::addFeatures(const std::vector<std::unique_ptr<GeometryTileFeature>>& features,
+                                      const std::vector<GeometryCollection>& geometries,
+                                      const std::vector<std::size_t>& indices) {
+    std::vector<FeatureVertexRange> ranges;
+    ranges.reserve(features.size());
+    PolygonTessellator tessellator;
+    for (std::size_t i = 0; i < features.size(); i++) {
+        addGeometry(geometries[i], tessellator);
+        ranges.push_back({ features[i].get(), indices[i], vertices.vertexSize() });
+    }
 
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(ranges);
+    }
+}
+
+void FillExtrusionBucket::addGeometry(const GeometryCollection& geometry, PolygonTessellator& tessellator) {
+    std::vector<uint32_t> flatIndices;
+
+    // Optimize polygons with many interior rings for earcut tesselation.
+    for (const auto& polygon : tessellator.classifyRings(geometry, 500)) {
         std::size_t totalVertices = 0;
 
         for (const auto& ring : polygon) {
@@ -60,7 +66,7 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
 
         if (totalVertices == 0) continue;
 
-        std::vector<uint32_t> flatIndices;
+        flatIndices.clear();
         flatIndices.reserve(totalVertices);
 
         std::size_t startVertices = vertices.vertexSize();
@@ -123,7 +129,7 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
             }
         }
 
-        std::vector<uint32_t> indices = mapbox::earcut(polygon);
+        const std::vector<uint32_t>& indices = tessellator.tessellate(polygon);
 
         std::size_t nIndices = indices.size();
         assert(nIndices % 3 == 0);
@@ -136,15 +142,21 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
         triangleSegment.vertexLength += totalVertices;
         triangleSegment.indexLength += nIndices;
     }
+}
 
+void FillExtrusionBucket::setFeatureStates(const FeatureStateChanges& changes, const GeometryTileLayer& sourceLayer) {
     for (auto& pair : paintPropertyBinders) {
-        pair.second.populateVertexVectors(feature, vertices.vertexSize());
+        if (pair.second.updateVertexVectors(changes, sourceLayer)) {
+            uploaded = false;
+        }
     }
 }
 
 void FillExtrusionBucket::upload(gl::Context& context) {
-    vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    indexBuffer = context.createIndexBuffer(std::move(triangles));
+    if (!vertexBuffer) {
+        vertexBuffer = context.createVertexBuffer(std::move(vertices));
+        indexBuffer = context.createIndexBuffer(std::move(triangles));
+    }
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(context);
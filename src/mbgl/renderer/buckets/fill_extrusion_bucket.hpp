@@ -11,6 +11,7 @@
 namespace mbgl {
 
 class BucketParameters;
+class PolygonTessellator;
 
 class FillExtrusionBucket : public Bucket {
 public:
@@ -18,6 +19,10 @@ public:
 
     void addFeature(const GeometryTileFeature&,
                     const GeometryCollection&) override;
+    void addFeatures(const std::vector<std::unique_ptr<GeometryTileFeature>>&,
+                     const std::vector<GeometryCollection>&,
+                     const std::vector<std::size_t>&) override;
+    void setFeatureStates(const FeatureStateChanges&, const GeometryTileLayer&) override;
     bool hasData() const override;
 
     void upload(gl::Context&) override;
@@ -32,6 +37,9 @@ public:
     optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
     
     std::unordered_map<std::string, FillExtrusionProgram::PaintPropertyBinders> paintPropertyBinders;
+
+private:
+    void addGeometry(const GeometryCollection&, PolygonTessellator&);
 };
 
 } // namespace mbgl
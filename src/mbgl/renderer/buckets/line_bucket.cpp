@@ -38,6 +38,23 @@ void LineBucket::addFeature(const GeometryTileFeature& feature,
     }
 }
 
+void LineBucket::addFeatures(const std::vector<std::unique_ptr<GeometryTileFeature>>& features,
+                             const std::vector<GeometryCollection>& geometries,
+                             const std::vector<std::size_t>& indices) {
+    std::vector<FeatureVertexRange> ranges;
+    ranges.reserve(features.size());
+    for (std::size_t i = 0; i < features.size(); i++) {
+        for (auto& line : geometries[i]) {
+            addGeometry(line, *features[i]);
+        }
+        ranges.push_back({ features[i].get(), indices[i], vertices.vertexSize() });
+    }
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(ranges);
+    }
+}
+
 /*
  * Sharp corners cause dashed lines to tilt because the distance along the line
  * is the same at both the inner and outer corners. To improve the appearance of
@@ -450,9 +467,19 @@ void LineBucket::addPieSliceVertex(const GeometryCoordinate& currentVertex,
     }
 }
 
+void LineBucket::setFeatureStates(const FeatureStateChanges& changes, const GeometryTileLayer& sourceLayer) {
+    for (auto& pair : paintPropertyBinders) {
+        if (pair.second.updateVertexVectors(changes, sourceLayer)) {
+            uploaded = false;
+        }
+    }
+}
+
 void LineBucket::upload(gl::Context& context) {
-    vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    indexBuffer = context.createIndexBuffer(std::move(triangles));
+    if (!vertexBuffer) {
+        vertexBuffer = context.createVertexBuffer(std::move(vertices));
+        indexBuffer = context.createIndexBuffer(std::move(triangles));
+    }
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(context);
@@ -3,12 +3,63 @@
 #include <mbgl/programs/raster_program.hpp>
 #include <mbgl/gl/context.hpp>
 
+#include <cstring>
+
 namespace mbgl {
 
 using namespace style;
 
-RasterBucket::RasterBucket(PremultipliedImage&& image_) {
-    image = std::make_shared<PremultipliedImage>(std::move(image_));
+size_t PackedRasterImage::bytes() const {
+    const size_t pixelBytes = type == gl::TextureType::UnsignedShort565 ? 2 : 3;
+    return pixelBytes * size.width * size.height;
+}
+
+optional<PackedRasterImage> packRasterImage(const PremultipliedImage& image, RasterTextureFormat format) {
+    if (format == RasterTextureFormat::RGBA || !image.valid()) {
+        return {};
+    }
+
+    const uint8_t* src = image.data.get();
+    const size_t length = image.bytes();
+    for (size_t i = 3; i < length; i += 4) {
+        if (src[i] != 0xFF) {
+            return {};
+        }
+    }
+
+    // Opaque pixels are the same premultiplied or not, so the alpha channel can be dropped as is.
+    const size_t pixels = image.size.width * image.size.height;
+    if (format == RasterTextureFormat::RGB) {
+        PackedRasterImage packed { image.size, gl::TextureFormat::RGB, gl::TextureType::UnsignedByte,
+                                   std::make_unique<uint8_t[]>(pixels * 3) };
+        uint8_t* dst = packed.data.get();
+        for (size_t i = 0; i < pixels; ++i) {
+            dst[3 * i + 0] = src[4 * i + 0];
+            dst[3 * i + 1] = src[4 * i + 1];
+            dst[3 * i + 2] = src[4 * i + 2];
+        }
+        return { std::move(packed) };
+    }
+
+    assert(format == RasterTextureFormat::RGB565);
+    PackedRasterImage packed { image.size, gl::TextureFormat::RGB, gl::TextureType::UnsignedShort565,
+                               std::make_unique<uint8_t[]>(pixels * 2) };
+    uint8_t* dst = packed.data.get();
+    for (size_t i = 0; i < pixels; ++i) {
+        // GL reads each pixel as one native-endian 16 bit value.
+        const uint16_t pixel = ((src[4 * i + 0] * 31 + 127) / 255) << 11 |
+                               ((src[4 * i + 1] * 63 + 127) / 255) << 5 |
+                               ((src[4 * i + 2] * 31 + 127) / 255);
+        std::memcpy(dst + 2 * i, &pixel, sizeof(pixel));
+    }
+    return { std::move(packed) };
+}
+
+RasterBucket::RasterBucket(PremultipliedImage&& image_, RasterTextureFormat format) {
+    packedImage = packRasterImage(image_, format);
+    if (!packedImage) {
+        image = std::make_shared<PremultipliedImage>(std::move(image_));
+    }
 }
 
 RasterBucket::RasterBucket(std::shared_ptr<PremultipliedImage> image_): image(image_) {
@@ -20,7 +71,12 @@ void RasterBucket::upload(gl::Context& context) {
         return;
     }
     if (!texture) {
-        texture = context.createTexture(*image);
+        if (packedImage) {
+            texture = context.createTexture(packedImage->size, packedImage->data.get(),
+                                            packedImage->format, packedImage->type);
+        } else {
+            texture = context.createTexture(*image);
+        }
     }
     if (!segments.empty()) {
         vertexBuffer = context.createVertexBuffer(std::move(vertices));
@@ -41,6 +97,7 @@ void RasterBucket::clear() {
 
 void RasterBucket::setImage(std::shared_ptr<PremultipliedImage> image_) {
     image = std::move(image_);
+    packedImage = {};
     texture = {};
     uploaded = false;
 }
@@ -104,7 +161,14 @@ void RasterBucket::setMask(TileMask&& mask_) {
 }
 
 bool RasterBucket::hasData() const {
-    return !!image;
+    return image || packedImage;
+}
+
+size_t RasterBucket::getTextureBytes() const {
+    if (!texture) {
+        return 0;
+    }
+    return packedImage ? packedImage->bytes() : image->bytes();
 }
 
 } // namespace mbgl
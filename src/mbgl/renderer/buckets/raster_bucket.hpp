@@ -3,6 +3,7 @@
 #include <mbgl/gl/index_buffer.hpp>
 #include <mbgl/gl/texture.hpp>
 #include <mbgl/gl/vertex_buffer.hpp>
+#include <mbgl/map/mode.hpp>
 #include <mbgl/programs/raster_program.hpp>
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/renderer/tile_mask.hpp>
@@ -12,9 +13,24 @@
 
 namespace mbgl {
 
+// Pixel data of an opaque image, packed into a texture format that is smaller than RGBA.
+class PackedRasterImage {
+public:
+    size_t bytes() const;
+
+    Size size;
+    gl::TextureFormat format;
+    gl::TextureType type;
+    std::unique_ptr<uint8_t[]> data;
+};
+
+// Returns nothing if the image has any transparent pixels, or if the format is RGBA.
+optional<PackedRasterImage> packRasterImage(const PremultipliedImage&, RasterTextureFormat);
+
 class RasterBucket : public Bucket {
 public:
-    RasterBucket(PremultipliedImage&&);
+    // Opaque images are packed into the given texture format.
+    RasterBucket(PremultipliedImage&&, RasterTextureFormat = RasterTextureFormat::RGBA);
     RasterBucket(std::shared_ptr<PremultipliedImage>);
 
     void upload(gl::Context&) override;
@@ -24,7 +40,12 @@ public:
     void setImage(std::shared_ptr<PremultipliedImage>);
     void setMask(TileMask&&);
 
+    // Size of the uploaded texture.
+    size_t getTextureBytes() const;
+
+    // Either the image, or its packed pixels when it was packed.
     std::shared_ptr<PremultipliedImage> image;
+    optional<PackedRasterImage> packedImage;
     optional<gl::Texture> texture;
     TileMask mask{ { 0, 0, 0 } };
 
@@ -34,20 +34,32 @@ SymbolBucket::SymbolBucket(style::SymbolLayoutProperties::PossiblyEvaluated layo
     }
 }
 
+void SymbolBucket::setFeatureStates(const FeatureStateChanges& changes, const GeometryTileLayer& sourceLayer) {
+    for (auto& pair : paintPropertyBinders) {
+        const bool iconUpdated = pair.second.first.updateVertexVectors(changes, sourceLayer);
+        const bool textUpdated = pair.second.second.updateVertexVectors(changes, sourceLayer);
+        if (iconUpdated || textUpdated) {
+            uploaded = false;
+        }
+    }
+}
+
 void SymbolBucket::upload(gl::Context& context) {
-    if (hasTextData()) {
+    // Layout buffers are created once; later uploads only rewrite paint vertices whose
+    // feature state changed.
+    if (hasTextData() && !text.vertexBuffer) {
         text.vertexBuffer = context.createVertexBuffer(std::move(text.vertices));
         text.dynamicVertexBuffer = context.createVertexBuffer(std::move(text.dynamicVertices), gl::BufferUsage::StreamDraw);
         text.indexBuffer = context.createIndexBuffer(std::move(text.triangles));
     }
 
-    if (hasIconData()) {
+    if (hasIconData() && !icon.vertexBuffer) {
         icon.vertexBuffer = context.createVertexBuffer(std::move(icon.vertices));
         icon.dynamicVertexBuffer = context.createVertexBuffer(std::move(icon.dynamicVertices), gl::BufferUsage::StreamDraw);
         icon.indexBuffer = context.createIndexBuffer(std::move(icon.triangles));
     }
 
-    if (!collisionBox.vertices.empty()) {
+    if (!collisionBox.vertices.empty() && !collisionBox.vertexBuffer) {
         collisionBox.vertexBuffer = context.createVertexBuffer(std::move(collisionBox.vertices));
         collisionBox.indexBuffer = context.createIndexBuffer(std::move(collisionBox.lines));
     }
@@ -10,6 +10,8 @@
 #include <mbgl/text/glyph_range.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 #include <mbgl/layout/symbol_feature.hpp>
+#include <mbgl/layout/symbol_projection.hpp>
+#include <mbgl/util/optional.hpp>
 
 #include <vector>
 
@@ -42,6 +44,7 @@ public:
                  bool sdfIcons,
                  bool iconsNeedLinear);
 
+    void setFeatureStates(const FeatureStateChanges&, const GeometryTileLayer&) override;
     void upload(gl::Context&) override;
     bool hasData() const override;
     bool hasTextData() const;
@@ -65,6 +68,11 @@ public:
         SegmentVector<SymbolTextAttributes> segments;
         std::vector<PlacedSymbol> placedSymbols;
 
+        // The camera that dynamicVertices were last reprojected for, and whether they
+        // need to be uploaded again.
+        optional<LineLabelProjectionKey> projectionKey;
+        bool dynamicVerticesDirty = false;
+
         optional<gl::VertexBuffer<SymbolLayoutVertex>> vertexBuffer;
         optional<gl::VertexBuffer<SymbolDynamicLayoutAttributes::Vertex>> dynamicVertexBuffer;
         optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
@@ -78,6 +86,11 @@ public:
         gl::IndexVector<gl::Triangles> triangles;
         SegmentVector<SymbolIconAttributes> segments;
         std::vector<PlacedSymbol> placedSymbols;
+
+        // The camera that dynamicVertices were last reprojected for, and whether they
+        // need to be uploaded again.
+        optional<LineLabelProjectionKey> projectionKey;
+        bool dynamicVerticesDirty = false;
         PremultipliedImage atlasImage;
 
         optional<gl::VertexBuffer<SymbolLayoutVertex>> vertexBuffer;
@@ -0,0 +1,34 @@
+#include <mbgl/renderer/feature_states.hpp>
+
+namespace mbgl {
+
+void LayerFeatureStates::set(const std::string& featureID, const FeatureState& state) {
+    auto it = entries.find(featureID);
+    if (it == entries.end()) {
+        it = entries.emplace(featureID, Entry { {}, 0 }).first;
+    } else {
+        changes.erase(it->second.version);
+    }
+
+    for (const auto& property : state) {
+        it->second.state[property.first] = property.second;
+    }
+
+    it->second.version = ++version;
+    changes.emplace(version, &*it);
+}
+
+const FeatureState* LayerFeatureStates::get(const std::string& featureID) const {
+    auto it = entries.find(featureID);
+    return it == entries.end() ? nullptr : &it->second.state;
+}
+
+FeatureStateChanges LayerFeatureStates::changedSince(uint64_t since) const {
+    FeatureStateChanges result;
+    for (auto it = changes.upper_bound(since); it != changes.end(); ++it) {
+        result.push_back({ it->second->first, it->second->second.state });
+    }
+    return result;
+}
+
+} // namespace mbgl
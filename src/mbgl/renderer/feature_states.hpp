@@ -0,0 +1,60 @@
+#pragma once
+
+#include <mbgl/util/feature.hpp>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+// A feature whose state changed since a bucket last caught up with its source layer.
+class FeatureStateChange {
+public:
+    const std::string& featureID;
+    const FeatureState& state;
+};
+
+using FeatureStateChanges = std::vector<FeatureStateChange>;
+
+/*
+   The feature states of a single source layer. Every change bumps the version, and the
+   version of each feature's latest change is kept in order, so that a bucket that last
+   caught up at some version can re-evaluate just the features that changed since,
+   however many others have a state.
+*/
+class LayerFeatureStates {
+public:
+    // Merges the given properties into the feature's current state.
+    void set(const std::string& featureID, const FeatureState&);
+    const FeatureState* get(const std::string& featureID) const;
+
+    uint64_t getVersion() const {
+        return version;
+    }
+
+    // Features whose state changed after the given version, in the order of their last change.
+    FeatureStateChanges changedSince(uint64_t version) const;
+
+private:
+    class Entry {
+    public:
+        FeatureState state;
+        uint64_t version;
+    };
+
+    using Entries = std::unordered_map<std::string, Entry>;
+
+    uint64_t version = 0;
+    Entries entries;
+
+    // The latest change of each feature, by version. Entries are never erased, so pointers
+    // to them stay valid.
+    std::map<uint64_t, const Entries::value_type*> changes;
+};
+
+using SourceFeatureStates = std::unordered_map<std::string, LayerFeatureStates>;
+
+} // namespace mbgl
@@ -21,6 +21,7 @@ void FrameHistory::record(const TimePoint& now, float zoom, const Duration& dura
         for (int16_t z = 0; z <= zoomIndex; z++) {
             opacities.data[z] = 255u;
         }
+        visibilityVersion++;
         firstFrame = false;
     }
 
@@ -43,6 +44,9 @@ void FrameHistory::record(const TimePoint& now, float zoom, const Duration& dura
             ? util::min(255, changeOpacities[z] + opacityChange)
             : util::max(0, changeOpacities[z] - opacityChange);
         if (opacities.data[z] != opacity) {
+            if ((opacities.data[z] == 0) != (opacity == 0)) {
+                visibilityVersion++;
+            }
             opacities.data[z] = opacity;
             dirty = true;
         }
@@ -24,6 +24,9 @@ public:
     void upload(gl::Context&, uint32_t);
     bool isVisible(const float zoom) const;
 
+    // Incremented whenever the result of isVisible() changes for any zoom level.
+    uint64_t getVisibilityVersion() const { return visibilityVersion; }
+
 private:
     std::array<TimePoint, 256> changeTimes;
     std::array<uint8_t, 256> changeOpacities;
@@ -34,6 +37,7 @@ private:
     TimePoint time;
     bool firstFrame = true;
     bool dirty = true;
+    uint64_t visibilityVersion = 0;
 
     mbgl::optional<gl::Texture> texture;
 };
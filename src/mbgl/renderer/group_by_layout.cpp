@@ -11,21 +11,21 @@
 
 namespace mbgl {
 
-std::string layoutKey(const RenderLayer& layer) {
+std::string layoutKey(const style::Layer::Impl& impl) {
     using namespace style::conversion;
 
     rapidjson::StringBuffer s;
     rapidjson::Writer<rapidjson::StringBuffer> writer(s);
 
     writer.StartArray();
-    writer.Uint(static_cast<uint32_t>(layer.type));
-    writer.String(layer.baseImpl->source);
-    writer.String(layer.baseImpl->sourceLayer);
-    writer.Double(layer.baseImpl->minZoom);
-    writer.Double(layer.baseImpl->maxZoom);
-    writer.Uint(static_cast<uint32_t>(layer.baseImpl->visibility));
-    stringify(writer, layer.baseImpl->filter);
-    layer.baseImpl->stringifyLayout(writer);
+    writer.Uint(static_cast<uint32_t>(impl.type));
+    writer.String(impl.source);
+    writer.String(impl.sourceLayer);
+    writer.Double(impl.minZoom);
+    writer.Double(impl.maxZoom);
+    writer.Uint(static_cast<uint32_t>(impl.visibility));
+    stringify(writer, impl.filter);
+    impl.stringifyLayout(writer);
     writer.EndArray();
 
     return s.GetString();
@@ -34,7 +34,7 @@ std::string layoutKey(const RenderLayer& layer) {
 std::vector<std::vector<const RenderLayer*>> groupByLayout(const std::vector<std::unique_ptr<RenderLayer>>& layers) {
     std::unordered_map<std::string, std::vector<const RenderLayer*>> map;
     for (auto& layer : layers) {
-        map[layoutKey(*layer)].push_back(layer.get());
+        map[layoutKey(*layer->baseImpl)].push_back(layer.get());
     }
 
     std::vector<std::vector<const RenderLayer*>> result;
@@ -1,12 +1,18 @@
 #pragma once
 
+#include <mbgl/style/layer_impl.hpp>
+
 #include <vector>
 #include <memory>
+#include <string>
 
 namespace mbgl {
 
 class RenderLayer;
 
+// Layers with the same key share a bucket.
+std::string layoutKey(const style::Layer::Impl&);
+
 std::vector<std::vector<const RenderLayer*>> groupByLayout(const std::vector<std::unique_ptr<RenderLayer>>&);
 
 } // namespace mbgl
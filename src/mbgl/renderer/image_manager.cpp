@@ -2,8 +2,18 @@
 #include <mbgl/util/logging.hpp>
 #include <mbgl/gl/context.hpp>
 
+#include <limits>
+
 namespace mbgl {
 
+// When copied into the atlas texture, image data is padded by one pixel on each side. Icon
+// images are padded with fully transparent pixels, while pattern images are padded with a
+// copy of the image data wrapped from the opposite side. In both cases, this ensures the
+// correct behavior of GL_LINEAR texture sampling mode.
+static constexpr uint16_t padding = 1;
+
+static constexpr Size initialSize { 64, 64 };
+
 void ImageManager::setLoaded(bool loaded_) {
     if (loaded == loaded_) {
         return;
@@ -29,7 +39,28 @@ void ImageManager::addImage(Immutable<style::Image::Impl> image_) {
 }
 
 void ImageManager::updateImage(Immutable<style::Image::Impl> image_) {
-    removeImage(image_->id);
+    const std::string id = image_->id;
+    const auto icon = icons.find(id);
+    mapbox::Bin* bin = icon != icons.end() ? icon->second : nullptr;
+
+    // Laid out icons also carry the pixel ratio and SDF flag of the image they were placed
+    // with, so only the pixels may change for the icon to be reused.
+    const style::Image::Impl& previous = *images.at(id);
+    const bool compatible = previous.pixelRatio == image_->pixelRatio && previous.sdf == image_->sdf;
+
+    removeImage(id);
+
+    // An icon of the same size is overwritten in place, so that tiles that still show it
+    // pick up the new version without waiting for their next layout.
+    const Size size = image_->image.size;
+    if (bin && compatible &&
+        uint32_t(bin->w) == size.width + padding * 2 && uint32_t(bin->h) == size.height + padding * 2) {
+        PremultipliedImage::copy(image_->image, atlasImage, { 0, 0 },
+                                 { uint32_t(bin->x + padding), uint32_t(bin->y + padding) }, size);
+        markDirty(*bin);
+        icons.emplace(id, bin);
+    }
+
     addImage(std::move(image_));
 }
 
@@ -37,15 +68,12 @@ void ImageManager::removeImage(const std::string& id) {
     assert(images.find(id) != images.end());
     images.erase(id);
 
+    // Tiles may still show the icon, so its bin stays in the atlas until they release it.
+    icons.erase(id);
+
     auto it = patterns.find(id);
     if (it != patterns.end()) {
-        // Clear pattern from the atlas image.
-        const uint32_t x = it->second.bin->x;
-        const uint32_t y = it->second.bin->y;
-        const uint32_t w = it->second.bin->w;
-        const uint32_t h = it->second.bin->h;
-        PremultipliedImage::clear(atlasImage, { x, y }, { w, h });
-
+        clearBin(*it->second.bin);
         shelfPack.unref(*it->second.bin);
         patterns.erase(it);
     }
@@ -79,33 +107,72 @@ void ImageManager::getImages(ImageRequestor& requestor, ImageRequestPair&& pair)
     }
 }
 
+void ImageManager::releaseImages(ImageRequestor& requestor, uint64_t imageCorrelationID) {
+    auto held = heldIcons.find(&requestor);
+    if (held == heldIcons.end()) {
+        return;
+    }
+
+    auto& replies = held->second;
+    for (auto reply = replies.begin(); reply != replies.end() && reply->first < imageCorrelationID;) {
+        for (const auto& icon : reply->second) {
+            releaseIcon(icon);
+        }
+        reply = replies.erase(reply);
+    }
+
+    if (replies.empty()) {
+        heldIcons.erase(held);
+    }
+
+    // Icons are baked into tile buffers by position, so bins can't be moved to close the
+    // gaps that released icons leave behind. Once nothing refers to the atlas anymore
+    // though, it starts over at its initial size.
+    if (heldIcons.empty() && patterns.empty() && getPixelSize() != initialSize) {
+        assert(icons.empty());
+        shelfPack.clear();
+        shelfPack.resize(initialSize.width, initialSize.height);
+        atlasImage = PremultipliedImage(initialSize);
+    }
+}
+
 void ImageManager::removeRequestor(ImageRequestor& requestor) {
     requestors.erase(&requestor);
+    releaseImages(requestor, std::numeric_limits<uint64_t>::max());
 }
 
-void ImageManager::notify(ImageRequestor& requestor, const ImageRequestPair& pair) const {
+void ImageManager::notify(ImageRequestor& requestor, const ImageRequestPair& pair) {
     ImageMap response;
+    ImagePositions positions;
+    std::vector<Icon>& held = heldIcons[&requestor][pair.second];
 
     for (const auto& dependency : pair.first) {
         auto it = images.find(dependency);
-        if (it != images.end()) {
-            response.emplace(*it);
+        if (it == images.end()) {
+            continue;
+        }
+
+        const style::Image::Impl& image = *it->second;
+        mapbox::Bin* bin = addIcon(image);
+        if (!bin) {
+            continue;
         }
+
+        held.push_back({ image.id, bin });
+        positions.emplace(image.id, ImagePosition { *bin, image });
+        response.emplace(*it);
     }
 
-    requestor.onImagesAvailable(response, pair.second);
+    requestor.onImagesAvailable(response, positions, pair.second);
 }
 
 void ImageManager::dumpDebugLogs() const {
     Log::Info(Event::General, "ImageManager::loaded: %d", loaded);
+    Log::Info(Event::General, "ImageManager::atlas: %ux%u, %zu icons, %zu patterns, %zu texture bytes",
+              atlasImage.size.width, atlasImage.size.height, icons.size(), patterns.size(),
+              atlasTexture ? std::size_t(atlasTexture->size.area()) * 4 : std::size_t(0));
 }
 
-// When copied into the atlas texture, image data is padded by one pixel on each side. Icon
-// images are padded with fully transparent pixels, while pattern images are padded with a
-// copy of the image data wrapped from the opposite side. In both cases, this ensures the
-// correct behavior of GL_LINEAR texture sampling mode.
-static constexpr uint16_t padding = 1;
-
 static mapbox::ShelfPack::ShelfPackOptions shelfPackOptions() {
     mapbox::ShelfPack::ShelfPackOptions options;
     options.autoResize = true;
@@ -113,7 +180,8 @@ static mapbox::ShelfPack::ShelfPackOptions shelfPackOptions() {
 }
 
 ImageManager::ImageManager()
-    : shelfPack(64, 64, shelfPackOptions()) {
+    : shelfPack(initialSize.width, initialSize.height, shelfPackOptions()),
+      atlasImage(initialSize) {
 }
 
 ImageManager::~ImageManager() = default;
@@ -154,7 +222,7 @@ optional<ImagePosition> ImageManager::getPattern(const std::string& id) {
     PremultipliedImage::copy(src, atlasImage, { w - 1, 0 }, { x - 1, y }, { 1, h }); // L
     PremultipliedImage::copy(src, atlasImage, { 0,     0 }, { x + w, y }, { 1, h }); // R
 
-    dirty = true;
+    markDirty(*bin);
 
     return patterns.emplace(id, Pattern { bin, { *bin, *image } }).first->second.position;
 }
@@ -166,19 +234,76 @@ Size ImageManager::getPixelSize() const {
     };
 }
 
+mapbox::Bin* ImageManager::addIcon(const style::Image::Impl& image) {
+    auto it = icons.find(image.id);
+    if (it != icons.end()) {
+        shelfPack.ref(*it->second);
+        return it->second;
+    }
+
+    mapbox::Bin* bin = shelfPack.packOne(-1,
+        image.image.size.width + padding * 2,
+        image.image.size.height + padding * 2);
+    if (!bin) {
+        return nullptr;
+    }
+
+    atlasImage.resize(getPixelSize());
+    PremultipliedImage::copy(image.image, atlasImage, { 0, 0 },
+                             { uint32_t(bin->x + padding), uint32_t(bin->y + padding) }, image.image.size);
+    markDirty(*bin);
+
+    icons.emplace(image.id, bin);
+    return bin;
+}
+
+void ImageManager::releaseIcon(const Icon& icon) {
+    if (shelfPack.unref(*icon.bin) > 0) {
+        return;
+    }
+
+    // Freed bins are reused for other images, which must find transparent padding.
+    clearBin(*icon.bin);
+
+    auto it = icons.find(icon.id);
+    if (it != icons.end() && it->second == icon.bin) {
+        icons.erase(it);
+    }
+}
+
+void ImageManager::clearBin(const mapbox::Bin& bin) {
+    PremultipliedImage::clear(atlasImage, { uint32_t(bin.x), uint32_t(bin.y) }, { uint32_t(bin.w), uint32_t(bin.h) });
+    markDirty(bin);
+}
+
+void ImageManager::markDirty(const mapbox::Bin& bin) {
+    const auto top = uint32_t(bin.y);
+    const auto bottom = uint32_t(bin.y + bin.h);
+    if (dirtyTop == dirtyBottom) {
+        dirtyTop = top;
+        dirtyBottom = bottom;
+    } else {
+        dirtyTop = std::min(dirtyTop, top);
+        dirtyBottom = std::max(dirtyBottom, bottom);
+    }
+}
+
 void ImageManager::upload(gl::Context& context, gl::TextureUnit unit) {
     if (!atlasTexture) {
         atlasTexture = context.createTexture(atlasImage, unit);
-    } else if (dirty) {
+    } else if (atlasTexture->size != atlasImage.size) {
         context.updateTexture(*atlasTexture, atlasImage, unit);
+    } else if (dirtyTop < dirtyBottom) {
+        // Only the rows that changed are uploaded again.
+        context.updateTextureRows(*atlasTexture, atlasImage, dirtyTop, dirtyBottom - dirtyTop, unit);
     }
 
-    dirty = false;
+    dirtyTop = dirtyBottom = 0;
 }
 
-void ImageManager::bind(gl::Context& context, gl::TextureUnit unit) {
+void ImageManager::bind(gl::Context& context, gl::TextureUnit unit, gl::TextureFilter filter) {
     upload(context, unit);
-    context.bindTexture(*atlasTexture, unit, gl::TextureFilter::Linear);
+    context.bindTexture(*atlasTexture, unit, filter);
 }
 
 } // namespace mbgl
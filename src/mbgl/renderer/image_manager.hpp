@@ -9,8 +9,10 @@
 
 #include <mapbox/shelf-pack.hpp>
 
+#include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace mbgl {
 
@@ -21,18 +23,19 @@ class Context;
 class ImageRequestor {
 public:
     virtual ~ImageRequestor() = default;
-    virtual void onImagesAvailable(ImageMap, uint64_t imageCorrelationID) = 0;
+    virtual void onImagesAvailable(ImageMap, ImagePositions, uint64_t imageCorrelationID) = 0;
 };
 
 /*
     ImageManager does two things:
 
         1. Tracks requests for icon images from tile workers and sends responses when the requests are fulfilled.
-        2. Builds a texture atlas for pattern images.
+        2. Builds the texture atlas for icon and pattern images, which is shared by all tiles.
 
-    These are disparate responsibilities and should eventually be handled by different classes. When we implement
-    data-driven support for `*-pattern`, we'll likely use per-bucket pattern atlases, and that would be a good time
-    to refactor this.
+    Icons are placed into the atlas when they are sent to a requestor, and the positions are sent along with the
+    images. Tile workers bake these positions into their buckets, so an icon keeps its place for as long as any
+    requestor holds a reply that contains it. A requestor releases its older replies once it no longer renders
+    buckets built from them.
 */
 class ImageManager : public util::noncopyable {
 public:
@@ -51,21 +54,23 @@ public:
     void removeImage(const std::string&);
 
     void getImages(ImageRequestor&, ImageRequestPair&&);
+    // Releases the icons of all replies to the requestor that are older than the given one.
+    void releaseImages(ImageRequestor&, uint64_t imageCorrelationID);
     void removeRequestor(ImageRequestor&);
 
 private:
-    void notify(ImageRequestor&, const ImageRequestPair&) const;
+    void notify(ImageRequestor&, const ImageRequestPair&);
 
     bool loaded = false;
 
     std::unordered_map<ImageRequestor*, ImageRequestPair> requestors;
     ImageMap images;
 
-// Pattern stuff
+// Atlas stuff
 public:
     optional<ImagePosition> getPattern(const std::string& name);
 
-    void bind(gl::Context&, gl::TextureUnit unit);
+    void bind(gl::Context&, gl::TextureUnit unit, gl::TextureFilter = gl::TextureFilter::Linear);
     void upload(gl::Context&, gl::TextureUnit unit);
 
     Size getPixelSize() const;
@@ -81,11 +86,29 @@ private:
         ImagePosition position;
     };
 
+    struct Icon {
+        std::string id;
+        mapbox::Bin* bin;
+    };
+
+    mapbox::Bin* addIcon(const style::Image::Impl&);
+    void releaseIcon(const Icon&);
+    void clearBin(const mapbox::Bin&);
+    void markDirty(const mapbox::Bin&);
+
     mapbox::ShelfPack shelfPack;
     std::unordered_map<std::string, Pattern> patterns;
+    // The bin of the current version of each icon. Bins of replaced or removed images stay in
+    // the atlas until they are released, but are no longer handed out.
+    std::unordered_map<std::string, mapbox::Bin*> icons;
+    // The icons sent to each requestor, by the correlation ID of the reply.
+    std::unordered_map<ImageRequestor*, std::map<uint64_t, std::vector<Icon>>> heldIcons;
     PremultipliedImage atlasImage;
     mbgl::optional<gl::Texture> atlasTexture;
-    bool dirty = true;
+
+    // Rows of the atlas image that changed since the last upload.
+    uint32_t dirtyTop = 0;
+    uint32_t dirtyBottom = 0;
 };
 
 } // namespace mbgl
@@ -59,62 +59,75 @@ bool RenderFillLayer::hasTransition() const {
 }
 
 void RenderFillLayer::render(PaintParameters& parameters, RenderSource*) {
-    if (evaluated.get<FillPattern>().from.empty()) {
+    // Fills are drawn for all tiles before any outlines, as in GL JS, so the program only
+    // changes once per layer. Each program variant is resolved before looping over tiles.
+    auto drawTiles = [&] (auto& programs,
+                          const auto& drawMode,
+                          const auto& depthMode,
+                          auto&& uniformValues,
+                          auto indexBuffer,
+                          auto segments) {
+        auto& program = programs.get(evaluated);
+
         for (const RenderTile& tile : renderTiles) {
             assert(dynamic_cast<FillBucket*>(tile.tile.getBucket(*baseImpl)));
             FillBucket& bucket = *reinterpret_cast<FillBucket*>(tile.tile.getBucket(*baseImpl));
 
-            auto draw = [&] (auto& program,
-                             const auto& drawMode,
-                             const auto& depthMode,
-                             const auto& indexBuffer,
-                             const auto& segments) {
-                program.get(evaluated).draw(
-                    parameters.context,
-                    drawMode,
-                    depthMode,
-                    parameters.stencilModeForClipping(tile.clip),
-                    parameters.colorModeForRenderPass(),
-                    FillProgram::UniformValues {
-                        uniforms::u_matrix::Value{
-                            tile.translatedMatrix(evaluated.get<FillTranslate>(),
-                                                  evaluated.get<FillTranslateAnchor>(),
-                                                  parameters.state)
-                        },
-                        uniforms::u_world::Value{ parameters.context.viewport.getCurrentValue().size },
-                    },
-                    *bucket.vertexBuffer,
-                    indexBuffer,
-                    segments,
-                    bucket.paintPropertyBinders.at(getID()),
-                    evaluated,
-                    parameters.state.getZoom(),
-                    getID()
-                );
+            program.draw(
+                parameters.context,
+                drawMode,
+                depthMode,
+                parameters.stencilModeForClipping(tile.clip),
+                parameters.colorModeForRenderPass(),
+                uniformValues(tile),
+                *bucket.vertexBuffer,
+                *(bucket.*indexBuffer),
+                bucket.*segments,
+                bucket.paintPropertyBinders.at(getID()),
+                evaluated,
+                parameters.state.getZoom(),
+                getID()
+            );
+        }
+    };
+
+    if (evaluated.get<FillPattern>().from.empty()) {
+        const Size viewportSize = parameters.context.viewport.getCurrentValue().size;
+
+        auto uniformValues = [&] (const RenderTile& tile) {
+            return FillProgram::UniformValues {
+                uniforms::u_matrix::Value{
+                    tile.translatedMatrix(evaluated.get<FillTranslate>(),
+                                          evaluated.get<FillTranslateAnchor>(),
+                                          parameters.state)
+                },
+                uniforms::u_world::Value{ viewportSize },
             };
+        };
+
+        // Only draw the fill when it's opaque and we're drawing opaque fragments,
+        // or when it's translucent and we're drawing translucent fragments.
+        if ((evaluated.get<FillColor>().constantOr(Color()).a >= 1.0f
+          && evaluated.get<FillOpacity>().constantOr(0) >= 1.0f) == (parameters.pass == RenderPass::Opaque)) {
+            drawTiles(parameters.programs.fill,
+                      gl::Triangles(),
+                      parameters.depthModeForSublayer(1, parameters.pass == RenderPass::Opaque
+                         ? gl::DepthMode::ReadWrite
+                         : gl::DepthMode::ReadOnly),
+                      uniformValues,
+                      &FillBucket::triangleIndexBuffer,
+                      &FillBucket::triangleSegments);
+        }
 
-            // Only draw the fill when it's opaque and we're drawing opaque fragments,
-            // or when it's translucent and we're drawing translucent fragments.
-            if ((evaluated.get<FillColor>().constantOr(Color()).a >= 1.0f
-              && evaluated.get<FillOpacity>().constantOr(0) >= 1.0f) == (parameters.pass == RenderPass::Opaque)) {
-                draw(parameters.programs.fill,
-                     gl::Triangles(),
-                     parameters.depthModeForSublayer(1, parameters.pass == RenderPass::Opaque
-                        ? gl::DepthMode::ReadWrite
-                        : gl::DepthMode::ReadOnly),
-                     *bucket.triangleIndexBuffer,
-                     bucket.triangleSegments);
-            }
-
-            if (evaluated.get<FillAntialias>() && parameters.pass == RenderPass::Translucent) {
-                draw(parameters.programs.fillOutline,
-                     gl::Lines{ 2.0f },
-                     parameters.depthModeForSublayer(
-                         unevaluated.get<FillOutlineColor>().isUndefined() ? 2 : 0,
-                         gl::DepthMode::ReadOnly),
-                     *bucket.lineIndexBuffer,
-                     bucket.lineSegments);
-            }
+        if (evaluated.get<FillAntialias>() && parameters.pass == RenderPass::Translucent) {
+            drawTiles(parameters.programs.fillOutline,
+                      gl::Lines{ 2.0f },
+                      parameters.depthModeForSublayer(
+                          unevaluated.get<FillOutlineColor>().isUndefined() ? 2 : 0,
+                          gl::DepthMode::ReadOnly),
+                      uniformValues,
+                      &FillBucket::lineIndexBuffer,
+                      &FillBucket::lineSegments);
         }
     } else {
         if (parameters.pass != RenderPass::Translucent) {
@@ -130,56 +143,38 @@ void RenderFillLayer::render(PaintParameters& parameters, RenderSource*) {
 
         parameters.imageManager.bind(parameters.context, 0);
 
-        for (const RenderTile& tile : renderTiles) {
-            assert(dynamic_cast<FillBucket*>(tile.tile.getBucket(*baseImpl)));
-            FillBucket& bucket = *reinterpret_cast<FillBucket*>(tile.tile.getBucket(*baseImpl));
-
-            auto draw = [&] (auto& program,
-                             const auto& drawMode,
-                             const auto& depthMode,
-                             const auto& indexBuffer,
-                             const auto& segments) {
-                program.get(evaluated).draw(
-                    parameters.context,
-                    drawMode,
-                    depthMode,
-                    parameters.stencilModeForClipping(tile.clip),
-                    parameters.colorModeForRenderPass(),
-                    FillPatternUniforms::values(
-                        tile.translatedMatrix(evaluated.get<FillTranslate>(),
-                                              evaluated.get<FillTranslateAnchor>(),
-                                              parameters.state),
-                        parameters.context.viewport.getCurrentValue().size,
-                        parameters.imageManager.getPixelSize(),
-                        *imagePosA,
-                        *imagePosB,
-                        evaluated.get<FillPattern>(),
-                        tile.id,
-                        parameters.state
-                    ),
-                    *bucket.vertexBuffer,
-                    indexBuffer,
-                    segments,
-                    bucket.paintPropertyBinders.at(getID()),
-                    evaluated,
-                    parameters.state.getZoom(),
-                    getID()
-                );
-            };
-
-            draw(parameters.programs.fillPattern,
-                 gl::Triangles(),
-                 parameters.depthModeForSublayer(1, gl::DepthMode::ReadWrite),
-                 *bucket.triangleIndexBuffer,
-                 bucket.triangleSegments);
-
-            if (evaluated.get<FillAntialias>() && unevaluated.get<FillOutlineColor>().isUndefined()) {
-                draw(parameters.programs.fillOutlinePattern,
-                     gl::Lines { 2.0f },
-                     parameters.depthModeForSublayer(2, gl::DepthMode::ReadOnly),
-                     *bucket.lineIndexBuffer,
-                     bucket.lineSegments);
-            }
+        const Size viewportSize = parameters.context.viewport.getCurrentValue().size;
+        const Size atlasSize = parameters.imageManager.getPixelSize();
+
+        auto uniformValues = [&] (const RenderTile& tile) {
+            return FillPatternUniforms::values(
+                tile.translatedMatrix(evaluated.get<FillTranslate>(),
+                                      evaluated.get<FillTranslateAnchor>(),
+                                      parameters.state),
+                viewportSize,
+                atlasSize,
+                *imagePosA,
+                *imagePosB,
+                evaluated.get<FillPattern>(),
+                tile.id,
+                parameters.state
+            );
+        };
+
+        drawTiles(parameters.programs.fillPattern,
+                  gl::Triangles(),
+                  parameters.depthModeForSublayer(1, gl::DepthMode::ReadWrite),
+                  uniformValues,
+                  &FillBucket::triangleIndexBuffer,
+                  &FillBucket::triangleSegments);
+
+        if (evaluated.get<FillAntialias>() && unevaluated.get<FillOutlineColor>().isUndefined()) {
+            drawTiles(parameters.programs.fillOutlinePattern,
+                      gl::Lines { 2.0f },
+                      parameters.depthModeForSublayer(2, gl::DepthMode::ReadOnly),
+                      uniformValues,
+                      &FillBucket::lineIndexBuffer,
+                      &FillBucket::lineSegments);
         }
     }
 }
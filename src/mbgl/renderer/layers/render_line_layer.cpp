@@ -57,18 +57,22 @@ void RenderLineLayer::render(PaintParameters& parameters, RenderSource*) {
         return;
     }
 
-    for (const RenderTile& tile : renderTiles) {
-        assert(dynamic_cast<LineBucket*>(tile.tile.getBucket(*baseImpl)));
-        LineBucket& bucket = *reinterpret_cast<LineBucket*>(tile.tile.getBucket(*baseImpl));
+    // The program variant and the atlas positions of the dash array or pattern only depend
+    // on the layer, so they are resolved once here rather than for every tile.
+    auto drawTiles = [&] (auto& programs, auto&& uniformValues) {
+        auto& program = programs.get(evaluated);
 
-        auto draw = [&] (auto& program, auto&& uniformValues) {
-            program.get(evaluated).draw(
+        for (const RenderTile& tile : renderTiles) {
+            assert(dynamic_cast<LineBucket*>(tile.tile.getBucket(*baseImpl)));
+            LineBucket& bucket = *reinterpret_cast<LineBucket*>(tile.tile.getBucket(*baseImpl));
+
+            program.draw(
                 parameters.context,
                 gl::Triangles(),
                 parameters.depthModeForSublayer(0, gl::DepthMode::ReadOnly),
                 parameters.stencilModeForClipping(tile.clip),
                 parameters.colorModeForRenderPass(),
-                std::move(uniformValues),
+                uniformValues(tile, bucket),
                 *bucket.vertexBuffer,
                 *bucket.indexBuffer,
                 bucket.segments,
@@ -77,54 +81,64 @@ void RenderLineLayer::render(PaintParameters& parameters, RenderSource*) {
                 parameters.state.getZoom(),
                 getID()
             );
-        };
+        }
+    };
+
+    if (!evaluated.get<LineDasharray>().from.empty()) {
+        // Dash positions also depend on the line-cap of each bucket.
+        optional<std::pair<LinePatternPos, LinePatternPos>> dashPositions[2];
 
-        if (!evaluated.get<LineDasharray>().from.empty()) {
+        drawTiles(parameters.programs.lineSDF, [&] (const RenderTile& tile, const LineBucket& bucket) {
             const LinePatternCap cap = bucket.layout.get<LineCap>() == LineCapType::Round
                 ? LinePatternCap::Round : LinePatternCap::Square;
-            LinePatternPos posA = parameters.lineAtlas.getDashPosition(evaluated.get<LineDasharray>().from, cap);
-            LinePatternPos posB = parameters.lineAtlas.getDashPosition(evaluated.get<LineDasharray>().to, cap);
-
-            parameters.lineAtlas.bind(parameters.context, 0);
-
-            draw(parameters.programs.lineSDF,
-                 LineSDFProgram::uniformValues(
-                     evaluated,
-                     parameters.pixelRatio,
-                     tile,
-                     parameters.state,
-                     parameters.pixelsToGLUnits,
-                     posA,
-                     posB,
-                     parameters.lineAtlas.getSize().width));
-
-        } else if (!evaluated.get<LinePattern>().from.empty()) {
-            optional<ImagePosition> posA = parameters.imageManager.getPattern(evaluated.get<LinePattern>().from);
-            optional<ImagePosition> posB = parameters.imageManager.getPattern(evaluated.get<LinePattern>().to);
-
-            if (!posA || !posB)
-                return;
-
-            parameters.imageManager.bind(parameters.context, 0);
-
-            draw(parameters.programs.linePattern,
-                 LinePatternProgram::uniformValues(
-                     evaluated,
-                     tile,
-                     parameters.state,
-                     parameters.pixelsToGLUnits,
-                     parameters.imageManager.getPixelSize(),
-                     *posA,
-                     *posB));
-
-        } else {
-            draw(parameters.programs.line,
-                 LineProgram::uniformValues(
-                     evaluated,
-                     tile,
-                     parameters.state,
-                     parameters.pixelsToGLUnits));
-        }
+            auto& positions = dashPositions[cap == LinePatternCap::Round];
+
+            if (!positions) {
+                positions = std::make_pair(
+                    parameters.lineAtlas.getDashPosition(evaluated.get<LineDasharray>().from, cap),
+                    parameters.lineAtlas.getDashPosition(evaluated.get<LineDasharray>().to, cap));
+                parameters.lineAtlas.bind(parameters.context, 0);
+            }
+
+            return LineSDFProgram::uniformValues(
+                evaluated,
+                parameters.pixelRatio,
+                tile,
+                parameters.state,
+                parameters.pixelsToGLUnits,
+                positions->first,
+                positions->second,
+                parameters.lineAtlas.getSize().width);
+        });
+
+    } else if (!evaluated.get<LinePattern>().from.empty()) {
+        optional<ImagePosition> posA = parameters.imageManager.getPattern(evaluated.get<LinePattern>().from);
+        optional<ImagePosition> posB = parameters.imageManager.getPattern(evaluated.get<LinePattern>().to);
+
+        if (!posA || !posB)
+            return;
+
+        parameters.imageManager.bind(parameters.context, 0);
+
+        drawTiles(parameters.programs.linePattern, [&] (const RenderTile& tile, const LineBucket&) {
+            return LinePatternProgram::uniformValues(
+                evaluated,
+                tile,
+                parameters.state,
+                parameters.pixelsToGLUnits,
+                parameters.imageManager.getPixelSize(),
+                *posA,
+                *posB);
+        });
+
+    } else {
+        drawTiles(parameters.programs.line, [&] (const RenderTile& tile, const LineBucket&) {
+            return LineProgram::uniformValues(
+                evaluated,
+                tile,
+                parameters.state,
+                parameters.pixelsToGLUnits);
+        });
     }
 }
 
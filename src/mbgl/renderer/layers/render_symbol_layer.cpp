@@ -5,6 +5,7 @@
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/renderer/paint_parameters.hpp>
 #include <mbgl/renderer/frame_history.hpp>
+#include <mbgl/renderer/image_manager.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/programs/programs.hpp>
 #include <mbgl/programs/symbol_program.hpp>
@@ -40,11 +41,15 @@ std::unique_ptr<Bucket> RenderSymbolLayer::createBucket(const BucketParameters&,
 std::unique_ptr<SymbolLayout> RenderSymbolLayer::createLayout(const BucketParameters& parameters,
                                                               const std::vector<const RenderLayer*>& group,
                                                               std::unique_ptr<GeometryTileLayer> layer,
+                                                              const StringIdentity sourceLayerName,
+                                                              const StringIdentity bucketName,
                                                               GlyphDependencies& glyphDependencies,
                                                               ImageDependencies& imageDependencies) const {
     return std::make_unique<SymbolLayout>(parameters,
                                           group,
                                           std::move(layer),
+                                          sourceLayerName,
+                                          bucketName,
                                           imageDependencies,
                                           glyphDependencies);
 }
@@ -75,13 +80,19 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
         return;
     }
 
+    // Paint properties are copied out of the layer's evaluated properties once per frame,
+    // not for every tile.
+    const auto iconPaintPropertyValues = iconPaintProperties();
+    const auto textPaintPropertyValues = textPaintProperties();
+
+    parameters.frameHistory.bind(parameters.context, 1);
+
     for (const RenderTile& tile : renderTiles) {
         assert(dynamic_cast<SymbolBucket*>(tile.tile.getBucket(*baseImpl)));
         SymbolBucket& bucket = *reinterpret_cast<SymbolBucket*>(tile.tile.getBucket(*baseImpl));
 
         const auto& layout = bucket.layout;
-
-        parameters.frameHistory.bind(parameters.context, 1);
+        const auto& layerBinders = bucket.paintPropertyBinders.at(getID());
 
         auto draw = [&] (auto& program,
                          auto&& uniformValues,
@@ -122,32 +133,24 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
 
         if (bucket.hasIconData()) {
             auto values = iconPropertyValues(layout);
-            auto paintPropertyValues = iconPaintProperties();
+            const auto& paintPropertyValues = iconPaintPropertyValues;
 
             const bool alongLine = layout.get<SymbolPlacement>() == SymbolPlacementType::Line &&
                 layout.get<IconRotationAlignment>() == AlignmentType::Map;
 
-            if (alongLine) {
-                reprojectLineLabels(bucket.icon.dynamicVertices,
-                                    bucket.icon.placedSymbols,
-                                    tile.matrix,
-                                    values,
-                                    tile,
-                                    *bucket.iconSizeBinder,
-                                    parameters.state,
-                                    parameters.frameHistory);
-
+            if (alongLine && bucket.icon.dynamicVerticesDirty) {
                 parameters.context.updateVertexBuffer(*bucket.icon.dynamicVertexBuffer, std::move(bucket.icon.dynamicVertices));
+                bucket.icon.dynamicVerticesDirty = false;
             }
 
             const bool iconScaled = layout.get<IconSize>().constantOr(1.0) != 1.0 || bucket.iconsNeedLinear;
             const bool iconTransformed = values.rotationAlignment == AlignmentType::Map || parameters.state.getPitch() != 0;
 
-            parameters.context.bindTexture(*geometryTile.iconAtlasTexture, 0,
+            parameters.imageManager.bind(parameters.context, 0,
                 bucket.sdfIcons || parameters.state.isChanging() || iconScaled || iconTransformed
                     ? gl::TextureFilter::Linear : gl::TextureFilter::Nearest);
 
-            const Size texsize = geometryTile.iconAtlasTexture->size;
+            const Size texsize = parameters.imageManager.getPixelSize();
 
             if (bucket.sdfIcons) {
                 if (values.hasHalo) {
@@ -156,7 +159,7 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
                          bucket.icon,
                          bucket.iconSizeBinder,
                          values,
-                         bucket.paintPropertyBinders.at(getID()).first,
+                         layerBinders.first,
                          paintPropertyValues);
                 }
 
@@ -166,7 +169,7 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
                          bucket.icon,
                          bucket.iconSizeBinder,
                          values,
-                         bucket.paintPropertyBinders.at(getID()).first,
+                         layerBinders.first,
                          paintPropertyValues);
                 }
             } else {
@@ -175,7 +178,7 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
                      bucket.icon,
                      bucket.iconSizeBinder,
                      values,
-                     bucket.paintPropertyBinders.at(getID()).first,
+                     layerBinders.first,
                      paintPropertyValues);
             }
         }
@@ -184,22 +187,14 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
             parameters.context.bindTexture(*geometryTile.glyphAtlasTexture, 0, gl::TextureFilter::Linear);
 
             auto values = textPropertyValues(layout);
-            auto paintPropertyValues = textPaintProperties();
+            const auto& paintPropertyValues = textPaintPropertyValues;
 
             const bool alongLine = layout.get<SymbolPlacement>() == SymbolPlacementType::Line &&
                 layout.get<TextRotationAlignment>() == AlignmentType::Map;
 
-            if (alongLine) {
-                reprojectLineLabels(bucket.text.dynamicVertices,
-                                    bucket.text.placedSymbols,
-                                    tile.matrix,
-                                    values,
-                                    tile,
-                                    *bucket.textSizeBinder,
-                                    parameters.state,
-                                    parameters.frameHistory);
-
+            if (alongLine && bucket.text.dynamicVerticesDirty) {
                 parameters.context.updateVertexBuffer(*bucket.text.dynamicVertexBuffer, std::move(bucket.text.dynamicVertices));
+                bucket.text.dynamicVerticesDirty = false;
             }
 
             const Size texsize = geometryTile.glyphAtlasTexture->size;
@@ -210,7 +205,7 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
                      bucket.text,
                      bucket.textSizeBinder,
                      values,
-                     bucket.paintPropertyBinders.at(getID()).second,
+                     layerBinders.second,
                      paintPropertyValues);
             }
 
@@ -220,7 +215,7 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
                      bucket.text,
                      bucket.textSizeBinder,
                      values,
-                     bucket.paintPropertyBinders.at(getID()).second,
+                     layerBinders.second,
                      paintPropertyValues);
             }
         }
@@ -257,6 +252,56 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
     }
 }
 
+void RenderSymbolLayer::prepareLineLabels(const PaintParameters& parameters, std::vector<std::function<void()>>& jobs) {
+    for (const RenderTile& tile : renderTiles) {
+        assert(dynamic_cast<SymbolBucket*>(tile.tile.getBucket(*baseImpl)));
+        SymbolBucket& bucket = *reinterpret_cast<SymbolBucket*>(tile.tile.getBucket(*baseImpl));
+
+        const auto& layout = bucket.layout;
+        if (layout.get<SymbolPlacement>() != SymbolPlacementType::Line) {
+            continue;
+        }
+
+        // Buckets are shared between layers with identical layout properties, so a bucket
+        // that another layer already queued for this frame is skipped here.
+        const LineLabelProjectionKey key { tile.matrix, parameters.state, parameters.frameHistory };
+
+        if (bucket.hasIconData() &&
+            layout.get<IconRotationAlignment>() == AlignmentType::Map &&
+            bucket.icon.projectionKey != key) {
+            bucket.icon.projectionKey = key;
+            bucket.icon.dynamicVerticesDirty = true;
+            jobs.emplace_back([&bucket, &tile, &parameters, values = iconPropertyValues(layout)] {
+                reprojectLineLabels(bucket.icon.dynamicVertices,
+                                    bucket.icon.placedSymbols,
+                                    tile.matrix,
+                                    values,
+                                    tile,
+                                    *bucket.iconSizeBinder,
+                                    parameters.state,
+                                    parameters.frameHistory);
+            });
+        }
+
+        if (bucket.hasTextData() &&
+            layout.get<TextRotationAlignment>() == AlignmentType::Map &&
+            bucket.text.projectionKey != key) {
+            bucket.text.projectionKey = key;
+            bucket.text.dynamicVerticesDirty = true;
+            jobs.emplace_back([&bucket, &tile, &parameters, values = textPropertyValues(layout)] {
+                reprojectLineLabels(bucket.text.dynamicVertices,
+                                    bucket.text.placedSymbols,
+                                    tile.matrix,
+                                    values,
+                                    tile,
+                                    *bucket.textSizeBinder,
+                                    parameters.state,
+                                    parameters.frameHistory);
+            });
+        }
+    }
+}
+
 style::IconPaintProperties::PossiblyEvaluated RenderSymbolLayer::iconPaintProperties() const {
     return style::IconPaintProperties::PossiblyEvaluated {
             evaluated.get<style::IconOpacity>(),
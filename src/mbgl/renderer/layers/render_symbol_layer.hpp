@@ -5,6 +5,10 @@
 #include <mbgl/style/image_impl.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
+#include <mbgl/util/string_indexer.hpp>
+
+#include <functional>
+#include <vector>
 
 namespace mbgl {
 
@@ -68,6 +72,10 @@ public:
     bool hasTransition() const override;
     void render(PaintParameters&, RenderSource*) override;
 
+    // Adds a job for every tile whose labels along lines need to be reprojected because the
+    // camera changed since they were last projected. render() uploads the results.
+    void prepareLineLabels(const PaintParameters&, std::vector<std::function<void()>>& jobs);
+
     style::IconPaintProperties::PossiblyEvaluated iconPaintProperties() const;
     style::TextPaintProperties::PossiblyEvaluated textPaintProperties() const;
 
@@ -78,6 +86,8 @@ public:
     std::unique_ptr<SymbolLayout> createLayout(const BucketParameters&,
                                                const std::vector<const RenderLayer*>&,
                                                std::unique_ptr<GeometryTileLayer>,
+                                               StringIdentity sourceLayerName,
+                                               StringIdentity bucketName,
                                                GlyphDependencies&,
                                                ImageDependencies&) const;
 
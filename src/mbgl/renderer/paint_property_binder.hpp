@@ -7,8 +7,13 @@
 #include <mbgl/util/type_list.hpp>
 #include <mbgl/renderer/possibly_evaluated_property_value.hpp>
 #include <mbgl/renderer/paint_property_statistics.hpp>
+#include <mbgl/renderer/feature_states.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/string.hpp>
 
 #include <bitset>
+#include <unordered_map>
 
 namespace mbgl {
 
@@ -39,6 +44,45 @@ inline std::array<float, 2> attributeValue(const Color& color) {
     }};
 }
 
+/*
+   A FeatureVertexRange names the run of vertices in a bucket whose paint attributes are
+   taken from a single feature: the run starts where the previous one ended (or at the
+   current end of the paint vertex vector) and ends before vertexEnd. index is the
+   position of the feature in its source layer.
+*/
+class FeatureVertexRange {
+public:
+    const GeometryTileFeature* feature;
+    std::size_t index;
+    std::size_t vertexEnd;
+};
+
+/*
+   Binders for properties that depend on feature state remember which vertices each
+   feature covers, keyed by feature ID, along with the feature's index in its source
+   layer. When a feature's state changes, only its own vertices are re-evaluated.
+*/
+class FeatureStateVertexRange {
+public:
+    std::size_t index;
+    std::size_t start;
+    std::size_t end;
+};
+
+using FeatureStateVertexRanges = std::unordered_map<std::string, std::vector<FeatureStateVertexRange>>;
+
+inline void addFeatureStateVertexRange(FeatureStateVertexRanges& ranges, const FeatureVertexRange& range, std::size_t start) {
+    const optional<FeatureIdentifier> id = range.feature->getID();
+    if (!id) {
+        return;
+    }
+
+    std::string key = id->match(
+        [] (const std::string& s) { return s; },
+        [] (const auto& n) { return util::toString(n); });
+    ranges[key].push_back({ range.index, start, range.vertexEnd });
+}
+
 template <size_t N>
 std::array<float, N*2> zoomInterpolatedAttributeValue(const std::array<float, N>& min, const std::array<float, N>& max) {
     std::array<float, N*2> result;
@@ -81,6 +125,15 @@ public:
     virtual ~PaintPropertyBinder() = default;
 
     virtual void populateVertexVector(const GeometryTileFeature& feature, std::size_t length) = 0;
+
+    // Equivalent to calling populateVertexVector() for each range, but evaluates the
+    // property over all features at once and fills the vertex vector in bulk.
+    virtual void populateVertexVectors(const std::vector<FeatureVertexRange>&) = 0;
+
+    // Re-evaluates the property for the features in `changes`, fetching them again from
+    // the source layer the vertices were built from. Returns whether any vertices changed;
+    // the next upload() rewrites just those.
+    virtual bool updateVertexVectors(const FeatureStateChanges& changes, const GeometryTileLayer&) = 0;
     virtual void upload(gl::Context& context) = 0;
     virtual optional<AttributeBinding> attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const = 0;
     virtual float interpolationFactor(float currentZoom) const = 0;
@@ -102,6 +155,11 @@ public:
     }
 
     void populateVertexVector(const GeometryTileFeature&, std::size_t) override {}
+    void populateVertexVectors(const std::vector<FeatureVertexRange>&) override {}
+
+    bool updateVertexVectors(const FeatureStateChanges&, const GeometryTileLayer&) override {
+        return false;
+    }
     void upload(gl::Context&) override {}
 
     optional<AttributeBinding> attributeBinding(const PossiblyEvaluatedPropertyValue<T>&) const override {
@@ -132,7 +190,8 @@ public:
 
     SourceFunctionPaintPropertyBinder(style::SourceFunction<T> function_, T defaultValue_)
         : function(std::move(function_)),
-          defaultValue(std::move(defaultValue_)) {
+          defaultValue(std::move(defaultValue_)),
+          usesFeatureState(!function.isFeatureStateConstant()) {
     }
 
     void populateVertexVector(const GeometryTileFeature& feature, std::size_t length) override {
@@ -144,8 +203,66 @@ public:
         }
     }
 
+    void populateVertexVectors(const std::vector<FeatureVertexRange>& ranges) override {
+        if (ranges.empty()) {
+            return;
+        }
+
+        std::vector<const GeometryTileFeature*> features;
+        features.reserve(ranges.size());
+        for (const auto& range : ranges) {
+            features.push_back(range.feature);
+        }
+
+        const std::vector<T> evaluated = function.evaluate(features, defaultValue);
+        vertexVector.reserve(ranges.back().vertexEnd);
+        for (std::size_t i = 0; i < ranges.size(); i++) {
+            this->statistics.add(evaluated[i]);
+            const std::size_t start = vertexVector.vertexSize();
+            if (ranges[i].vertexEnd > start) {
+                vertexVector.resize(ranges[i].vertexEnd, BaseVertex { attributeValue(evaluated[i]) });
+                if (usesFeatureState) {
+                    addFeatureStateVertexRange(featureStateRanges, ranges[i], start);
+                }
+            }
+        }
+    }
+
+    bool updateVertexVectors(const FeatureStateChanges& changes, const GeometryTileLayer& layer) override {
+        bool updated = false;
+        for (const auto& change : changes) {
+            auto it = featureStateRanges.find(change.featureID);
+            if (it == featureStateRanges.end()) {
+                continue;
+            }
+            for (const auto& range : it->second) {
+                if (range.index >= layer.featureCount()) {
+                    continue;
+                }
+                auto evaluated = function.evaluate(*layer.getFeature(range.index), change.state, defaultValue);
+                this->statistics.add(evaluated);
+                vertexVector.fill(range.start, range.end, BaseVertex { attributeValue(evaluated) });
+                dirtyRanges.push_back(range);
+                updated = true;
+            }
+        }
+        return updated;
+    }
+
     void upload(gl::Context& context) override {
-        vertexBuffer = context.createVertexBuffer(std::move(vertexVector));
+        if (featureStateRanges.empty()) {
+            if (!vertexBuffer) {
+                vertexBuffer = context.createVertexBuffer(std::move(vertexVector));
+            }
+        } else if (!vertexBuffer) {
+            // Keep the vertices, so they can be rewritten when feature states change.
+            vertexBuffer = context.createVertexBuffer(gl::VertexVector<BaseVertex>(vertexVector));
+        } else {
+            for (const auto& range : dirtyRanges) {
+                context.updateVertexBuffer(*vertexBuffer, vertexVector, range.start, range.end);
+            }
+        }
+        dirtyRanges.clear();
     }
 
     optional<AttributeBinding> attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const override {
@@ -172,6 +289,9 @@ public:
 private:
     style::SourceFunction<T> function;
     T defaultValue;
+    bool usesFeatureState;
+    FeatureStateVertexRanges featureStateRanges;
+    std::vector<FeatureStateVertexRange> dirtyRanges;
     gl::VertexVector<BaseVertex> vertexVector;
     optional<gl::VertexBuffer<BaseVertex>> vertexBuffer;
 };
@@ -190,7 +310,8 @@ public:
     CompositeFunctionPaintPropertyBinder(style::CompositeFunction<T> function_, float zoom, T defaultValue_)
         : function(std::move(function_)),
           defaultValue(std::move(defaultValue_)),
-          zoomRange({zoom, zoom + 1}) {
+          zoomRange({zoom, zoom + 1}),
+          usesFeatureState(!function.isFeatureStateConstant()) {
     }
 
     void populateVertexVector(const GeometryTileFeature& feature, std::size_t length) override {
@@ -205,8 +326,74 @@ public:
         }
     }
 
+    void populateVertexVectors(const std::vector<FeatureVertexRange>& ranges) override {
+        if (ranges.empty()) {
+            return;
+        }
+
+        std::vector<const GeometryTileFeature*> features;
+        features.reserve(ranges.size());
+        for (const auto& range : ranges) {
+            features.push_back(range.feature);
+        }
+
+        const std::vector<Range<T>> evaluated = function.evaluate(zoomRange, features, defaultValue);
+        vertexVector.reserve(ranges.back().vertexEnd);
+        for (std::size_t i = 0; i < ranges.size(); i++) {
+            this->statistics.add(evaluated[i].min);
+            this->statistics.add(evaluated[i].max);
+            const std::size_t start = vertexVector.vertexSize();
+            if (ranges[i].vertexEnd > start) {
+                AttributeValue value = zoomInterpolatedAttributeValue(
+                    attributeValue(evaluated[i].min),
+                    attributeValue(evaluated[i].max));
+                vertexVector.resize(ranges[i].vertexEnd, Vertex { value });
+                if (usesFeatureState) {
+                    addFeatureStateVertexRange(featureStateRanges, ranges[i], start);
+                }
+            }
+        }
+    }
+
+    bool updateVertexVectors(const FeatureStateChanges& changes, const GeometryTileLayer& layer) override {
+        bool updated = false;
+        for (const auto& change : changes) {
+            auto it = featureStateRanges.find(change.featureID);
+            if (it == featureStateRanges.end()) {
+                continue;
+            }
+            for (const auto& range : it->second) {
+                if (range.index >= layer.featureCount()) {
+                    continue;
+                }
+                Range<T> evaluated = function.evaluate(zoomRange, *layer.getFeature(range.index), change.state, defaultValue);
+                this->statistics.add(evaluated.min);
+                this->statistics.add(evaluated.max);
+                AttributeValue value = zoomInterpolatedAttributeValue(
+                    attributeValue(evaluated.min),
+                    attributeValue(evaluated.max));
+                vertexVector.fill(range.start, range.end, Vertex { value });
+                dirtyRanges.push_back(range);
+                updated = true;
+            }
+        }
+        return updated;
+    }
+
     void upload(gl::Context& context) override {
-        vertexBuffer = context.createVertexBuffer(std::move(vertexVector));
+        if (featureStateRanges.empty()) {
+            if (!vertexBuffer) {
+                vertexBuffer = context.createVertexBuffer(std::move(vertexVector));
+            }
+        } else if (!vertexBuffer) {
+            // Keep the vertices, so they can be rewritten when feature states change.
+            vertexBuffer = context.createVertexBuffer(gl::VertexVector<Vertex>(vertexVector));
+        } else {
+            for (const auto& range : dirtyRanges) {
+                context.updateVertexBuffer(*vertexBuffer, vertexVector, range.start, range.end);
+            }
+        }
+        dirtyRanges.clear();
     }
 
     optional<AttributeBinding> attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const override {
@@ -238,6 +425,9 @@ private:
     style::CompositeFunction<T> function;
     T defaultValue;
     Range<float> zoomRange;
+    bool usesFeatureState;
+    FeatureStateVertexRanges featureStateRanges;
+    std::vector<FeatureStateVertexRange> dirtyRanges;
     gl::VertexVector<Vertex> vertexVector;
     optional<gl::VertexBuffer<Vertex>> vertexBuffer;
 };
@@ -300,6 +490,20 @@ public:
         });
     }
 
+    void populateVertexVectors(const std::vector<FeatureVertexRange>& ranges) {
+        util::ignore({
+            (binders.template get<Ps>()->populateVertexVectors(ranges), 0)...
+        });
+    }
+
+    bool updateVertexVectors(const FeatureStateChanges& changes, const GeometryTileLayer& layer) {
+        bool updated = false;
+        util::ignore({
+            (updated |= binders.template get<Ps>()->updateVertexVectors(changes, layer), 0)...
+        });
+        return updated;
+    }
+
     void upload(gl::Context& context) {
         util::ignore({
             (binders.template get<Ps>()->upload(context), 0)...
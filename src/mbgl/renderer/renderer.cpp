@@ -89,10 +89,24 @@ std::vector<Feature> Renderer::querySourceFeatures(const std::string& sourceID,
     return impl->querySourceFeatures(sourceID, options);
 }
 
+void Renderer::setFeatureState(const std::string& sourceID, const std::string& sourceLayerID,
+                               const std::string& featureID, const FeatureState& state) {
+    impl->setFeatureState(sourceID, sourceLayerID, featureID, state);
+}
+
+FeatureState Renderer::getFeatureState(const std::string& sourceID, const std::string& sourceLayerID,
+                                       const std::string& featureID) const {
+    return impl->getFeatureState(sourceID, sourceLayerID, featureID);
+}
+
 void Renderer::dumpDebugLogs() {
     impl->dumDebugLogs();
 }
 
+FrameStatistics Renderer::getLastFrameStatistics() const {
+    return impl->lastFrameStatistics;
+}
+
 void Renderer::onLowMemory() {
     BackendScope guard { impl->backend };
     impl->onLowMemory();
@@ -1,3 +1,6 @@
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/actor/message.hpp>
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/annotation/annotation_manager.hpp>
 #include <mbgl/renderer/renderer_impl.hpp>
 #include <mbgl/renderer/renderer_backend.hpp>
@@ -14,6 +17,7 @@
 #include <mbgl/renderer/layers/render_background_layer.hpp>
 #include <mbgl/renderer/layers/render_custom_layer.hpp>
 #include <mbgl/renderer/layers/render_fill_extrusion_layer.hpp>
+#include <mbgl/renderer/layers/render_symbol_layer.hpp>
 #include <mbgl/renderer/style_diff.hpp>
 #include <mbgl/renderer/query.hpp>
 #include <mbgl/renderer/backend_scope.hpp>
@@ -28,6 +32,13 @@
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
 namespace mbgl {
 
 using namespace style;
@@ -37,6 +48,84 @@ static RendererObserver& nullObserver() {
     return observer;
 }
 
+namespace {
+
+// A batch of independent jobs that any number of threads can work on at once. Jobs are
+// claimed through a shared counter, so the batch completes even if only one thread ever
+// gets to it.
+class JobBatch {
+public:
+    JobBatch(std::vector<std::function<void()>> jobs_)
+        : jobs(std::move(jobs_)) {
+    }
+
+    void run() {
+        for (std::size_t i = next++; i < jobs.size(); i = next++) {
+            jobs[i]();
+            std::lock_guard<std::mutex> lock(mutex);
+            if (++finished == jobs.size()) {
+                cv.notify_all();
+            }
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return finished == jobs.size(); });
+    }
+
+    std::size_t size() const {
+        return jobs.size();
+    }
+
+private:
+    std::vector<std::function<void()>> jobs;
+    std::atomic<std::size_t> next { 0 };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t finished = 0;
+};
+
+class JobBatchMessage : public Message {
+public:
+    JobBatchMessage(std::shared_ptr<JobBatch> batch_)
+        : batch(std::move(batch_)) {
+    }
+
+    void operator()() override {
+        batch->run();
+    }
+
+private:
+    std::shared_ptr<JobBatch> batch;
+};
+
+} // namespace
+
+// Runs the jobs on the scheduler's threads and on the calling thread, and returns once all
+// of them have finished. The calling thread never waits for a job that hasn't been started,
+// so this can't deadlock when the workers are busy or the scheduler is this thread's own.
+static void runJobs(Scheduler& scheduler, std::vector<std::function<void()>> jobs) {
+    if (jobs.empty()) {
+        return;
+    }
+
+    auto batch = std::make_shared<JobBatch>(std::move(jobs));
+
+    const std::size_t helpers = std::min<std::size_t>(batch->size() - 1, std::thread::hardware_concurrency());
+    std::vector<std::shared_ptr<Mailbox>> mailboxes;
+    for (std::size_t i = 0; i < helpers; i++) {
+        mailboxes.push_back(std::make_shared<Mailbox>(scheduler));
+        mailboxes.back()->push(std::make_unique<JobBatchMessage>(batch));
+    }
+
+    batch->run();
+    batch->wait();
+
+    // Messages that no worker has picked up yet are dropped along with their mailboxes.
+}
+
 Renderer::Impl::Impl(RendererBackend& backend_,
                      float pixelRatio_,
                      FileSource& fileSource_,
@@ -117,7 +206,8 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
         updateParameters.annotationManager,
         *imageManager,
         *glyphManager,
-        updateParameters.prefetchZoomDelta
+        updateParameters.prefetchZoomDelta,
+        updateParameters.rasterTextureFormat
     };
 
     glyphManager->setURL(updateParameters.glyphURL);
@@ -323,6 +413,15 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
 
         const bool symbolLayer = layer->is<RenderSymbolLayer>();
 
+        const LayerFeatureStates* layerFeatureStates = nullptr;
+        const auto sourceFeatureStates = featureStates.find(layer->baseImpl->source);
+        if (sourceFeatureStates != featureStates.end()) {
+            const auto it = sourceFeatureStates->second.find(layer->baseImpl->sourceLayer);
+            if (it != sourceFeatureStates->second.end()) {
+                layerFeatureStates = &it->second;
+            }
+        }
+
         auto sortedTiles = source->getRenderTiles();
         if (symbolLayer) {
             // Sort symbol tiles in opposite y position, so tiles with overlapping symbols are drawn
@@ -368,6 +467,10 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
                 }
             }
 
+            if (layerFeatureStates) {
+                tile.tile.setFeatureStates(*layer->baseImpl, *layerFeatureStates);
+            }
+
             auto bucket = tile.tile.getBucket(*layer->baseImpl);
             if (bucket) {
                 sortedTilesForInsertion.emplace_back(tile);
@@ -406,6 +509,23 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
         }
     }
 
+    // - LINE LABEL PASS ---------------------------------------------------------------------------
+    // Reprojects labels placed along lines for the current camera. Tiles are spread over the
+    // worker threads; tiles whose camera hasn't changed since the last frame are skipped.
+    {
+        std::vector<std::function<void()>> jobs;
+        for (auto& item : order) {
+            if (RenderSymbolLayer* symbolLayer = item.layer.as<RenderSymbolLayer>()) {
+                symbolLayer->prepareLineLabels(parameters, jobs);
+            }
+        }
+        runJobs(scheduler, std::move(jobs));
+    }
+
+    // Everything from here on issues draw calls; count them and time their submission.
+    const TimePoint submissionStart = Clock::now();
+    parameters.context.resetDrawCalls();
+
     // - 3D PASS -------------------------------------------------------------------------------------
     // Renders any 3D layers bottom-to-top to unique FBOs with texture attachments, but share the same
     // depth rbo between them.
@@ -605,6 +725,9 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
         parameters.context.bindVertexArray = 0;
     }
 
+    lastFrameStatistics.drawCalls = parameters.context.getDrawCalls();
+    lastFrameStatistics.submissionTime = Clock::now() - submissionStart;
+
     observer->onDidFinishRenderingFrame(
         loaded ? RendererObserver::RenderMode::Full : RendererObserver::RenderMode::Partial,
         updateParameters.mode == MapMode::Continuous && (hasTransitions() || frameHistory.needsAnimation(util::DEFAULT_TRANSITION_DURATION))
@@ -695,6 +818,29 @@ std::vector<Feature> Renderer::Impl::querySourceFeatures(const std::string& sour
     return source->querySourceFeatures(options);
 }
 
+void Renderer::Impl::setFeatureState(const std::string& sourceID,
+                                     const std::string& sourceLayerID,
+                                     const std::string& featureID,
+                                     const FeatureState& state) {
+    featureStates[sourceID][sourceLayerID].set(featureID, state);
+    observer->onInvalidate();
+}
+
+FeatureState Renderer::Impl::getFeatureState(const std::string& sourceID,
+                                             const std::string& sourceLayerID,
+                                             const std::string& featureID) const {
+    const auto source = featureStates.find(sourceID);
+    if (source == featureStates.end()) {
+        return {};
+    }
+    const auto layer = source->second.find(sourceLayerID);
+    if (layer == source->second.end()) {
+        return {};
+    }
+    const FeatureState* feature = layer->second.get(featureID);
+    return feature ? *feature : FeatureState();
+}
+
 void Renderer::Impl::onLowMemory() {
     assert(BackendScope::exists());
     backend.getContext().performCleanup();
@@ -710,6 +856,10 @@ void Renderer::Impl::dumDebugLogs() {
     }
 
     imageManager->dumpDebugLogs();
+
+    Log::Info(Event::Render, "Last frame: %zu draw calls, submitted in %lld us",
+              lastFrameStatistics.drawCalls,
+              static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(lastFrameStatistics.submissionTime).count()));
 }
 
 RenderLayer* Renderer::Impl::getRenderLayer(const std::string& id) {
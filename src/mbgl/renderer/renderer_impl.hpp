@@ -5,15 +5,18 @@
 #include <mbgl/renderer/render_source_observer.hpp>
 #include <mbgl/renderer/render_light.hpp>
 #include <mbgl/renderer/frame_history.hpp>
+#include <mbgl/renderer/feature_states.hpp>
 #include <mbgl/style/image.hpp>
 #include <mbgl/style/source.hpp>
 #include <mbgl/style/layer.hpp>
 #include <mbgl/map/transform_state.hpp>
 #include <mbgl/map/zoom_history.hpp>
 #include <mbgl/text/glyph_manager_observer.hpp>
+#include <mbgl/util/feature.hpp>
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace mbgl {
@@ -51,6 +54,11 @@ public:
     std::vector<Feature> querySourceFeatures(const std::string& sourceID, const SourceQueryOptions&) const;
     std::vector<Feature> queryShapeAnnotations(const ScreenLineString&) const;
 
+    void setFeatureState(const std::string& sourceID, const std::string& sourceLayerID,
+                         const std::string& featureID, const FeatureState&);
+    FeatureState getFeatureState(const std::string& sourceID, const std::string& sourceLayerID,
+                                 const std::string& featureID) const;
+
     void onLowMemory();
     void dumDebugLogs();
 
@@ -108,7 +116,11 @@ private:
     std::unordered_map<std::string, std::unique_ptr<RenderLayer>> renderLayers;
     RenderLight renderLight;
 
+    std::unordered_map<std::string, SourceFeatureStates> featureStates;
+
     bool contextLost = false;
+
+    FrameStatistics lastFrameStatistics;
 };
 
 } // namespace mbgl
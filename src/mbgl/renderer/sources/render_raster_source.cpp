@@ -1,7 +1,9 @@
 #include <mbgl/renderer/sources/render_raster_source.hpp>
 #include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/renderer/tile_parameters.hpp>
 #include <mbgl/tile/raster_tile.hpp>
 #include <mbgl/algorithm/update_tile_masks.hpp>
+#include <mbgl/util/logging.hpp>
 
 namespace mbgl {
 
@@ -35,8 +37,9 @@ void RenderRasterSource::update(Immutable<style::Source::Impl> baseImpl_,
         return;
     }
 
-    if (tileURLTemplates != tileset->tiles) {
+    if (tileURLTemplates != tileset->tiles || textureFormat != parameters.rasterTextureFormat) {
         tileURLTemplates = tileset->tiles;
+        textureFormat = parameters.rasterTextureFormat;
 
         // TODO: this removes existing buckets, and will cause flickering.
         // Should instead refresh tile data in place.
@@ -86,7 +89,21 @@ void RenderRasterSource::onLowMemory() {
     tilePyramid.onLowMemory();
 }
 
+size_t RenderRasterSource::getTextureBytes() const {
+    size_t bytes = 0;
+    auto add = [&] (const Tile& tile) {
+        bytes += static_cast<const RasterTile&>(tile).getTextureBytes();
+    };
+    for (const auto& pair : tilePyramid.tiles) {
+        add(*pair.second);
+    }
+    tilePyramid.cache.forEach(add);
+    return bytes;
+}
+
 void RenderRasterSource::dumpDebugLogs() const {
+    Log::Info(Event::General, "RenderRasterSource::id: %s", baseImpl->id.c_str());
+    Log::Info(Event::General, "RenderRasterSource::textureBytes: %zu", getTextureBytes());
     tilePyramid.dumpDebugLogs();
 }
 
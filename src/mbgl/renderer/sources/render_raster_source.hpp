@@ -35,11 +35,15 @@ public:
     void onLowMemory() final;
     void dumpDebugLogs() const final;
 
+    // Texture memory used by the tiles of this source, including cached tiles.
+    size_t getTextureBytes() const;
+
 private:
     const style::RasterSource::Impl& impl() const;
 
     TilePyramid tilePyramid;
     optional<std::vector<std::string>> tileURLTemplates;
+    RasterTextureFormat textureFormat = RasterTextureFormat::RGBA;
 };
 
 template <>
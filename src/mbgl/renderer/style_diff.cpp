@@ -2,7 +2,8 @@
 #include <mbgl/style/layer_impl.hpp>
 #include <mbgl/util/immutable.hpp>
 #include <mbgl/util/variant.hpp>
-#include <mbgl/util/longest_common_subsequence.hpp>
+
+#include <algorithm>
 
 namespace mbgl {
 
@@ -16,28 +17,111 @@ StyleDifference<T> diff(const Immutable<std::vector<T>>& a,
         return result;
     }
 
-    std::vector<T> lcs;
+    auto changed = [&] (const T& before, const T& after) {
+        if (before.get() != after.get()) {
+            result.changed.emplace(after->id, StyleChange<T> { before, after });
+        }
+    };
+
+    // Most mutations replace a single element in place. Match the common prefix and
+    // suffix pairwise, so that only the part in between needs to be keyed.
+    std::size_t begin = 0;
+    std::size_t aEnd = a->size();
+    std::size_t bEnd = b->size();
 
-    longest_common_subsequence(a->begin(), a->end(), b->begin(), b->end(), std::back_inserter(lcs), eq);
+    while (begin < aEnd && begin < bEnd && eq((*a)[begin], (*b)[begin])) {
+        changed((*a)[begin], (*b)[begin]);
+        begin++;
+    }
 
-    auto aIt = a->begin();
-    auto bIt = b->begin();
-    auto lIt = lcs.begin();
+    while (begin < aEnd && begin < bEnd && eq((*a)[aEnd - 1], (*b)[bEnd - 1])) {
+        changed((*a)[aEnd - 1], (*b)[bEnd - 1]);
+        aEnd--;
+        bEnd--;
+    }
+
+    // Match the rest by identity first, which is cheap to compare and covers every
+    // element that was only moved, and by id for whatever is left.
+    std::vector<std::pair<const void*, std::size_t>> aByPointer;
+    aByPointer.reserve(aEnd - begin);
+    for (std::size_t i = begin; i < aEnd; i++) {
+        aByPointer.emplace_back((*a)[i].get(), i);
+    }
+    std::sort(aByPointer.begin(), aByPointer.end());
 
-    while (aIt != a->end() || bIt != b->end()) {
-        if (aIt != a->end() && (lIt == lcs.end() || !eq(*lIt, *aIt))) {
-            result.removed.emplace((*aIt)->id, *aIt);
-            aIt++;
-        } else if (bIt != b->end() && (lIt == lcs.end() || !eq(*lIt, *bIt))) {
-            result.added.emplace((*bIt)->id, *bIt);
-            bIt++;
+    // Pairs of matching elements, in the order of b.
+    std::vector<std::pair<std::size_t, std::size_t>> matches;
+    std::vector<bool> matched(aEnd - begin, false);
+    std::vector<std::size_t> unmatched;
+    for (std::size_t i = begin; i < bEnd; i++) {
+        const void* pointer = (*b)[i].get();
+        auto it = std::lower_bound(aByPointer.begin(), aByPointer.end(), std::make_pair(pointer, std::size_t(0)));
+        if (it != aByPointer.end() && it->first == pointer) {
+            matches.emplace_back(it->second, i);
+            matched[it->second - begin] = true;
         } else {
-            if (aIt->get() != bIt->get()) {
-                result.changed.emplace((*bIt)->id, StyleChange<T> { *aIt, *bIt });
+            matches.emplace_back(aEnd, i);
+            unmatched.push_back(matches.size() - 1);
+        }
+    }
+
+    if (!unmatched.empty()) {
+        std::unordered_map<std::string, std::size_t> aByID;
+        for (std::size_t i = begin; i < aEnd; i++) {
+            if (!matched[i - begin]) {
+                aByID.emplace((*a)[i]->id, i);
             }
-            aIt++;
-            bIt++;
-            lIt++;
+        }
+        for (std::size_t match : unmatched) {
+            const T& element = (*b)[matches[match].second];
+            auto it = aByID.find(element->id);
+            if (it != aByID.end() && eq((*a)[it->second], element)) {
+                matches[match].first = it->second;
+                matched[it->second - begin] = true;
+            } else {
+                result.added.emplace(element->id, element);
+            }
+        }
+        matches.erase(std::remove_if(matches.begin(), matches.end(), [&] (const auto& match) {
+            return match.first == aEnd;
+        }), matches.end());
+    }
+
+    for (std::size_t i = begin; i < aEnd; i++) {
+        if (!matched[i - begin]) {
+            result.removed.emplace((*a)[i]->id, (*a)[i]);
+        }
+    }
+
+    // Elements that kept their relative order are the longest increasing run of
+    // indices into a. Everything else moved, and is reported as removed and added,
+    // just like a longest common subsequence diff would.
+    std::vector<std::size_t> tails;
+    std::vector<std::size_t> previous(matches.size());
+    for (std::size_t i = 0; i < matches.size(); i++) {
+        auto it = std::lower_bound(tails.begin(), tails.end(), matches[i].first,
+            [&] (std::size_t match, std::size_t index) { return matches[match].first < index; });
+        previous[i] = it == tails.begin() ? matches.size() : *(it - 1);
+        if (it == tails.end()) {
+            tails.push_back(i);
+        } else {
+            *it = i;
+        }
+    }
+
+    std::vector<bool> kept(matches.size(), false);
+    for (std::size_t i = tails.empty() ? matches.size() : tails.back(); i != matches.size(); i = previous[i]) {
+        kept[i] = true;
+    }
+
+    for (std::size_t i = 0; i < matches.size(); i++) {
+        const T& before = (*a)[matches[i].first];
+        const T& after = (*b)[matches[i].second];
+        if (kept[i]) {
+            changed(before, after);
+        } else {
+            result.removed.emplace(before->id, before);
+            result.added.emplace(after->id, after);
         }
     }
 
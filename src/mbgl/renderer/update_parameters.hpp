@@ -35,6 +35,7 @@ public:
     AnnotationManager& annotationManager;
 
     const uint8_t prefetchZoomDelta;
+    const RasterTextureFormat rasterTextureFormat;
     
     // For still image requests, render requested
     const bool stillImageRequest;
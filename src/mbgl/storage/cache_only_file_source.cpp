@@ -0,0 +1,43 @@
+#include <mbgl/storage/cache_only_file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+CacheOnlyFileSource::CacheOnlyFileSource(FileSource& cache_)
+    : cache(cache_) {
+    assert(cache.supportsCacheOnlyRequests());
+}
+
+std::unique_ptr<AsyncRequest> CacheOnlyFileSource::request(const Resource& resource, Callback callback) {
+    Resource cacheOnly = resource;
+    cacheOnly.loadingMethod = Resource::LoadingMethod::CacheOnly;
+
+    return cache.request(cacheOnly, [url = resource.url, callback] (Response response) {
+        // A cache-only request that can't be satisfied is reported as NotFound, which callers
+        // take to mean that they should try the network next, or, for tiles, that there is
+        // no data. Neither is true here.
+        if (response.error && response.error->reason == Response::Error::Reason::NotFound) {
+            if (response.data) {
+                response.error.reset();
+            } else {
+                response.noContent = false;
+                response.error = std::make_unique<Response::Error>(
+                    Response::Error::Reason::Other, "Not found in cache: " + url);
+            }
+        }
+        callback(response);
+    });
+}
+
+void CacheOnlyFileSource::getTileSnapshot(const Resource& resource, uint64_t layersHash, SnapshotCallback callback) {
+    cache.getTileSnapshot(resource, layersHash, std::move(callback));
+}
+
+void CacheOnlyFileSource::putTileSnapshot(const Resource& resource, uint64_t layersHash, std::shared_ptr<const std::string> snapshot) {
+    cache.putTileSnapshot(resource, layersHash, std::move(snapshot));
+}
+
+} // namespace mbgl
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+
+namespace mbgl {
+
+// Serves tiles from local MBTiles archives. mbtiles:///path/to/archive.mbtiles returns TileJSON
+// for the archive, whose tiles are at mbtiles:///path/to/archive.mbtiles/{z}/{x}/{y}.
+//
+// Tiles are looked up on the thread that requests them; only the response is delivered
+// asynchronously.
+class MBTilesFileSource : public FileSource {
+public:
+    MBTilesFileSource();
+    ~MBTilesFileSource() override;
+
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+
+    static bool acceptsURL(const std::string& url);
+
+private:
+    class Impl;
+
+    const std::unique_ptr<Impl> impl;
+};
+
+} // namespace mbgl
@@ -0,0 +1,997 @@
+#include <mbgl/style/expression/compiled_expression.hpp>
+#include <mbgl/style/expression/assertion.hpp>
+#include <mbgl/style/expression/case.hpp>
+#include <mbgl/style/expression/coalesce.hpp>
+#include <mbgl/style/expression/coercion.hpp>
+#include <mbgl/style/expression/compound_expression.hpp>
+#include <mbgl/style/expression/interpolate.hpp>
+#include <mbgl/style/expression/is_constant.hpp>
+#include <mbgl/style/expression/match.hpp>
+#include <mbgl/style/expression/step.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/math/log2.hpp>
+#include <mbgl/util/interpolate.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+namespace expression {
+
+namespace {
+
+// Expressions that need more registers than this fall back to tree evaluation.
+constexpr std::size_t maxRegisters = 16;
+
+enum class OpCode : uint8_t {
+    // Write number register dst. Booleans are stored as 0 or 1.
+    LoadNumber,          // numbers[operand]
+    LoadZoom,
+    LoadHeatmapDensity,
+    HasProperty,         // whether the feature has property strings[operand]
+    Add,                 // n[a] op n[b]
+    Subtract,
+    Multiply,
+    Divide,
+    Modulo,
+    Power,
+    Min,
+    Max,
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    Negate,              // op n[a]
+    Not,
+    Sqrt,
+    Log10,
+    Ln,
+    Log2,
+    Sin,
+    Cos,
+    Tan,
+    Asin,
+    Acos,
+    Atan,
+    ValueEqual,          // v[a] op v[b]
+    ValueNotEqual,
+    StringLess,
+    StringLessEqual,
+    StringGreater,
+    StringGreaterEqual,
+    LerpNumber,          // interpolate(n[a], n[b], n[operand])
+
+    // Write value register dst.
+    LoadValue,           // values[operand]
+    GetProperty,         // property strings[operand] of the feature
+    BoxNumber,           // n[a]
+    BoxBoolean,          // n[a]
+    ToString,            // ["to-string", v[a]]
+    LerpColor,           // interpolate(v[a], v[b], n[operand])
+
+    // Stores v[a] in dst and jumps to operand if it has the asserted type. Otherwise
+    // falls through to the next input, or fails if this was the last one (b != 0).
+    AssertNumber,
+    AssertBoolean,
+    AssertString,
+    ToNumber,            // The same for ["to-number", ...], with n[dst] = the converted v[a].
+
+    // Control flow. Jump targets are instruction indices.
+    Jump,                // to operand
+    JumpIfFalse,         // to operand if !n[a]
+    JumpIfNotNull,       // to operand if v[a] isn't null
+    Step,                // to the step steps[operand] selects for n[a]
+    Interpolate,         // to the branch interpolations[operand] selects for n[a]; n[dst] = t
+    MatchString,         // to the branch matches[operand] selects for v[a]
+    MatchInteger,        // to the branch matches[operand] selects for n[a]
+    Fail                 // with message strings[operand]
+};
+
+struct Instruction {
+    OpCode op;
+    uint16_t dst;
+    uint16_t a;
+    uint16_t b;
+    uint32_t operand;
+};
+
+struct StepTable {
+    std::vector<double> inputs;
+    std::vector<uint32_t> targets;
+};
+
+// `single` evaluates just one stop, for inputs at or outside of a stop. `pairs` evaluates
+// two adjacent stops and interpolates between them.
+struct InterpolateTable {
+    InterpolateBase::Interpolator interpolator;
+    std::vector<double> inputs;
+    std::vector<uint32_t> single;
+    std::vector<uint32_t> pairs;
+};
+
+struct MatchTable {
+    std::unordered_map<std::string, uint32_t> strings;
+    std::unordered_map<int64_t, uint32_t> integers;
+    uint32_t otherwise = 0;
+};
+
+enum class Kind : uint8_t {
+    Number,
+    Value
+};
+
+struct Register {
+    Kind kind;
+    uint16_t index;
+};
+
+Kind kindOf(const type::Type& type) {
+    return type.is<type::NumberType>() || type.is<type::BooleanType>() ? Kind::Number : Kind::Value;
+}
+
+} // namespace
+
+class CompiledExpression::Impl {
+public:
+    Impl(type::Type type_) : type(std::move(type_)) {}
+
+    const type::Type type;
+
+    std::vector<Instruction> code;
+    std::vector<double> numbers;
+    std::vector<Value> values;
+    std::vector<std::string> strings;
+    std::vector<StepTable> steps;
+    std::vector<InterpolateTable> interpolations;
+    std::vector<MatchTable> matches;
+};
+
+namespace {
+
+class Compiler {
+public:
+    Compiler(CompiledExpression::Impl& program_) : program(program_) {}
+
+    optional<Register> allocate(Kind kind) {
+        uint16_t& count = used[static_cast<std::size_t>(kind)];
+        if (count == maxRegisters) {
+            return {};
+        }
+        return Register { kind, count++ };
+    }
+
+    bool compile(const Expression& expression, Register dst) {
+        // Registers allocated while compiling a subexpression are free again once it's done.
+        const auto saved = used;
+        const bool result = compileExpression(expression, dst);
+        used = saved;
+        return result;
+    }
+
+private:
+    bool compileExpression(const Expression& expression, Register dst) {
+        if (isFeatureConstant(expression) &&
+            isGlobalPropertyConstant(expression, std::array<std::string, 2> {{ "zoom", "heatmap-density" }})) {
+            return compileConstant(expression, dst);
+        }
+
+        if (auto compound = dynamic_cast<const CompoundExpressionBase*>(&expression)) {
+            return compileCompound(*compound, dst);
+        } else if (auto assertion = dynamic_cast<const Assertion*>(&expression)) {
+            return compileAssertion(*assertion, dst);
+        } else if (auto coercion = dynamic_cast<const Coercion*>(&expression)) {
+            return compileCoercion(*coercion, dst);
+        } else if (auto step = dynamic_cast<const Step*>(&expression)) {
+            return compileStep(*step, dst);
+        } else if (auto interpolate = dynamic_cast<const Interpolate<double>*>(&expression)) {
+            return compileInterpolate(*interpolate, OpCode::LerpNumber, dst);
+        } else if (auto interpolateColor = dynamic_cast<const Interpolate<Color>*>(&expression)) {
+            return compileInterpolate(*interpolateColor, OpCode::LerpColor, dst);
+        } else if (auto match = dynamic_cast<const Match<std::string>*>(&expression)) {
+            return compileMatch(*match, dst);
+        } else if (auto matchInteger = dynamic_cast<const Match<int64_t>*>(&expression)) {
+            return compileMatch(*matchInteger, dst);
+        } else if (auto caseExpression = dynamic_cast<const Case*>(&expression)) {
+            return compileCase(*caseExpression, dst);
+        } else if (auto coalesce = dynamic_cast<const Coalesce*>(&expression)) {
+            return compileCoalesce(*coalesce, dst);
+        }
+
+        return false;
+    }
+
+    // Compiles an expression into a register of the given kind, boxing numbers and
+    // booleans if a Value register is wanted.
+    bool compileAs(const Expression& expression, Register dst) {
+        const Kind kind = kindOf(expression.getType());
+        if (kind == dst.kind) {
+            return compile(expression, dst);
+        }
+        if (dst.kind == Kind::Number) {
+            return false;
+        }
+
+        const auto saved = used;
+        optional<Register> number = allocate(Kind::Number);
+        const bool result = number && compile(expression, *number);
+        if (result) {
+            emit(expression.getType().is<type::BooleanType>() ? OpCode::BoxBoolean : OpCode::BoxNumber,
+                 dst.index, number->index);
+        }
+        used = saved;
+        return result;
+    }
+
+    bool compileConstant(const Expression& expression, Register dst) {
+        const EvaluationResult result = expression.evaluate(EvaluationContext(optional<float>(), nullptr, optional<double>()));
+        if (!result) {
+            emitFail(result.error().message);
+            return true;
+        }
+
+        if (dst.kind == Kind::Value) {
+            program.values.push_back(*result);
+            emit(OpCode::LoadValue, dst.index, 0, 0, program.values.size() - 1);
+            return true;
+        }
+
+        if (result->is<double>()) {
+            program.numbers.push_back(result->get<double>());
+        } else if (result->is<bool>()) {
+            program.numbers.push_back(result->get<bool>() ? 1 : 0);
+        } else {
+            return false;
+        }
+        emit(OpCode::LoadNumber, dst.index, 0, 0, program.numbers.size() - 1);
+        return true;
+    }
+
+    // Resolves the literal key of a ["get", key] or ["has", key] expression.
+    optional<uint32_t> compileKey(const Expression& key) {
+        if (!isFeatureConstant(key) || !isZoomConstant(key)) {
+            return {};
+        }
+        const EvaluationResult result = key.evaluate(EvaluationContext(optional<float>(), nullptr, optional<double>()));
+        if (!result || !result->is<std::string>()) {
+            return {};
+        }
+        program.strings.push_back(result->get<std::string>());
+        return program.strings.size() - 1;
+    }
+
+    bool compileCompound(const CompoundExpressionBase& expression, Register dst) {
+        static const std::unordered_map<std::string, OpCode> unary {
+            { "-", OpCode::Negate },
+            { "!", OpCode::Not },
+            { "sqrt", OpCode::Sqrt },
+            { "log10", OpCode::Log10 },
+            { "ln", OpCode::Ln },
+            { "log2", OpCode::Log2 },
+            { "sin", OpCode::Sin },
+            { "cos", OpCode::Cos },
+            { "tan", OpCode::Tan },
+            { "asin", OpCode::Asin },
+            { "acos", OpCode::Acos },
+            { "atan", OpCode::Atan }
+        };
+        static const std::unordered_map<std::string, OpCode> binary {
+            { "-", OpCode::Subtract },
+            { "/", OpCode::Divide },
+            { "%", OpCode::Modulo },
+            { "^", OpCode::Power }
+        };
+        // Varargs operators start from their identity element.
+        static const std::unordered_map<std::string, std::pair<OpCode, double>> varargs {
+            { "+", { OpCode::Add, 0.0 } },
+            { "*", { OpCode::Multiply, 1.0 } },
+            { "min", { OpCode::Min, std::numeric_limits<double>::infinity() } },
+            { "max", { OpCode::Max, -std::numeric_limits<double>::infinity() } }
+        };
+        static const std::unordered_map<std::string, std::pair<OpCode, OpCode>> comparisons {
+            { "==", { OpCode::Equal, OpCode::ValueEqual } },
+            { "!=", { OpCode::NotEqual, OpCode::ValueNotEqual } },
+            { "<", { OpCode::Less, OpCode::StringLess } },
+            { "<=", { OpCode::LessEqual, OpCode::StringLessEqual } },
+            { ">", { OpCode::Greater, OpCode::StringGreater } },
+            { ">=", { OpCode::GreaterEqual, OpCode::StringGreaterEqual } }
+        };
+
+        const std::string name = expression.getName();
+        std::vector<const Expression*> args;
+        expression.eachChild([&](const Expression& child) { args.push_back(&child); });
+
+        if (name == "zoom" && args.empty()) {
+            emit(OpCode::LoadZoom, dst.index);
+            return dst.kind == Kind::Number;
+        } else if (name == "heatmap-density" && args.empty()) {
+            emit(OpCode::LoadHeatmapDensity, dst.index);
+            return dst.kind == Kind::Number;
+        } else if ((name == "get" || name == "has") && args.size() == 1) {
+            optional<uint32_t> key = compileKey(*args[0]);
+            if (!key) {
+                return false;
+            }
+            if (name == "get") {
+                emit(OpCode::GetProperty, dst.index, 0, 0, *key);
+                return dst.kind == Kind::Value;
+            } else {
+                emit(OpCode::HasProperty, dst.index, 0, 0, *key);
+                return dst.kind == Kind::Number;
+            }
+        } else if (name == "to-string" && args.size() == 1) {
+            if (dst.kind != Kind::Value || !compile(*args[0], dst)) {
+                return false;
+            }
+            emit(OpCode::ToString, dst.index, dst.index);
+            return true;
+        }
+
+        if (dst.kind != Kind::Number) {
+            return false;
+        }
+
+        auto it = unary.find(name);
+        if (it != unary.end() && args.size() == 1) {
+            if (!compileAs(*args[0], dst)) {
+                return false;
+            }
+            emit(it->second, dst.index, dst.index);
+            return true;
+        }
+
+        it = binary.find(name);
+        if (it != binary.end() && args.size() == 2) {
+            return compileBinary(it->second, *args[0], *args[1], dst);
+        }
+
+        auto vararg = varargs.find(name);
+        if (vararg != varargs.end()) {
+            program.numbers.push_back(vararg->second.second);
+            emit(OpCode::LoadNumber, dst.index, 0, 0, program.numbers.size() - 1);
+
+            const auto saved = used;
+            optional<Register> operand = allocate(Kind::Number);
+            for (const Expression* arg : args) {
+                if (!operand || !compileAs(*arg, *operand)) {
+                    return false;
+                }
+                emit(vararg->second.first, dst.index, dst.index, operand->index);
+            }
+            used = saved;
+            return true;
+        }
+
+        auto comparison = comparisons.find(name);
+        if (comparison != comparisons.end() && args.size() == 2) {
+            const Kind kind = kindOf(args[0]->getType());
+            if (kind != kindOf(args[1]->getType())) {
+                return false;
+            }
+            if (kind == Kind::Number) {
+                return compileBinary(comparison->second.first, *args[0], *args[1], dst);
+            }
+
+            const auto saved = used;
+            optional<Register> lhs = allocate(Kind::Value);
+            optional<Register> rhs = allocate(Kind::Value);
+            if (!lhs || !rhs || !compile(*args[0], *lhs) || !compile(*args[1], *rhs)) {
+                return false;
+            }
+            emit(comparison->second.second, dst.index, lhs->index, rhs->index);
+            used = saved;
+            return true;
+        }
+
+        return false;
+    }
+
+    // Evaluates the left operand straight into dst, so only the right one needs a register.
+    bool compileBinary(OpCode op, const Expression& lhs, const Expression& rhs, Register dst) {
+        const auto saved = used;
+        optional<Register> operand = allocate(Kind::Number);
+        if (!operand || !compileAs(lhs, dst) || !compileAs(rhs, *operand)) {
+            return false;
+        }
+        emit(op, dst.index, dst.index, operand->index);
+        used = saved;
+        return true;
+    }
+
+    bool compileAssertion(const Assertion& assertion, Register dst) {
+        const type::Type& type = assertion.getType();
+        OpCode op;
+        if (type.is<type::NumberType>()) {
+            op = OpCode::AssertNumber;
+        } else if (type.is<type::BooleanType>()) {
+            op = OpCode::AssertBoolean;
+        } else if (type.is<type::StringType>()) {
+            op = OpCode::AssertString;
+        } else {
+            return false;
+        }
+
+        std::vector<const Expression*> inputs;
+        assertion.eachChild([&](const Expression& child) { inputs.push_back(&child); });
+
+        const auto saved = used;
+        optional<Register> value = allocate(Kind::Value);
+        if (!value) {
+            return false;
+        }
+
+        std::vector<uint32_t> exits;
+        for (std::size_t i = 0; i < inputs.size(); i++) {
+            if (!compileAs(*inputs[i], *value)) {
+                return false;
+            }
+            exits.push_back(emit(op, dst.index, value->index, i == inputs.size() - 1));
+        }
+        patch(exits);
+        used = saved;
+        return true;
+    }
+
+    // Only ["to-number", ...] is compiled; ["to-color", ...] is left to the tree evaluator.
+    bool compileCoercion(const Coercion& coercion, Register dst) {
+        if (!coercion.getType().is<type::NumberType>()) {
+            return false;
+        }
+
+        std::vector<const Expression*> inputs;
+        coercion.eachChild([&](const Expression& child) { inputs.push_back(&child); });
+
+        const auto saved = used;
+        optional<Register> value = allocate(Kind::Value);
+        if (!value) {
+            return false;
+        }
+
+        std::vector<uint32_t> exits;
+        for (std::size_t i = 0; i < inputs.size(); i++) {
+            if (!compileAs(*inputs[i], *value)) {
+                return false;
+            }
+            exits.push_back(emit(OpCode::ToNumber, dst.index, value->index, i == inputs.size() - 1));
+        }
+        patch(exits);
+        used = saved;
+        return true;
+    }
+
+    bool compileStep(const Step& step, Register dst) {
+        const auto saved = used;
+        optional<Register> input = allocate(Kind::Number);
+        if (!input || !compileAs(*step.getInput(), *input)) {
+            return false;
+        }
+        used = saved;
+
+        const auto& stops = step.getStops();
+        if (stops.empty()) {
+            emitFail("No stops in step curve.");
+            return true;
+        }
+
+        const uint32_t table = program.steps.size();
+        program.steps.emplace_back();
+        emit(OpCode::Step, 0, input->index, 0, table);
+
+        StepTable result;
+        std::vector<uint32_t> exits;
+        for (const auto& stop : stops) {
+            result.inputs.push_back(stop.first);
+            result.targets.push_back(here());
+            if (!compileAs(*stop.second, dst)) {
+                return false;
+            }
+            exits.push_back(emit(OpCode::Jump));
+        }
+        patch(exits);
+        program.steps[table] = std::move(result);
+        return true;
+    }
+
+    bool compileInterpolate(const InterpolateBase& interpolate, OpCode lerp, Register dst) {
+        const auto saved = used;
+        optional<Register> input = allocate(Kind::Number);
+        optional<Register> t = allocate(Kind::Number);
+        if (!input || !t || !compileAs(*interpolate.getInput(), *input)) {
+            return false;
+        }
+
+        const auto& stops = interpolate.getStops();
+        if (stops.empty()) {
+            emitFail("No stops in exponential curve.");
+            used = saved;
+            return true;
+        }
+
+        const uint32_t table = program.interpolations.size();
+        program.interpolations.push_back({ interpolate.getInterpolator(), {}, {}, {} });
+        emit(OpCode::Interpolate, t->index, input->index, 0, table);
+
+        InterpolateTable result { interpolate.getInterpolator(), {}, {}, {} };
+        std::vector<uint32_t> exits;
+        for (const auto& stop : stops) {
+            result.inputs.push_back(stop.first);
+            result.single.push_back(here());
+            if (!compileAs(*stop.second, dst)) {
+                return false;
+            }
+            exits.push_back(emit(OpCode::Jump));
+        }
+
+        optional<Register> lower = allocate(dst.kind);
+        optional<Register> upper = allocate(dst.kind);
+        if (!lower || !upper) {
+            return false;
+        }
+        for (auto it = stops.begin(); std::next(it) != stops.end(); ++it) {
+            result.pairs.push_back(here());
+            if (!compileAs(*it->second, *lower) || !compileAs(*std::next(it)->second, *upper)) {
+                return false;
+            }
+            emit(lerp, dst.index, lower->index, upper->index, t->index);
+            exits.push_back(emit(OpCode::Jump));
+        }
+        patch(exits);
+        program.interpolations[table] = std::move(result);
+        used = saved;
+        return true;
+    }
+
+    template <typename T>
+    bool compileMatch(const Match<T>& match, Register dst) {
+        const bool strings = std::is_same<T, std::string>::value;
+
+        const auto saved = used;
+        optional<Register> input = allocate(strings ? Kind::Value : Kind::Number);
+        if (!input || !compileAs(*match.getInput(), *input)) {
+            return false;
+        }
+        used = saved;
+
+        const uint32_t table = program.matches.size();
+        program.matches.emplace_back();
+        emit(strings ? OpCode::MatchString : OpCode::MatchInteger, 0, input->index, 0, table);
+
+        // Several labels may share one output expression; it's compiled only once.
+        MatchTable result;
+        std::unordered_map<const Expression*, uint32_t> targets;
+        std::vector<uint32_t> exits;
+        for (const auto& branch : match.getBranches()) {
+            auto it = targets.find(branch.second.get());
+            if (it == targets.end()) {
+                it = targets.emplace(branch.second.get(), here()).first;
+                if (!compileAs(*branch.second, dst)) {
+                    return false;
+                }
+                exits.push_back(emit(OpCode::Jump));
+            }
+            addBranch(result, branch.first, it->second);
+        }
+
+        result.otherwise = here();
+        if (!compileAs(*match.getOtherwise(), dst)) {
+            return false;
+        }
+        patch(exits);
+        program.matches[table] = std::move(result);
+        return true;
+    }
+
+    static void addBranch(MatchTable& table, const std::string& label, uint32_t target) {
+        table.strings.emplace(label, target);
+    }
+
+    static void addBranch(MatchTable& table, int64_t label, uint32_t target) {
+        table.integers.emplace(label, target);
+    }
+
+    bool compileCase(const Case& caseExpression, Register dst) {
+        std::vector<const Expression*> children;
+        caseExpression.eachChild([&](const Expression& child) { children.push_back(&child); });
+
+        const auto saved = used;
+        optional<Register> test = allocate(Kind::Number);
+        if (!test) {
+            return false;
+        }
+
+        // Children are the test and output of each branch, followed by the fallback output.
+        std::vector<uint32_t> exits;
+        for (std::size_t i = 0; i + 1 < children.size(); i += 2) {
+            if (!compileAs(*children[i], *test)) {
+                return false;
+            }
+            const uint32_t skip = emit(OpCode::JumpIfFalse, 0, test->index);
+            if (!compileAs(*children[i + 1], dst)) {
+                return false;
+            }
+            exits.push_back(emit(OpCode::Jump));
+            patch({ skip });
+        }
+        if (!compileAs(*children.back(), dst)) {
+            return false;
+        }
+        patch(exits);
+        used = saved;
+        return true;
+    }
+
+    bool compileCoalesce(const Coalesce& coalesce, Register dst) {
+        if (dst.kind != Kind::Value) {
+            return false;
+        }
+
+        if (coalesce.getLength() == 0) {
+            program.values.push_back(Null);
+            emit(OpCode::LoadValue, dst.index, 0, 0, program.values.size() - 1);
+            return true;
+        }
+
+        std::vector<uint32_t> exits;
+        for (std::size_t i = 0; i < coalesce.getLength(); i++) {
+            if (!compileAs(*coalesce.getChild(i), dst)) {
+                return false;
+            }
+            exits.push_back(emit(OpCode::JumpIfNotNull, 0, dst.index));
+        }
+        patch(exits);
+        return true;
+    }
+
+    uint32_t emit(OpCode op, uint16_t dst = 0, uint16_t a = 0, uint16_t b = 0, uint32_t operand = 0) {
+        program.code.push_back({ op, dst, a, b, operand });
+        return program.code.size() - 1;
+    }
+
+    void emitFail(const std::string& message) {
+        program.strings.push_back(message);
+        emit(OpCode::Fail, 0, 0, 0, program.strings.size() - 1);
+    }
+
+    uint32_t here() const {
+        return program.code.size();
+    }
+
+    // Points the given jumps at the next instruction to be emitted.
+    void patch(const std::vector<uint32_t>& jumps) {
+        for (uint32_t jump : jumps) {
+            program.code[jump].operand = here();
+        }
+    }
+
+    CompiledExpression::Impl& program;
+    std::array<uint16_t, 2> used {{ 0, 0 }};
+};
+
+std::string typeError(const type::Type& expected, const Value& value) {
+    return "Expected value to be of type " + toString(expected) +
+           ", but found " + toString(typeOf(value)) + " instead.";
+}
+
+// Matches the "to-string" compound expression.
+std::string coerceToString(const Value& value) {
+    return value.match(
+        [](const Color& color) { return color.stringify(); },
+        [](const std::string& string) { return string; },
+        [](const auto& other) { return stringify(other); }
+    );
+}
+
+} // namespace
+
+CompiledExpression::CompiledExpression(std::unique_ptr<const Impl> impl_)
+    : impl(std::move(impl_)) {
+}
+
+CompiledExpression::~CompiledExpression() = default;
+
+std::unique_ptr<CompiledExpression> CompiledExpression::compile(const Expression& expression) {
+    auto program = std::make_unique<Impl>(expression.getType());
+    Compiler compiler(*program);
+
+    optional<Register> result = compiler.allocate(kindOf(expression.getType()));
+    if (!result || !compiler.compile(expression, *result)) {
+        return nullptr;
+    }
+    return std::unique_ptr<CompiledExpression>(new CompiledExpression(std::move(program)));
+}
+
+EvaluationResult CompiledExpression::evaluate(const EvaluationContext& params) const {
+    std::array<double, maxRegisters> n {};
+    std::array<Value, maxRegisters> v;
+
+    const std::vector<Instruction>& code = impl->code;
+    std::size_t pc = 0;
+    while (pc < code.size()) {
+        const Instruction& i = code[pc++];
+        switch (i.op) {
+        case OpCode::LoadNumber:
+            n[i.dst] = impl->numbers[i.operand];
+            break;
+        case OpCode::LoadZoom:
+            if (!params.zoom) {
+                return EvaluationError { "The 'zoom' expression is unavailable in the current evaluation context." };
+            }
+            n[i.dst] = *params.zoom;
+            break;
+        case OpCode::LoadHeatmapDensity:
+            if (!params.heatmapDensity) {
+                return EvaluationError { "The 'heatmap-density' expression is unavailable in the current evaluation context." };
+            }
+            n[i.dst] = *params.heatmapDensity;
+            break;
+        case OpCode::HasProperty:
+            if (!params.feature) {
+                return EvaluationError { "Feature data is unavailable in the current evaluation context." };
+            }
+            n[i.dst] = params.feature->getValue(impl->strings[i.operand]) ? 1 : 0;
+            break;
+        case OpCode::Add:
+            n[i.dst] = n[i.a] + n[i.b];
+            break;
+        case OpCode::Subtract:
+            n[i.dst] = n[i.a] - n[i.b];
+            break;
+        case OpCode::Multiply:
+            n[i.dst] = n[i.a] * n[i.b];
+            break;
+        case OpCode::Divide:
+            n[i.dst] = n[i.a] / n[i.b];
+            break;
+        case OpCode::Modulo:
+            n[i.dst] = std::fmod(n[i.a], n[i.b]);
+            break;
+        case OpCode::Power:
+            n[i.dst] = std::pow(n[i.a], n[i.b]);
+            break;
+        case OpCode::Min:
+            n[i.dst] = std::fmin(n[i.b], n[i.a]);
+            break;
+        case OpCode::Max:
+            n[i.dst] = std::fmax(n[i.b], n[i.a]);
+            break;
+        case OpCode::Equal:
+            n[i.dst] = n[i.a] == n[i.b];
+            break;
+        case OpCode::NotEqual:
+            n[i.dst] = n[i.a] != n[i.b];
+            break;
+        case OpCode::Less:
+            n[i.dst] = n[i.a] < n[i.b];
+            break;
+        case OpCode::LessEqual:
+            n[i.dst] = n[i.a] <= n[i.b];
+            break;
+        case OpCode::Greater:
+            n[i.dst] = n[i.a] > n[i.b];
+            break;
+        case OpCode::GreaterEqual:
+            n[i.dst] = n[i.a] >= n[i.b];
+            break;
+        case OpCode::Negate:
+            n[i.dst] = -n[i.a];
+            break;
+        case OpCode::Not:
+            n[i.dst] = !n[i.a];
+            break;
+        case OpCode::Sqrt:
+            n[i.dst] = std::sqrt(n[i.a]);
+            break;
+        case OpCode::Log10:
+            n[i.dst] = std::log10(n[i.a]);
+            break;
+        case OpCode::Ln:
+            n[i.dst] = std::log(n[i.a]);
+            break;
+        case OpCode::Log2:
+            n[i.dst] = util::log2(n[i.a]);
+            break;
+        case OpCode::Sin:
+            n[i.dst] = std::sin(n[i.a]);
+            break;
+        case OpCode::Cos:
+            n[i.dst] = std::cos(n[i.a]);
+            break;
+        case OpCode::Tan:
+            n[i.dst] = std::tan(n[i.a]);
+            break;
+        case OpCode::Asin:
+            n[i.dst] = std::asin(n[i.a]);
+            break;
+        case OpCode::Acos:
+            n[i.dst] = std::acos(n[i.a]);
+            break;
+        case OpCode::Atan:
+            n[i.dst] = std::atan(n[i.a]);
+            break;
+        case OpCode::ValueEqual:
+            n[i.dst] = v[i.a] == v[i.b];
+            break;
+        case OpCode::ValueNotEqual:
+            n[i.dst] = v[i.a] != v[i.b];
+            break;
+        case OpCode::StringLess:
+            n[i.dst] = v[i.a].get<std::string>() < v[i.b].get<std::string>();
+            break;
+        case OpCode::StringLessEqual:
+            n[i.dst] = v[i.a].get<std::string>() <= v[i.b].get<std::string>();
+            break;
+        case OpCode::StringGreater:
+            n[i.dst] = v[i.a].get<std::string>() > v[i.b].get<std::string>();
+            break;
+        case OpCode::StringGreaterEqual:
+            n[i.dst] = v[i.a].get<std::string>() >= v[i.b].get<std::string>();
+            break;
+        case OpCode::LerpNumber:
+            n[i.dst] = util::interpolate(n[i.a], n[i.b], n[i.operand]);
+            break;
+        case OpCode::LoadValue:
+            v[i.dst] = impl->values[i.operand];
+            break;
+        case OpCode::GetProperty: {
+            if (!params.feature) {
+                return EvaluationError { "Feature data is unavailable in the current evaluation context." };
+            }
+            auto propertyValue = params.feature->getValue(impl->strings[i.operand]);
+            if (propertyValue) {
+                v[i.dst] = toExpressionValue(*propertyValue);
+            } else {
+                v[i.dst] = Null;
+            }
+            break;
+        }
+        case OpCode::BoxNumber:
+            v[i.dst] = n[i.a];
+            break;
+        case OpCode::BoxBoolean:
+            v[i.dst] = bool(n[i.a]);
+            break;
+        case OpCode::ToString:
+            v[i.dst] = coerceToString(v[i.a]);
+            break;
+        case OpCode::LerpColor:
+            if (!v[i.a].is<Color>()) {
+                return EvaluationError { typeError(type::Color, v[i.a]) };
+            }
+            if (!v[i.b].is<Color>()) {
+                return EvaluationError { typeError(type::Color, v[i.b]) };
+            }
+            v[i.dst] = util::interpolate(v[i.a].get<Color>(), v[i.b].get<Color>(), n[i.operand]);
+            break;
+        case OpCode::AssertNumber:
+            if (v[i.a].is<double>()) {
+                n[i.dst] = v[i.a].get<double>();
+                pc = i.operand;
+            } else if (i.b) {
+                return EvaluationError { typeError(type::Number, v[i.a]) };
+            }
+            break;
+        case OpCode::AssertBoolean:
+            if (v[i.a].is<bool>()) {
+                n[i.dst] = v[i.a].get<bool>();
+                pc = i.operand;
+            } else if (i.b) {
+                return EvaluationError { typeError(type::Boolean, v[i.a]) };
+            }
+            break;
+        case OpCode::AssertString:
+            if (v[i.a].is<std::string>()) {
+                v[i.dst] = std::move(v[i.a]);
+                pc = i.operand;
+            } else if (i.b) {
+                return EvaluationError { typeError(type::String, v[i.a]) };
+            }
+            break;
+        case OpCode::ToNumber: {
+            EvaluationResult number = toNumber(v[i.a]);
+            if (number) {
+                n[i.dst] = number->get<double>();
+                pc = i.operand;
+            } else if (i.b) {
+                return number.error();
+            }
+            break;
+        }
+        case OpCode::Jump:
+            pc = i.operand;
+            break;
+        case OpCode::JumpIfFalse:
+            if (!n[i.a]) {
+                pc = i.operand;
+            }
+            break;
+        case OpCode::JumpIfNotNull:
+            if (v[i.a] != Null) {
+                pc = i.operand;
+            }
+            break;
+        case OpCode::Step: {
+            const StepTable& table = impl->steps[i.operand];
+            const float x = n[i.a];
+            const auto it = std::upper_bound(table.inputs.begin(), table.inputs.end(), x);
+            if (it == table.inputs.end()) {
+                pc = table.targets.back();
+            } else if (it == table.inputs.begin()) {
+                pc = table.targets.front();
+            } else {
+                pc = table.targets[it - table.inputs.begin() - 1];
+            }
+            break;
+        }
+        case OpCode::Interpolate: {
+            const InterpolateTable& table = impl->interpolations[i.operand];
+            const float x = n[i.a];
+            const auto it = std::upper_bound(table.inputs.begin(), table.inputs.end(), x);
+            if (it == table.inputs.end()) {
+                pc = table.single.back();
+            } else if (it == table.inputs.begin()) {
+                pc = table.single.front();
+            } else {
+                const std::size_t lower = it - table.inputs.begin() - 1;
+                const float t = table.interpolator.match([&](const auto& interpolator) {
+                    return interpolator.interpolationFactor({ *std::prev(it), *it }, x);
+                });
+                if (t == 0.0f) {
+                    pc = table.single[lower];
+                } else if (t == 1.0f) {
+                    pc = table.single[lower + 1];
+                } else {
+                    n[i.dst] = t;
+                    pc = table.pairs[lower];
+                }
+            }
+            break;
+        }
+        case OpCode::MatchString: {
+            const MatchTable& table = impl->matches[i.operand];
+            pc = table.otherwise;
+            if (v[i.a].is<std::string>()) {
+                auto it = table.strings.find(v[i.a].get<std::string>());
+                if (it != table.strings.end()) {
+                    pc = it->second;
+                }
+            }
+            break;
+        }
+        case OpCode::MatchInteger: {
+            const MatchTable& table = impl->matches[i.operand];
+            pc = table.otherwise;
+            const double numeric = n[i.a];
+            const int64_t rounded = std::floor(numeric);
+            if (numeric == rounded) {
+                auto it = table.integers.find(rounded);
+                if (it != table.integers.end()) {
+                    pc = it->second;
+                }
+            }
+            break;
+        }
+        case OpCode::Fail:
+            return EvaluationError { impl->strings[i.operand] };
+        }
+    }
+
+    // The result is always in the first register of its kind.
+    if (impl->type.is<type::NumberType>()) {
+        return n[0];
+    } else if (impl->type.is<type::BooleanType>()) {
+        return bool(n[0]);
+    } else {
+        return std::move(v[0]);
+    }
+}
+
+} // namespace expression
+} // namespace style
+} // namespace mbgl
@@ -272,6 +272,18 @@ std::unordered_map<std::string, CompoundExpressionRegistry::Definition> initiali
         return object.at(key);
     });
     
+    define("feature-state", [](const EvaluationContext& params, const std::string& key) -> Result<Value> {
+        if (!params.featureState) {
+            return Null;
+        }
+
+        auto it = params.featureState->find(key);
+        if (it == params.featureState->end()) {
+            return Null;
+        }
+        return Value(toExpressionValue(it->second));
+    });
+
     define("length", [](const std::vector<Value>& arr) -> Result<double> {
         return arr.size();
     });
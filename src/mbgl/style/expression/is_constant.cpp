@@ -14,6 +14,7 @@ bool isFeatureConstant(const Expression& expression) {
             return false;
         } else if (
             name == "properties" ||
+            name == "feature-state" ||
             name == "geometry-type" ||
             name == "id"
         ) {
@@ -34,6 +35,10 @@ bool isZoomConstant(const Expression& e) {
     return isGlobalPropertyConstant(e, std::array<std::string, 1>{{"zoom"}});
 }
 
+bool isFeatureStateConstant(const Expression& e) {
+    return isGlobalPropertyConstant(e, std::array<std::string, 1>{{"feature-state"}});
+}
+
 
 } // namespace expression
 } // namespace style
@@ -0,0 +1,52 @@
+#include <mbgl/text/collision_grid.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+CollisionGrid::CollisionGrid(const BBox& bounds_, int32_t n_)
+    : bounds(bounds_),
+      n(n_),
+      scaleX(n / (bounds.x2 - bounds.x1)),
+      scaleY(n / (bounds.y2 - bounds.y1)),
+      cells(n * n, none) {
+    assert(bounds.x1 < bounds.x2 && bounds.y1 < bounds.y2);
+}
+
+int32_t CollisionGrid::cellX(float x) const {
+    const float cell = (x - bounds.x1) * scaleX;
+    // Written so that NaN ends up in the first cell.
+    if (!(cell > 0)) {
+        return 0;
+    }
+    return cell < n - 1 ? int32_t(cell) : n - 1;
+}
+
+int32_t CollisionGrid::cellY(float y) const {
+    const float cell = (y - bounds.y1) * scaleY;
+    if (!(cell > 0)) {
+        return 0;
+    }
+    return cell < n - 1 ? int32_t(cell) : n - 1;
+}
+
+void CollisionGrid::insert(Entry&& entry) {
+    const BBox bbox = entry.bbox;
+    const auto index = uint32_t(entries.size());
+    entries.push_back(std::move(entry));
+
+    const int32_t cx1 = cellX(bbox.x1);
+    const int32_t cy1 = cellY(bbox.y1);
+    const int32_t cx2 = cellX(bbox.x2);
+    const int32_t cy2 = cellY(bbox.y2);
+
+    for (int32_t y = cy1; y <= cy2; ++y) {
+        for (int32_t x = cx1; x <= cx2; ++x) {
+            uint32_t& head = cells[n * y + x];
+            nodes.push_back({ bbox, index, head });
+            head = uint32_t(nodes.size() - 1);
+        }
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <mbgl/text/collision_feature.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    A uniform grid of collision boxes, built for the way placement uses it: every label
+    queries the boxes placed so far and then inserts its own, so the index must stay
+    queryable between insertions.
+
+    Entries live in insertion order in a single array. Each cell is a chain of nodes in
+    a second, shared array; a node carries a copy of its entry's box, so that walking a
+    cell only touches the node array. Inserting never allocates per cell, and the whole
+    grid is released at once with the tile. Boxes that reach outside of the grid bounds
+    are clamped into its border cells.
+*/
+class CollisionGrid {
+public:
+    struct BBox {
+        float x1;
+        float y1;
+        float x2;
+        float y2;
+    };
+
+    struct Entry {
+        BBox bbox;
+        CollisionBox box;
+        IndexedSubfeature feature;
+    };
+
+    CollisionGrid(const BBox& bounds, int32_t n);
+
+    void insert(Entry&&);
+
+    // Calls fn(const Entry&) once for every entry whose box intersects the query box,
+    // until fn returns false. Boxes that only touch count as intersecting.
+    template <class Fn>
+    void query(const BBox&, Fn&&) const;
+
+    bool empty() const { return entries.empty(); }
+    const std::vector<Entry>& getEntries() const { return entries; }
+
+private:
+    int32_t cellX(float x) const;
+    int32_t cellY(float y) const;
+
+    static constexpr uint32_t none = UINT32_MAX;
+
+    struct Node {
+        BBox bbox;
+        uint32_t entry;
+        uint32_t next;
+    };
+
+    const BBox bounds;
+    const int32_t n;
+    const float scaleX;
+    const float scaleY;
+
+    std::vector<Entry> entries;
+    std::vector<uint32_t> cells;
+    std::vector<Node> nodes;
+};
+
+template <class Fn>
+void CollisionGrid::query(const BBox& q, Fn&& fn) const {
+    if (entries.empty()) {
+        return;
+    }
+
+    const int32_t cx1 = cellX(q.x1);
+    const int32_t cy1 = cellY(q.y1);
+    const int32_t cx2 = cellX(q.x2);
+    const int32_t cy2 = cellY(q.y2);
+
+    for (int32_t y = cy1; y <= cy2; ++y) {
+        for (int32_t x = cx1; x <= cx2; ++x) {
+            for (uint32_t i = cells[n * y + x]; i != none; i = nodes[i].next) {
+                const Node& node = nodes[i];
+                if (q.x1 > node.bbox.x2 || q.y1 > node.bbox.y2 || q.x2 < node.bbox.x1 || q.y2 < node.bbox.y1) {
+                    continue;
+                }
+
+                // Entries are listed in every cell they cover. Only report them from
+                // the first of those cells that this query visits.
+                if (x != std::max(cx1, cellX(node.bbox.x1)) || y != std::max(cy1, cellY(node.bbox.y1))) {
+                    continue;
+                }
+
+                if (!fn(entries[node.entry])) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+} // namespace mbgl
@@ -10,10 +10,40 @@
 #include <mapbox/geometry/multi_point.hpp>
 
 #include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace mbgl {
 
-CollisionTile::CollisionTile(PlacementConfig config_) : config(std::move(config_)) {
+// The bounds of the tile and its buffer after rotating them into the space of
+// collision boxes. Anchors are rotated, but box extents aren't, so labels near the
+// edges reach outside of these bounds; they end up in the border cells of the grid.
+static CollisionGrid::BBox rotatedTileBounds(const float angle) {
+    const float angle_sin = std::sin(angle);
+    const float angle_cos = std::cos(angle);
+    const std::array<float, 4> matrix = { { angle_cos, -angle_sin, angle_sin, angle_cos } };
+    const float buffer = util::EXTENT / 8;
+
+    CollisionGrid::BBox bounds {
+        std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(),
+        -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()
+    };
+    for (const float x : { -buffer, util::EXTENT + buffer }) {
+        for (const float y : { -buffer, util::EXTENT + buffer }) {
+            const Point<float> corner = util::matrixMultiply(matrix, Point<float>(x, y));
+            bounds.x1 = util::min(bounds.x1, corner.x);
+            bounds.y1 = util::min(bounds.y1, corner.y);
+            bounds.x2 = util::max(bounds.x2, corner.x);
+            bounds.y2 = util::max(bounds.y2, corner.y);
+        }
+    }
+    return bounds;
+}
+
+CollisionTile::CollisionTile(PlacementConfig config_)
+    : config(std::move(config_)),
+      tree(rotatedTileBounds(config.angle), 16) {
     // Compute the transformation matrix.
     const float angle_sin = std::sin(config.angle);
     const float angle_cos = std::cos(config.angle);
@@ -101,13 +131,14 @@ float CollisionTile::placeFeature(const CollisionFeature& feature, bool allowOve
         const float boxMaxScale = box.adjustedMaxScale(rotationMatrix, yStretch);
 
         if (!allowOverlap) {
-            for (auto it = tree.qbegin(bgi::intersects(getTreeBox(anchor, box))); it != tree.qend(); ++it) {
-                const CollisionBox& blocking = std::get<1>(*it);
+            tree.query(getTreeBox(anchor, box), [&] (const CollisionGrid::Entry& entry) {
+                const CollisionBox& blocking = entry.box;
                 Point<float> blockingAnchor = util::matrixMultiply(rotationMatrix, blocking.anchor);
 
                 minPlacementScale = util::max(minPlacementScale, findPlacementScale(anchor, box, boxMaxScale, blockingAnchor, blocking));
-                if (minPlacementScale >= maxScale) return minPlacementScale;
-            }
+                return minPlacementScale < maxScale;
+            });
+            if (minPlacementScale >= maxScale) return minPlacementScale;
         }
 
         if (avoidEdges) {
@@ -139,16 +170,15 @@ void CollisionTile::insertFeature(CollisionFeature& feature, float minPlacementS
     }
 
     if (minPlacementScale < maxScale) {
-        std::vector<CollisionTreeBox> treeBoxes;
         for (auto& box : feature.boxes) {
             CollisionBox adjustedBox = box;
             box.maxScale = box.adjustedMaxScale(rotationMatrix, yStretch);
-            treeBoxes.emplace_back(getTreeBox(util::matrixMultiply(rotationMatrix, box.anchor), box), std::move(adjustedBox), feature.indexedFeature);
-        }
-        if (ignorePlacement) {
-            ignoredTree.insert(treeBoxes.begin(), treeBoxes.end());
-        } else {
-            tree.insert(treeBoxes.begin(), treeBoxes.end());
+            CollisionGrid::Entry entry { getTreeBox(util::matrixMultiply(rotationMatrix, box.anchor), box), std::move(adjustedBox), feature.indexedFeature };
+            if (ignorePlacement) {
+                ignoredTree.push_back(std::move(entry));
+            } else {
+                tree.insert(std::move(entry));
+            }
         }
     }
 
@@ -171,9 +201,9 @@ void CollisionTile::insertFeature(CollisionFeature& feature, float minPlacementS
 // |             |             | calculating the bounds at current zoom level
 // |             |      (x2,y2)| we must unscale the box using its center as
 // +---------------------------+ transform origin.
-Box CollisionTile::getTreeBox(const Point<float>& anchor, const CollisionBox& box, const float scale) {
+CollisionGrid::BBox CollisionTile::getTreeBox(const Point<float>& anchor, const CollisionBox& box, const float scale) {
     assert(box.x1 <= box.x2 && box.y1 <= box.y2);
-    return Box{
+    return CollisionGrid::BBox {
         // When the 'perspectiveRatio' is high, we're effectively underzooming
         // the tile because it's in the distance.
         // In order to detect collisions that only happen while underzoomed,
@@ -182,14 +212,10 @@ Box CollisionTile::getTreeBox(const Point<float>& anchor, const CollisionBox& bo
         // Note that this adjustment ONLY affects the bounding boxes
         // in the grid. It doesn't affect the boxes used for the
         // minPlacementScale calculations.
-        CollisionPoint{
-            anchor.x + box.x1 / scale * perspectiveRatio,
-            anchor.y + box.y1 / scale * yStretch * perspectiveRatio,
-        },
-        CollisionPoint{
-            anchor.x + box.x2 / scale * perspectiveRatio,
-            anchor.y + box.y2 / scale * yStretch * perspectiveRatio
-        }
+        anchor.x + box.x1 / scale * perspectiveRatio,
+        anchor.y + box.y1 / scale * yStretch * perspectiveRatio,
+        anchor.x + box.x2 / scale * perspectiveRatio,
+        anchor.y + box.y2 / scale * yStretch * perspectiveRatio
     };
 }
 
@@ -208,9 +234,9 @@ std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const Geometr
     }
 
     // Predicate for ruling out already seen features.
-    std::unordered_map<std::string, std::unordered_set<std::size_t>> sourceLayerFeatures;
-    auto seenFeature = [&] (const CollisionTreeBox& treeBox) -> bool {
-        const IndexedSubfeature& feature = std::get<2>(treeBox);
+    std::unordered_map<StringIdentity, std::unordered_set<std::size_t>> sourceLayerFeatures;
+    auto seenFeature = [&] (const CollisionGrid::Entry& entry) -> bool {
+        const IndexedSubfeature& feature = entry.feature;
         const auto& seenFeatures = sourceLayerFeatures[feature.sourceLayerName];
         return seenFeatures.find(feature.index) == seenFeatures.end();
     };
@@ -225,14 +251,14 @@ std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const Geometr
     const float roundedScale = std::pow(2.0f, std::ceil(util::log2(perspectiveScale) * 10.0f) / 10.0f);
 
     // Check if feature is rendered (collision free) at current scale.
-    auto visibleAtScale = [&] (const CollisionTreeBox& treeBox) -> bool {
-        const CollisionBox& box = std::get<1>(treeBox);
+    auto visibleAtScale = [&] (const CollisionGrid::Entry& entry) -> bool {
+        const CollisionBox& box = entry.box;
         return roundedScale >= box.placementScale && roundedScale <= box.adjustedMaxScale(rotationMatrix, yStretch);
     };
 
     // Check if query polygon intersects with the feature box at current scale.
-    auto intersectsAtScale = [&] (const CollisionTreeBox& treeBox) -> bool {
-        const CollisionBox& collisionBox = std::get<1>(treeBox);
+    auto intersectsAtScale = [&] (const CollisionGrid::Entry& entry) -> bool {
+        const CollisionBox& collisionBox = entry.box;
         const auto anchor = util::matrixMultiply(rotationMatrix, collisionBox.anchor);
 
         const int16_t x1 = anchor.x + (collisionBox.x1 / perspectiveScale);
@@ -245,20 +271,21 @@ std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const Geometr
         return util::polygonIntersectsPolygon(polygon, bbox);
     };
 
-    auto predicates = bgi::satisfies(seenFeature)
-                   && bgi::satisfies(visibleAtScale)
-                   && bgi::satisfies(intersectsAtScale);
-
-    auto queryTree = [&](const auto& tree_) {
-        for (auto it = tree_.qbegin(predicates); it != tree_.qend(); ++it) {
-            const IndexedSubfeature& feature = std::get<2>(*it);
+    // The boxes at the current scale aren't bounded by the boxes in the grid, so every
+    // entry is tested; both lists are contiguous arrays.
+    auto queryTree = [&](const std::vector<CollisionGrid::Entry>& entries) {
+        for (const auto& entry : entries) {
+            if (!seenFeature(entry) || !visibleAtScale(entry) || !intersectsAtScale(entry)) {
+                continue;
+            }
+            const IndexedSubfeature& feature = entry.feature;
             auto& seenFeatures = sourceLayerFeatures[feature.sourceLayerName];
             seenFeatures.insert(feature.index);
             result.push_back(feature);
         }
     };
 
-    queryTree(tree);
+    queryTree(tree.getEntries());
     queryTree(ignoredTree);
 
     return result;
@@ -12,7 +12,6 @@
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
 #include <mbgl/renderer/query.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
-#include <mbgl/renderer/image_atlas.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/text/collision_tile.hpp>
@@ -54,7 +53,8 @@ GeometryTile::GeometryTile(const OverscaledTileID& id_,
              id_,
              obsolete,
              parameters.mode,
-             parameters.pixelRatio),
+             parameters.pixelRatio,
+             parameters.fileSource.supportsTileSnapshots()),
       glyphManager(parameters.glyphManager),
       imageManager(parameters.imageManager),
       lastYStretch(1.0f),
@@ -80,13 +80,13 @@ void GeometryTile::setError(std::exception_ptr err) {
     observer->onTileError(*this, err);
 }
 
-void GeometryTile::setData(std::unique_ptr<const GeometryTileData> data_) {
+void GeometryTile::setData(std::unique_ptr<const GeometryTileData> data_, bool fromCache) {
     // Mark the tile as pending again if it was complete before to prevent signaling a complete
     // state despite pending parse operations.
     pending = true;
 
     ++correlationID;
-    worker.invoke(&GeometryTileWorker::setData, std::move(data_), correlationID);
+    worker.invoke(&GeometryTileWorker::setData, std::move(data_), fromCache, correlationID);
 }
 
 void GeometryTile::setPlacementConfig(const PlacementConfig& desiredConfig) {
@@ -141,6 +141,8 @@ void GeometryTile::onLayout(LayoutResult result, const uint64_t resultCorrelatio
     nonSymbolBuckets = std::move(result.nonSymbolBuckets);
     featureIndex = std::move(result.featureIndex);
     data = std::move(result.tileData);
+    featureStatesVersions.clear();
+    featureStatesLayers.clear();
     collisionTile.reset();
     observer->onTileChanged(*this);
 }
@@ -151,14 +153,18 @@ void GeometryTile::onPlacement(PlacementResult result, const uint64_t resultCorr
     if (resultCorrelationID == correlationID) {
         pending = false;
     }
+    // The new symbol buckets were evaluated without feature states, so all of them are
+    // applied again on the next frame.
+    for (const auto& pair : symbolBuckets) {
+        featureStatesVersions.erase(pair.second.get());
+    }
     symbolBuckets = std::move(result.symbolBuckets);
     collisionTile = std::move(result.collisionTile);
     if (result.glyphAtlasImage) {
         glyphAtlasImage = std::move(*result.glyphAtlasImage);
     }
-    if (result.iconAtlasImage) {
-        iconAtlasImage = std::move(*result.iconAtlasImage);
-    }
+    // The previous symbol buckets are gone, and with them the last use of older icons.
+    imageManager.releaseImages(*this, result.imageCorrelationID);
     if (collisionTile.get()) {
         lastYStretch = collisionTile->yStretch;
     }
@@ -181,14 +187,27 @@ void GeometryTile::getGlyphs(GlyphDependencies glyphDependencies) {
     glyphManager.getGlyphs(*this, std::move(glyphDependencies));
 }
 
-void GeometryTile::onImagesAvailable(ImageMap images, uint64_t imageCorrelationID) {
-    worker.invoke(&GeometryTileWorker::onImagesAvailable, std::move(images), imageCorrelationID);
+void GeometryTile::onImagesAvailable(ImageMap images, ImagePositions imagePositions, uint64_t imageCorrelationID) {
+    worker.invoke(&GeometryTileWorker::onImagesAvailable, std::move(images), std::move(imagePositions), imageCorrelationID);
 }
 
 void GeometryTile::getImages(ImageRequestPair pair) {
     imageManager.getImages(*this, std::move(pair));
 }
 
+void GeometryTile::getSnapshot(uint64_t layersHash) {
+    lookUpSnapshot(layersHash, [worker = worker.self(), layersHash] (std::shared_ptr<const std::string> snapshot) mutable {
+        worker.invoke(&GeometryTileWorker::onSnapshotAvailable, std::move(snapshot), layersHash);
+    });
+}
+
+void GeometryTile::lookUpSnapshot(uint64_t, FileSource::SnapshotCallback callback) {
+    callback(nullptr);
+}
+
+void GeometryTile::putSnapshot(uint64_t, std::shared_ptr<const std::string>) {
+}
+
 void GeometryTile::upload(gl::Context& context) {
     auto uploadFn = [&] (Bucket& bucket) {
         if (bucket.needsUpload()) {
@@ -208,11 +227,6 @@ void GeometryTile::upload(gl::Context& context) {
         glyphAtlasTexture = context.createTexture(*glyphAtlasImage, 0);
         glyphAtlasImage = {};
     }
-
-    if (iconAtlasImage) {
-        iconAtlasTexture = context.createTexture(*iconAtlasImage, 0);
-        iconAtlasImage = {};
-    }
 }
 
 Bucket* GeometryTile::getBucket(const Layer::Impl& layer) const {
@@ -226,6 +240,29 @@ Bucket* GeometryTile::getBucket(const Layer::Impl& layer) const {
     return it->second.get();
 }
 
+void GeometryTile::setFeatureStates(const Layer::Impl& layer, const LayerFeatureStates& states) {
+    Bucket* bucket = getBucket(layer);
+    if (!bucket || !data) {
+        return;
+    }
+
+    uint64_t& applied = featureStatesVersions[bucket];
+    if (applied == states.getVersion()) {
+        return;
+    }
+
+    const FeatureStateChanges changes = states.changedSince(applied);
+    applied = states.getVersion();
+
+    auto it = featureStatesLayers.find(layer.sourceLayer);
+    if (it == featureStatesLayers.end()) {
+        it = featureStatesLayers.emplace(layer.sourceLayer, data->getLayer(layer.sourceLayer)).first;
+    }
+    if (it->second) {
+        bucket->setFeatureStates(changes, *it->second);
+    }
+}
+
 void GeometryTile::queryRenderedFeatures(
     std::unordered_map<std::string, std::vector<Feature>>& result,
     const GeometryCoordinates& queryGeometry,
@@ -5,6 +5,7 @@
 #include <mbgl/renderer/image_manager.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/text/placement_config.hpp>
+#include <mbgl/storage/file_source.hpp>
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/throttler.hpp>
@@ -23,7 +24,6 @@ class RenderLayer;
 class SourceQueryOptions;
 class TileParameters;
 class GlyphAtlas;
-class ImageAtlas;
 
 class GeometryTile : public Tile, public GlyphRequestor, ImageRequestor {
 public:
@@ -34,22 +34,27 @@ public:
     ~GeometryTile() override;
 
     void setError(std::exception_ptr);
-    void setData(std::unique_ptr<const GeometryTileData>);
+    // Snapshots of earlier layouts are only looked up for data that came from the cache.
+    void setData(std::unique_ptr<const GeometryTileData>, bool fromCache = false);
 
     void setPlacementConfig(const PlacementConfig&) override;
     void setLayers(const std::vector<Immutable<style::Layer::Impl>>&) override;
     
     void onGlyphsAvailable(GlyphMap) override;
-    void onImagesAvailable(ImageMap, uint64_t imageCorrelationID) override;
+    void onImagesAvailable(ImageMap, ImagePositions, uint64_t imageCorrelationID) override;
     
     void getGlyphs(GlyphDependencies);
     void getImages(ImageRequestPair);
 
+    // Snapshots of earlier layouts, keyed by a hash of the layers that produced them.
+    void getSnapshot(uint64_t layersHash);
+    virtual void putSnapshot(uint64_t layersHash, std::shared_ptr<const std::string>);
+
     void upload(gl::Context&) override;
     Bucket* getBucket(const style::Layer::Impl&) const override;
+    void setFeatureStates(const style::Layer::Impl&, const LayerFeatureStates&) override;
 
     Size bindGlyphAtlas(gl::Context&);
-    Size bindIconAtlas(gl::Context&);
 
     void queryRenderedFeatures(
             std::unordered_map<std::string, std::vector<Feature>>& result,
@@ -84,16 +89,17 @@ public:
         std::unordered_map<std::string, std::shared_ptr<Bucket>> symbolBuckets;
         std::unique_ptr<CollisionTile> collisionTile;
         optional<AlphaImage> glyphAtlasImage;
-        optional<PremultipliedImage> iconAtlasImage;
+        // The image request whose icon positions the symbol buckets use.
+        uint64_t imageCorrelationID;
 
         PlacementResult(std::unordered_map<std::string, std::shared_ptr<Bucket>> symbolBuckets_,
                         std::unique_ptr<CollisionTile> collisionTile_,
                         optional<AlphaImage> glyphAtlasImage_,
-                        optional<PremultipliedImage> iconAtlasImage_)
+                        uint64_t imageCorrelationID_)
             : symbolBuckets(std::move(symbolBuckets_)),
               collisionTile(std::move(collisionTile_)),
               glyphAtlasImage(std::move(glyphAtlasImage_)),
-              iconAtlasImage(std::move(iconAtlasImage_)) {}
+              imageCorrelationID(imageCorrelationID_) {}
     };
     void onPlacement(PlacementResult, uint64_t correlationID);
 
@@ -106,6 +112,9 @@ protected:
         return data.get();
     }
 
+    // Tiles without a resource to key snapshots by have none.
+    virtual void lookUpSnapshot(uint64_t layersHash, FileSource::SnapshotCallback);
+
 private:
     void markObsolete();
     void invokePlacement();
@@ -128,8 +137,12 @@ private:
     std::unique_ptr<FeatureIndex> featureIndex;
     std::unique_ptr<const GeometryTileData> data;
 
+    // Feature state version last applied to each bucket, and the source layers the changed
+    // features are looked up in; both are reset whenever new buckets arrive.
+    std::unordered_map<const Bucket*, uint64_t> featureStatesVersions;
+    std::unordered_map<std::string, std::unique_ptr<GeometryTileLayer>> featureStatesLayers;
+
     optional<AlphaImage> glyphAtlasImage;
-    optional<PremultipliedImage> iconAtlasImage;
 
     std::unordered_map<std::string, std::shared_ptr<Bucket>> symbolBuckets;
     std::unique_ptr<CollisionTile> collisionTile;
@@ -139,7 +152,6 @@ private:
 
 public:
     optional<gl::Texture> glyphAtlasTexture;
-    optional<gl::Texture> iconAtlasTexture;
 };
 
 } // namespace mbgl
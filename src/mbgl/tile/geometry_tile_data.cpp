@@ -5,7 +5,7 @@
 
 namespace mbgl {
 
-static double signedArea(const GeometryCoordinates& ring) {
+double signedArea(const GeometryCoordinates& ring) {
     double sum = 0;
 
     for (std::size_t i = 0, len = ring.size(), j = len - 1; i < len; j = i++) {
@@ -67,8 +67,15 @@ public:
     // Returns the layer with the given name. The returned layer object *may* outlive the data
     // object.
     virtual std::unique_ptr<GeometryTileLayer> getLayer(const std::string&) const = 0;
+
+    // Returns the encoded data this was parsed from, if there is any. A layout of the same
+    // encoded data can be restored from a snapshot.
+    virtual std::shared_ptr<const std::string> getEncodedData() const { return nullptr; }
 };
 
+// Twice the signed area of a ring; the sign gives its winding order.
+double signedArea(const GeometryCoordinates&);
+
 // classifies an array of rings into polygons with outer rings and holes
 std::vector<GeometryCollection> classifyRings(const GeometryCollection&);
 
@@ -1,6 +1,7 @@
 #include <mbgl/tile/geometry_tile_worker.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/tile/geometry_tile.hpp>
+#include <mbgl/tile/tile_snapshot.hpp>
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/layout/symbol_layout.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
@@ -26,13 +27,15 @@ GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
                                        OverscaledTileID id_,
                                        const std::atomic<bool>& obsolete_,
                                        const MapMode mode_,
-                                       const float pixelRatio_)
+                                       const float pixelRatio_,
+                                       const bool snapshots_)
     : self(std::move(self_)),
       parent(std::move(parent_)),
       id(std::move(id_)),
       obsolete(obsolete_),
       mode(mode_),
-      pixelRatio(pixelRatio_) {
+      pixelRatio(pixelRatio_),
+      snapshots(snapshots_) {
 }
 
 GeometryTileWorker::~GeometryTileWorker() = default;
@@ -70,10 +73,15 @@ GeometryTileWorker::~GeometryTileWorker() = default;
    since it will trigger placement when complete), or return to the [idle] state if not.
 */
 
-void GeometryTileWorker::setData(std::unique_ptr<const GeometryTileData> data_, uint64_t correlationID_) {
+void GeometryTileWorker::setData(std::unique_ptr<const GeometryTileData> data_, bool fromCache, uint64_t correlationID_) {
     try {
         data = std::move(data_);
         correlationID = correlationID_;
+        dataHash = {};
+        dataFromCache = fromCache;
+        snapshotStored = false;
+        snapshotLayersHash = {};
+        snapshot.reset();
 
         switch (state) {
         case Idle:
@@ -216,15 +224,44 @@ void GeometryTileWorker::onGlyphsAvailable(GlyphMap newGlyphMap) {
     symbolDependenciesChanged();
 }
 
-void GeometryTileWorker::onImagesAvailable(ImageMap newImageMap, uint64_t imageCorrelationID_) {
+void GeometryTileWorker::onImagesAvailable(ImageMap newImageMap, ImagePositions newImagePositions, uint64_t imageCorrelationID_) {
     if (imageCorrelationID != imageCorrelationID_) {
         return; // Ignore outdated image request replies.
     }
     imageMap = std::move(newImageMap);
+    imagePositions = std::move(newImagePositions);
     pendingImageDependencies.clear();
     symbolDependenciesChanged();
 }
 
+void GeometryTileWorker::onSnapshotAvailable(std::shared_ptr<const std::string> snapshot_, uint64_t layersHash) {
+    if (!pendingSnapshot || snapshotLayersHash != layersHash) {
+        return; // Ignore replies to lookups for layers we no longer have.
+    }
+
+    pendingSnapshot = false;
+    snapshot = std::move(snapshot_);
+
+    try {
+        switch (state) {
+        case Idle:
+            redoLayout();
+            coalesce();
+            break;
+
+        case Coalescing:
+        case NeedPlacement:
+            state = NeedLayout;
+            break;
+
+        case NeedLayout:
+            break;
+        }
+    } catch (...) {
+        parent.invoke(&GeometryTile::onError, std::current_exception(), correlationID);
+    }
+}
+
 void GeometryTileWorker::requestNewGlyphs(const GlyphDependencies& glyphDependencies) {
     for (auto& fontDependencies : glyphDependencies) {
         auto fontGlyphs = glyphMap.find(fontDependencies.first);
@@ -243,6 +280,11 @@ void GeometryTileWorker::requestNewImages(const ImageDependencies& imageDependen
     pendingImageDependencies = imageDependencies;
     if (!pendingImageDependencies.empty()) {
         parent.invoke(&GeometryTile::getImages, std::make_pair(pendingImageDependencies, ++imageCorrelationID));
+    } else if (!imageMap.empty()) {
+        // Let the tile release the icons of the previous layout with the next placement.
+        imageMap.clear();
+        imagePositions.clear();
+        ++imageCorrelationID;
     }
 }
 
@@ -269,6 +311,29 @@ void GeometryTileWorker::redoLayout() {
         return;
     }
 
+    // An earlier layout of the same encoded data with the same layers may have been kept by
+    // the file source next to cached data. Ask for it once for every combination, and wait
+    // for the answer.
+    std::shared_ptr<const std::string> encodedData = snapshots && *data ? (*data)->getEncodedData() : nullptr;
+    if (encodedData && !dataHash) {
+        dataHash = TileSnapshot::hashData(*encodedData);
+    }
+
+    const optional<TileSnapshot::Key> snapshotKey = encodedData
+        ? optional<TileSnapshot::Key>(TileSnapshot::Key { id, TileSnapshot::hashLayers(*layers), *dataHash })
+        : optional<TileSnapshot::Key>();
+    if (snapshotKey && dataFromCache) {
+        if (snapshotLayersHash != snapshotKey->layersHash) {
+            snapshotLayersHash = snapshotKey->layersHash;
+            snapshot.reset();
+            pendingSnapshot = true;
+            parent.invoke(&GeometryTile::getSnapshot, snapshotKey->layersHash);
+        }
+        if (pendingSnapshot) {
+            return;
+        }
+    }
+
     std::vector<std::string> symbolOrder;
     for (auto it = layers->rbegin(); it != layers->rend(); it++) {
         if ((*it)->type == LayerType::Symbol) {
@@ -288,6 +353,26 @@ void GeometryTileWorker::redoLayout() {
     std::vector<std::unique_ptr<RenderLayer>> renderLayers = toRenderLayers(*layers, id.overscaledZ);
     std::vector<std::vector<const RenderLayer*>> groups = groupByLayout(renderLayers);
 
+    // A snapshot stands in for all non-symbol buckets and the feature index. It is only
+    // used once; holding on to it would keep a second copy of the buckets around.
+    optional<TileSnapshot::Result> restored;
+    if (snapshot) {
+        restored = TileSnapshot::decode(snapshot->data(), snapshot->size(), *snapshotKey, parameters, groups);
+        snapshot.reset();
+    }
+    if (restored) {
+        buckets = std::move(restored->buckets);
+        featureIndex = std::move(restored->featureIndex);
+    }
+
+    // The features of one layer at a time are handed to its bucket all at once, so that
+    // data-driven paint properties can be evaluated over the whole layer in one pass. The
+    // vectors are emptied for every layer but keep their capacity, so that they're
+    // allocated once per layout rather than once per layer.
+    std::vector<std::unique_ptr<GeometryTileFeature>> features;
+    std::vector<GeometryCollection> geometries;
+    std::vector<std::size_t> indices;
+
     for (auto& group : groups) {
         if (obsolete) {
             return;
@@ -299,6 +384,10 @@ void GeometryTileWorker::redoLayout() {
 
         const RenderLayer& leader = *group.at(0);
 
+        if (restored && !leader.is<RenderSymbolLayer>()) {
+            continue;
+        }
+
         auto geometryLayer = (*data)->getLayer(leader.baseImpl->sourceLayer);
         if (!geometryLayer) {
             continue;
@@ -310,26 +399,41 @@ void GeometryTileWorker::redoLayout() {
         }
 
         featureIndex->setBucketLayerIDs(leader.getID(), layerIDs);
+        const StringIdentity sourceLayerName = featureIndex->intern(leader.baseImpl->sourceLayer);
+        const StringIdentity bucketName = featureIndex->intern(leader.getID());
 
         if (leader.is<RenderSymbolLayer>()) {
             auto layout = leader.as<RenderSymbolLayer>()->createLayout(
-                parameters, group, std::move(geometryLayer), glyphDependencies, imageDependencies);
+                parameters, group, std::move(geometryLayer), sourceLayerName, bucketName,
+                glyphDependencies, imageDependencies);
             symbolLayoutMap.emplace(leader.getID(), std::move(layout));
             symbolLayoutsNeedPreparation = true;
         } else {
             const Filter& filter = leader.baseImpl->filter;
-            const std::string& sourceLayerID = leader.baseImpl->sourceLayer;
             std::shared_ptr<Bucket> bucket = leader.createBucket(parameters, group);
 
-            for (std::size_t i = 0; !obsolete && i < geometryLayer->featureCount(); i++) {
+            const std::size_t featureCount = geometryLayer->featureCount();
+            features.clear();
+            geometries.clear();
+            indices.clear();
+            features.reserve(featureCount);
+            geometries.reserve(featureCount);
+            indices.reserve(featureCount);
+
+            for (std::size_t i = 0; !obsolete && i < featureCount; i++) {
                 std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
 
                 if (!filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); }))
                     continue;
 
-                GeometryCollection geometries = feature->getGeometries();
-                bucket->addFeature(*feature, geometries);
-                featureIndex->insert(geometries, i, sourceLayerID, leader.getID());
+                geometries.push_back(feature->getGeometries());
+                features.push_back(std::move(feature));
+                indices.push_back(i);
+            }
+
+            bucket->addFeatures(features, geometries, indices);
+            for (std::size_t i = 0; i < features.size(); i++) {
+                featureIndex->insert(geometries[i], indices[i], sourceLayerName, bucketName);
             }
 
             if (!bucket->hasData()) {
@@ -350,6 +454,14 @@ void GeometryTileWorker::redoLayout() {
         }
     }
 
+    if (snapshotKey && !restored && !snapshotStored) {
+        snapshotStored = true;
+        if (auto encoded = TileSnapshot::encode(*snapshotKey, groups, buckets, *featureIndex)) {
+            parent.invoke(&GeometryTile::putSnapshot, snapshotKey->layersHash,
+                          std::make_shared<const std::string>(std::move(*encoded)));
+        }
+    }
+
     requestNewGlyphs(glyphDependencies);
     requestNewImages(imageDependencies);
 
@@ -372,19 +484,15 @@ bool GeometryTileWorker::hasPendingSymbolDependencies() const {
 }
 
 void GeometryTileWorker::attemptPlacement() {
-    if (!data || !layers || !placementConfig || hasPendingSymbolDependencies()) {
+    if (!data || !layers || !placementConfig || pendingSnapshot || hasPendingSymbolDependencies()) {
         return;
     }
     
     optional<AlphaImage> glyphAtlasImage;
-    optional<PremultipliedImage> iconAtlasImage;
 
     if (symbolLayoutsNeedPreparation) {
         GlyphAtlas glyphAtlas = makeGlyphAtlas(glyphMap);
-        ImageAtlas imageAtlas = makeImageAtlas(imageMap);
-
         glyphAtlasImage = std::move(glyphAtlas.image);
-        iconAtlasImage = std::move(imageAtlas.image);
 
         for (auto& symbolLayout : symbolLayouts) {
             if (obsolete) {
@@ -392,7 +500,7 @@ void GeometryTileWorker::attemptPlacement() {
             }
 
             symbolLayout->prepare(glyphMap, glyphAtlas.positions,
-                                  imageMap, imageAtlas.positions);
+                                  imageMap, imagePositions);
         }
 
         symbolLayoutsNeedPreparation = false;
@@ -420,7 +528,7 @@ void GeometryTileWorker::attemptPlacement() {
         std::move(buckets),
         std::move(collisionTile),
         std::move(glyphAtlasImage),
-        std::move(iconAtlasImage),
+        imageCorrelationID,
     }, correlationID);
 }
 
@@ -3,6 +3,7 @@
 #include <mbgl/map/mode.hpp>
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/style/image_impl.hpp>
+#include <mbgl/renderer/image_atlas.hpp>
 #include <mbgl/text/glyph.hpp>
 #include <mbgl/text/placement_config.hpp>
 #include <mbgl/actor/actor_ref.hpp>
@@ -12,6 +13,7 @@
 
 #include <atomic>
 #include <memory>
+#include <string>
 
 namespace mbgl {
 
@@ -30,15 +32,17 @@ public:
                        OverscaledTileID,
                        const std::atomic<bool>&,
                        const MapMode,
-                       const float pixelRatio);
+                       const float pixelRatio,
+                       const bool snapshots);
     ~GeometryTileWorker();
 
     void setLayers(std::vector<Immutable<style::Layer::Impl>>, uint64_t correlationID);
-    void setData(std::unique_ptr<const GeometryTileData>, uint64_t correlationID);
+    void setData(std::unique_ptr<const GeometryTileData>, bool fromCache, uint64_t correlationID);
     void setPlacementConfig(PlacementConfig, uint64_t correlationID);
     
     void onGlyphsAvailable(GlyphMap glyphs);
-    void onImagesAvailable(ImageMap images, uint64_t imageCorrelationID);
+    void onImagesAvailable(ImageMap images, ImagePositions imagePositions, uint64_t imageCorrelationID);
+    void onSnapshotAvailable(std::shared_ptr<const std::string> snapshot, uint64_t layersHash);
 
 private:
     void coalesced();
@@ -61,6 +65,9 @@ private:
     const MapMode mode;
     const float pixelRatio;
 
+    // Whether layouts of encoded tile data are looked up in, and stored to, the file source.
+    const bool snapshots;
+
     enum State {
         Idle,
         Coalescing,
@@ -83,6 +90,16 @@ private:
     ImageDependencies pendingImageDependencies;
     GlyphMap glyphMap;
     ImageMap imageMap;
+    ImagePositions imagePositions;
+
+    // The snapshot lookup for the current data and layers. Layout waits for its answer, but
+    // only data that came from the cache is looked up, and only its first layout is stored.
+    optional<uint64_t> dataHash;
+    bool dataFromCache = false;
+    bool snapshotStored = false;
+    optional<uint64_t> snapshotLayersHash;
+    bool pendingSnapshot = false;
+    std::shared_ptr<const std::string> snapshot;
 };
 
 } // namespace mbgl
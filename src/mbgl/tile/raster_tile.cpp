@@ -19,7 +19,8 @@ RasterTile::RasterTile(const OverscaledTileID& id_,
       loader(*this, id_, parameters, tileset),
       mailbox(std::make_shared<Mailbox>(*Scheduler::GetCurrent())),
       worker(parameters.workerScheduler,
-             ActorRef<RasterTile>(*this, mailbox)) {
+             ActorRef<RasterTile>(*this, mailbox),
+             parameters.rasterTextureFormat) {
 }
 
 RasterTile::~RasterTile() = default;
@@ -67,6 +68,10 @@ void RasterTile::upload(gl::Context& context) {
     }
 }
 
+size_t RasterTile::getTextureBytes() const {
+    return bucket ? bucket->getTextureBytes() : 0;
+}
+
 Bucket* RasterTile::getBucket(const style::Layer::Impl&) const {
     return bucket.get();
 }
@@ -31,6 +31,7 @@ public:
     void cancel() override;
 
     void upload(gl::Context&) override;
+    size_t getTextureBytes() const;
     Bucket* getBucket(const style::Layer::Impl&) const override;
 
     void setMask(TileMask&&) override;
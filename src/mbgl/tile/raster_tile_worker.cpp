@@ -6,8 +6,11 @@
 
 namespace mbgl {
 
-RasterTileWorker::RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile> parent_)
-    : parent(std::move(parent_)) {
+RasterTileWorker::RasterTileWorker(ActorRef<RasterTileWorker>,
+                                   ActorRef<RasterTile> parent_,
+                                   RasterTextureFormat textureFormat_)
+    : parent(std::move(parent_)),
+      textureFormat(textureFormat_) {
 }
 
 void RasterTileWorker::parse(std::shared_ptr<const std::string> data, uint64_t correlationID) {
@@ -17,7 +20,7 @@ void RasterTileWorker::parse(std::shared_ptr<const std::string> data, uint64_t c
     }
 
     try {
-        auto bucket = std::make_unique<RasterBucket>(decodeImage(*data));
+        auto bucket = std::make_unique<RasterBucket>(decodeImage(*data), textureFormat);
         parent.invoke(&RasterTile::onParsed, std::move(bucket), correlationID);
     } catch (...) {
         parent.invoke(&RasterTile::onError, std::current_exception(), correlationID);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/map/mode.hpp>
 
 #include <memory>
 #include <string>
@@ -11,12 +12,13 @@ class RasterTile;
 
 class RasterTileWorker {
 public:
-    RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile>);
+    RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile>, RasterTextureFormat);
 
     void parse(std::shared_ptr<const std::string> data, uint64_t correlationID);
 
 private:
     ActorRef<RasterTile> parent;
+    const RasterTextureFormat textureFormat;
 };
 
 } // namespace mbgl
@@ -9,6 +9,7 @@
 #include <mbgl/tile/tile_necessity.hpp>
 #include <mbgl/renderer/tile_mask.hpp>
 #include <mbgl/renderer/bucket.hpp>
+#include <mbgl/renderer/feature_states.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/style/layer_impl.hpp>
@@ -51,6 +52,10 @@ public:
     virtual void setLayers(const std::vector<Immutable<style::Layer::Impl>>&) {}
     virtual void setMask(TileMask&&) {}
 
+    // Applies the feature states of the layer's source layer to its bucket. Tiles remember the
+    // version they last applied, and only pass on the features that changed since.
+    virtual void setFeatureStates(const style::Layer::Impl&, const LayerFeatureStates&) {}
+
     virtual void queryRenderedFeatures(
             std::unordered_map<std::string, std::vector<Feature>>& result,
             const GeometryCoordinates& queryGeometry,
@@ -21,6 +21,13 @@ public:
     bool has(const OverscaledTileID& key);
     void clear();
 
+    template <class Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& pair : tiles) {
+            fn(*pair.second);
+        }
+    }
+
 private:
     std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
     std::list<OverscaledTileID> orderedKeys;
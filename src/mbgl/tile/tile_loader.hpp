@@ -4,6 +4,10 @@
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/tile/tile.hpp>
 
+#include <functional>
+#include <memory>
+#include <string>
+
 namespace mbgl {
 
 class FileSource;
@@ -21,6 +25,16 @@ public:
                const Tileset&);
     ~TileLoader();
 
+    // Snapshots of the tile's layout, kept by the file source next to the tile data.
+    void getSnapshot(uint64_t layersHash, std::function<void (std::shared_ptr<const std::string>)>);
+    void putSnapshot(uint64_t layersHash, std::shared_ptr<const std::string>);
+
+    // Whether the data the tile was last given came from the cache. Only then can the file
+    // source have a snapshot of its layout.
+    bool isDataFromCache() const {
+        return dataFromCache;
+    }
+
     void setNecessity(TileNecessity newNecessity) {
         if (newNecessity != necessity) {
             necessity = newNecessity;
@@ -44,7 +58,7 @@ private:
     void makeOptional();
 
     void loadFromCache();
-    void loadedData(const Response&);
+    void loadedData(const Response&, bool fromCache);
     void loadFromNetwork();
 
     T& tile;
@@ -52,6 +66,8 @@ private:
     Resource resource;
     FileSource& fileSource;
     std::unique_ptr<AsyncRequest> request;
+    std::shared_ptr<const std::string> data;
+    bool dataFromCache = false;
 };
 
 } // namespace mbgl
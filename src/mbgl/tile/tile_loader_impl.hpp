@@ -67,7 +67,7 @@ void TileLoader<T>::loadFromCache() {
             resource.priorEtag = res.etag;
             resource.priorData = res.data;
         } else {
-            loadedData(res);
+            loadedData(res, true);
         }
 
         if (necessity == TileNecessity::Required) {
@@ -93,7 +93,7 @@ void TileLoader<T>::makeOptional() {
 }
 
 template <typename T>
-void TileLoader<T>::loadedData(const Response& res) {
+void TileLoader<T>::loadedData(const Response& res, bool fromCache) {
     if (res.error && res.error->reason != Response::Error::Reason::NotFound) {
         tile.setError(std::make_exception_ptr(std::runtime_error(res.error->message)));
     } else if (res.notModified) {
@@ -106,10 +106,29 @@ void TileLoader<T>::loadedData(const Response& res) {
         resource.priorExpires = res.expires;
         resource.priorEtag = res.etag;
         tile.setMetadata(res.modified, res.expires);
-        tile.setData(res.noContent ? nullptr : res.data);
+
+        // A network response may carry the very data the cache already gave the tile, for
+        // instance when the file source only serves from its cache. Don't lay it out again.
+        if (res.data && data && *res.data == *data) {
+            return;
+        }
+
+        data = res.noContent ? nullptr : res.data;
+        dataFromCache = fromCache;
+        tile.setData(data);
     }
 }
 
+template <typename T>
+void TileLoader<T>::getSnapshot(uint64_t layersHash, std::function<void (std::shared_ptr<const std::string>)> callback) {
+    fileSource.getTileSnapshot(resource, layersHash, std::move(callback));
+}
+
+template <typename T>
+void TileLoader<T>::putSnapshot(uint64_t layersHash, std::shared_ptr<const std::string> snapshot) {
+    fileSource.putTileSnapshot(resource, layersHash, std::move(snapshot));
+}
+
 template <typename T>
 void TileLoader<T>::loadFromNetwork() {
     assert(!request);
@@ -117,7 +136,7 @@ void TileLoader<T>::loadFromNetwork() {
     // Instead of using Resource::LoadingMethod::All, we're first doing a CacheOnly, and then a
     // NetworkOnly request.
     resource.loadingMethod = Resource::LoadingMethod::NetworkOnly;
-    request = fileSource.request(resource, [this](Response res) { loadedData(res); });
+    request = fileSource.request(resource, [this](Response res) { loadedData(res, false); });
 }
 
 } // namespace mbgl
@@ -0,0 +1,504 @@
+#include <mbgl/tile/tile_snapshot.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/renderer/buckets/circle_bucket.hpp>
+#include <mbgl/renderer/buckets/fill_bucket.hpp>
+#include <mbgl/renderer/buckets/line_bucket.hpp>
+#include <mbgl/renderer/layers/render_circle_layer.hpp>
+#include <mbgl/renderer/layers/render_fill_layer.hpp>
+#include <mbgl/renderer/layers/render_line_layer.hpp>
+#include <mbgl/renderer/group_by_layout.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <exception>
+#include <type_traits>
+
+namespace mbgl {
+
+namespace {
+
+constexpr uint32_t magic = 0x5354424D; // "MBTS"
+
+enum class BucketType : uint64_t {
+    Fill = 1,
+    Line = 2,
+    Circle = 3,
+};
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t layersHash;
+    uint64_t dataHash;
+    uint32_t x;
+    uint32_t y;
+    uint8_t z;
+    uint8_t overscaledZ;
+    int16_t wrap;
+    uint32_t padding;
+};
+
+struct SegmentRecord {
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t vertexLength;
+    uint64_t indexLength;
+};
+
+struct FeatureRecord {
+    uint64_t index;
+    uint64_t sortIndex;
+    uint32_t sourceLayerName;
+    uint32_t bucketName;
+    int16_t minX;
+    int16_t minY;
+    int16_t maxX;
+    int16_t maxY;
+};
+
+struct SnapshotFormatException : std::exception {};
+
+bool isLittleEndian() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t*>(&probe) == 1;
+}
+
+// Reverses the byte order of every integer in a value, in place. There are overloads for
+// all of the types a snapshot stores, and none that would let padding bytes slip through.
+template <class T>
+std::enable_if_t<std::is_integral<T>::value> swapBytes(T& value) {
+    auto bytes = reinterpret_cast<uint8_t*>(&value);
+    std::reverse(bytes, bytes + sizeof(T));
+}
+
+template <class T, std::size_t N>
+void swapBytes(std::array<T, N>& values) {
+    for (auto& value : values) {
+        swapBytes(value);
+    }
+}
+
+template <class A1>
+void swapBytes(gl::detail::Vertex<A1>& vertex) {
+    static_assert(sizeof(vertex) == sizeof(vertex.a1), "vertices must not be padded");
+    swapBytes(vertex.a1);
+}
+
+template <class A1, class A2>
+void swapBytes(gl::detail::Vertex<A1, A2>& vertex) {
+    static_assert(sizeof(vertex) == sizeof(vertex.a1) + sizeof(vertex.a2), "vertices must not be padded");
+    swapBytes(vertex.a1);
+    swapBytes(vertex.a2);
+}
+
+void swapBytes(Header& header) {
+    swapBytes(header.magic);
+    swapBytes(header.version);
+    swapBytes(header.layersHash);
+    swapBytes(header.dataHash);
+    swapBytes(header.x);
+    swapBytes(header.y);
+    swapBytes(header.wrap);
+}
+
+void swapBytes(SegmentRecord& record) {
+    swapBytes(record.vertexOffset);
+    swapBytes(record.indexOffset);
+    swapBytes(record.vertexLength);
+    swapBytes(record.indexLength);
+}
+
+void swapBytes(FeatureRecord& record) {
+    swapBytes(record.index);
+    swapBytes(record.sortIndex);
+    swapBytes(record.sourceLayerName);
+    swapBytes(record.bucketName);
+    swapBytes(record.minX);
+    swapBytes(record.minY);
+    swapBytes(record.maxX);
+    swapBytes(record.maxY);
+}
+
+class Writer {
+public:
+    template <class T>
+    void write(T value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be trivially copyable");
+        if (!littleEndian) {
+            swapBytes(value);
+        }
+        data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <class T>
+    void writeArray(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be trivially copyable");
+        write<uint64_t>(values.size());
+        if (littleEndian) {
+            data.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+        } else {
+            for (const auto& value : values) {
+                write(value);
+            }
+        }
+        align();
+    }
+
+    void writeString(const std::string& value) {
+        write<uint64_t>(value.size());
+        data.append(value);
+        align();
+    }
+
+    template <class Attributes>
+    void writeSegments(const SegmentVector<Attributes>& segments) {
+        std::vector<SegmentRecord> records;
+        records.reserve(segments.size());
+        for (const auto& segment : segments) {
+            records.push_back({ segment.vertexOffset, segment.indexOffset,
+                                segment.vertexLength, segment.indexLength });
+        }
+        writeArray(records);
+    }
+
+    std::string data;
+
+private:
+    void align() {
+        data.append((8 - data.size() % 8) % 8, '\0');
+    }
+
+    const bool littleEndian = isLittleEndian();
+};
+
+class Reader {
+public:
+    Reader(const char* data_, std::size_t size_)
+        : data(data_), size(size_) {}
+
+    template <class T>
+    T read() {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be trivially copyable");
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        if (!littleEndian) {
+            swapBytes(value);
+        }
+        return value;
+    }
+
+    template <class T>
+    std::vector<T> readArray() {
+        const auto count = read<uint64_t>();
+        if (count > (size - offset) / sizeof(T)) {
+            throw SnapshotFormatException();
+        }
+        std::vector<T> result(count);
+        std::memcpy(result.data(), take(count * sizeof(T)), count * sizeof(T));
+        if (!littleEndian) {
+            for (auto& value : result) {
+                swapBytes(value);
+            }
+        }
+        align();
+        return result;
+    }
+
+    std::string readString() {
+        const auto length = read<uint64_t>();
+        std::string result(take(length), length);
+        align();
+        return result;
+    }
+
+    template <class Attributes>
+    void readSegments(SegmentVector<Attributes>& segments) {
+        for (const auto& record : readArray<SegmentRecord>()) {
+            segments.emplace_back(record.vertexOffset, record.indexOffset,
+                                  record.vertexLength, record.indexLength);
+        }
+    }
+
+private:
+    const char* take(std::size_t length) {
+        if (length > size - offset) {
+            throw SnapshotFormatException();
+        }
+        const char* result = data + offset;
+        offset += length;
+        return result;
+    }
+
+    void align() {
+        take((8 - offset % 8) % 8);
+    }
+
+    const char* data;
+    const std::size_t size;
+    std::size_t offset = 0;
+    const bool littleEndian = isLittleEndian();
+};
+
+// 64-bit FNV-1a.
+constexpr uint64_t fnvOffsetBasis = 14695981039346656037ull;
+
+uint64_t fnv1a(uint64_t hash, const char* data, std::size_t size) {
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= uint8_t(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+template <class Layer, class Binders>
+bool hasConstantPaintProperties(const std::vector<const RenderLayer*>& group) {
+    for (const auto& layer : group) {
+        if (!Binders::constants(layer->as<Layer>()->evaluated).all()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool isSnapshottable(const std::vector<const RenderLayer*>& group) {
+    const RenderLayer& leader = *group.at(0);
+    if (leader.is<RenderFillLayer>()) {
+        return hasConstantPaintProperties<RenderFillLayer, FillProgram::PaintPropertyBinders>(group);
+    } else if (leader.is<RenderLineLayer>()) {
+        return hasConstantPaintProperties<RenderLineLayer, LineProgram::PaintPropertyBinders>(group);
+    } else if (leader.is<RenderCircleLayer>()) {
+        return hasConstantPaintProperties<RenderCircleLayer, CircleProgram::PaintPropertyBinders>(group);
+    } else {
+        return false;
+    }
+}
+
+} // namespace
+
+constexpr uint32_t TileSnapshot::version;
+
+uint64_t TileSnapshot::hashLayers(const std::vector<Immutable<style::Layer::Impl>>& layers) {
+    // Layers are grouped by their layout key, and buckets are stored by the ID of each
+    // group's leader; both go into the hash. Paint properties don't: the ones a snapshot
+    // can represent are constant, and decode() checks that they still are.
+    uint64_t hash = fnvOffsetBasis;
+    for (const auto& layer : layers) {
+        const std::string key = layoutKey(*layer);
+        hash = fnv1a(hash, layer->id.data(), layer->id.size() + 1);
+        hash = fnv1a(hash, key.data(), key.size() + 1);
+    }
+    return hash;
+}
+
+uint64_t TileSnapshot::hashData(const std::string& data) {
+    return fnv1a(fnvOffsetBasis, data.data(), data.size());
+}
+
+optional<std::string> TileSnapshot::encode(const Key& key,
+                                           const LayerGroups& groups,
+                                           const Buckets& buckets,
+                                           const FeatureIndex& featureIndex) {
+    const OverscaledTileID& tileID = key.tileID;
+
+    Writer writer;
+    writer.write(Header {
+        magic, version, key.layersHash, key.dataHash,
+        tileID.canonical.x, tileID.canonical.y, tileID.canonical.z,
+        tileID.overscaledZ, tileID.wrap, 0
+    });
+
+    // Feature index. Layer and bucket names are stored once in a string table.
+    std::vector<StringIdentity> strings;
+    std::unordered_map<StringIdentity, uint32_t> stringIndices;
+    auto intern = [&] (StringIdentity string) -> uint32_t {
+        auto it = stringIndices.emplace(string, strings.size());
+        if (it.second) {
+            strings.push_back(string);
+        }
+        return it.first->second;
+    };
+
+    std::vector<FeatureRecord> features;
+    features.reserve(featureIndex.grid.getElements().size());
+    for (const auto& element : featureIndex.grid.getElements()) {
+        const IndexedSubfeature& subfeature = element.first;
+        features.push_back({
+            subfeature.index, subfeature.sortIndex,
+            intern(subfeature.sourceLayerName), intern(subfeature.bucketName),
+            element.second.min.x, element.second.min.y, element.second.max.x, element.second.max.y
+        });
+    }
+
+    writer.write<uint64_t>(strings.size());
+    for (const auto& string : strings) {
+        writer.writeString(featureIndex.strings.get(string));
+    }
+    writer.writeArray(features);
+    writer.write<uint64_t>(featureIndex.sortIndex);
+
+    writer.write<uint64_t>(featureIndex.bucketLayerIDs.size());
+    for (const auto& pair : featureIndex.bucketLayerIDs) {
+        writer.writeString(featureIndex.strings.get(pair.first));
+        writer.write<uint64_t>(pair.second.size());
+        for (const auto& layerID : pair.second) {
+            writer.writeString(layerID);
+        }
+    }
+
+    // Buckets. Groups share a single bucket; it is stored once, under the leader's ID.
+    std::vector<std::pair<const std::vector<const RenderLayer*>*, const Bucket*>> groupBuckets;
+    for (const auto& group : groups) {
+        auto it = buckets.find(group.at(0)->getID());
+        if (it == buckets.end()) {
+            continue;
+        }
+        if (!isSnapshottable(group)) {
+            return {};
+        }
+        groupBuckets.emplace_back(&group, it->second.get());
+    }
+
+    writer.write<uint64_t>(groupBuckets.size());
+    for (const auto& groupBucket : groupBuckets) {
+        const RenderLayer& leader = *groupBucket.first->at(0);
+        writer.writeString(leader.getID());
+
+        if (leader.is<RenderFillLayer>()) {
+            const auto& bucket = static_cast<const FillBucket&>(*groupBucket.second);
+            writer.write(uint64_t(BucketType::Fill));
+            writer.writeArray(bucket.vertices.vector());
+            writer.writeArray(bucket.lines.vector());
+            writer.writeArray(bucket.triangles.vector());
+            writer.writeSegments(bucket.lineSegments);
+            writer.writeSegments(bucket.triangleSegments);
+        } else if (leader.is<RenderLineLayer>()) {
+            const auto& bucket = static_cast<const LineBucket&>(*groupBucket.second);
+            writer.write(uint64_t(BucketType::Line));
+            writer.writeArray(bucket.vertices.vector());
+            writer.writeArray(bucket.triangles.vector());
+            writer.writeSegments(bucket.segments);
+        } else {
+            const auto& bucket = static_cast<const CircleBucket&>(*groupBucket.second);
+            writer.write(uint64_t(BucketType::Circle));
+            writer.writeArray(bucket.vertices.vector());
+            writer.writeArray(bucket.triangles.vector());
+            writer.writeSegments(bucket.segments);
+        }
+    }
+
+    return std::move(writer.data);
+}
+
+optional<TileSnapshot::Result> TileSnapshot::decode(const char* data,
+                                                     std::size_t size,
+                                                     const Key& key,
+                                                     const BucketParameters& parameters,
+                                                     const LayerGroups& groups) {
+    const OverscaledTileID& tileID = key.tileID;
+
+    try {
+        Reader reader(data, size);
+
+        const auto header = reader.read<Header>();
+        if (header.magic != magic ||
+            header.version != version ||
+            header.layersHash != key.layersHash ||
+            header.dataHash != key.dataHash ||
+            header.overscaledZ != tileID.overscaledZ ||
+            header.wrap != tileID.wrap ||
+            header.z != tileID.canonical.z ||
+            header.x != tileID.canonical.x ||
+            header.y != tileID.canonical.y) {
+            return {};
+        }
+
+        Result result;
+        result.featureIndex = std::make_unique<FeatureIndex>();
+        FeatureIndex& featureIndex = *result.featureIndex;
+
+        std::vector<StringIdentity> strings;
+        const auto stringCount = reader.read<uint64_t>();
+        for (uint64_t i = 0; i < stringCount; ++i) {
+            strings.push_back(featureIndex.intern(reader.readString()));
+        }
+
+        for (const auto& feature : reader.readArray<FeatureRecord>()) {
+            if (feature.sourceLayerName >= strings.size() || feature.bucketName >= strings.size()) {
+                throw SnapshotFormatException();
+            }
+            featureIndex.grid.insert(
+                IndexedSubfeature { feature.index, strings[feature.sourceLayerName], strings[feature.bucketName], feature.sortIndex },
+                { { feature.minX, feature.minY }, { feature.maxX, feature.maxY } });
+        }
+        featureIndex.sortIndex = reader.read<uint64_t>();
+
+        const auto bucketLayerIDsCount = reader.read<uint64_t>();
+        for (uint64_t i = 0; i < bucketLayerIDsCount; ++i) {
+            std::string bucketName = reader.readString();
+            std::vector<std::string> layerIDs;
+            const auto layerIDCount = reader.read<uint64_t>();
+            for (uint64_t j = 0; j < layerIDCount; ++j) {
+                layerIDs.push_back(reader.readString());
+            }
+            featureIndex.setBucketLayerIDs(bucketName, layerIDs);
+        }
+
+        std::unordered_map<std::string, const std::vector<const RenderLayer*>*> groupsByLeader;
+        for (const auto& group : groups) {
+            groupsByLeader.emplace(group.at(0)->getID(), &group);
+        }
+
+        const auto bucketCount = reader.read<uint64_t>();
+        for (uint64_t i = 0; i < bucketCount; ++i) {
+            const std::string leaderID = reader.readString();
+            const auto type = BucketType(reader.read<uint64_t>());
+
+            auto it = groupsByLeader.find(leaderID);
+            if (it == groupsByLeader.end()) {
+                throw SnapshotFormatException();
+            }
+
+            // A paint property may have become data-driven without changing the layout.
+            const std::vector<const RenderLayer*>& group = *it->second;
+            if (!isSnapshottable(group)) {
+                return {};
+            }
+
+            const RenderLayer& leader = *group.at(0);
+            std::shared_ptr<Bucket> bucket = leader.createBucket(parameters, group);
+
+            if (type == BucketType::Fill && leader.is<RenderFillLayer>()) {
+                auto& fillBucket = static_cast<FillBucket&>(*bucket);
+                fillBucket.vertices.assign(reader.readArray<FillLayoutVertex>());
+                fillBucket.lines.assign(reader.readArray<uint16_t>());
+                fillBucket.triangles.assign(reader.readArray<uint16_t>());
+                reader.readSegments(fillBucket.lineSegments);
+                reader.readSegments(fillBucket.triangleSegments);
+            } else if (type == BucketType::Line && leader.is<RenderLineLayer>()) {
+                auto& lineBucket = static_cast<LineBucket&>(*bucket);
+                lineBucket.vertices.assign(reader.readArray<LineLayoutVertex>());
+                lineBucket.triangles.assign(reader.readArray<uint16_t>());
+                reader.readSegments(lineBucket.segments);
+            } else if (type == BucketType::Circle && leader.is<RenderCircleLayer>()) {
+                auto& circleBucket = static_cast<CircleBucket&>(*bucket);
+                circleBucket.vertices.assign(reader.readArray<CircleLayoutVertex>());
+                circleBucket.triangles.assign(reader.readArray<uint16_t>());
+                reader.readSegments(circleBucket.segments);
+            } else {
+                throw SnapshotFormatException();
+            }
+
+            for (const auto& layer : group) {
+                result.buckets.emplace(layer->getID(), bucket);
+            }
+        }
+
+        return std::move(result);
+    } catch (const SnapshotFormatException&) {
+        return {};
+    }
+}
+
+} // namespace mbgl
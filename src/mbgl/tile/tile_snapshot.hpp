@@ -0,0 +1,80 @@
+#pragma once
+
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/util/immutable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+class Bucket;
+class BucketParameters;
+class FeatureIndex;
+class RenderLayer;
+
+/*
+   A TileSnapshot is a versioned binary image of the non-symbol output of
+   GeometryTileWorker::redoLayout(): the vertex, index and segment arrays of each
+   bucket, and the entries of the tile's FeatureIndex. Restoring a snapshot skips
+   filtering, tessellation and feature indexing entirely.
+
+   Snapshots are keyed by the tile ID, a hash of the style layers that laid the tile
+   out and a hash of the encoded tile data; a snapshot whose key doesn't match is
+   rejected, and the caller is expected to fall back to a regular layout. All values
+   are stored little-endian, whatever the byte order of the host that wrote them, and
+   every array starts on an 8-byte boundary relative to the start of the buffer, so
+   that on little-endian hosts a snapshot can be decoded straight out of a
+   memory-mapped region.
+
+   Only fill, line and circle buckets whose paint properties are all constant can be
+   represented: data-driven paint attributes depend on feature properties and feature
+   states that aren't part of the snapshot.
+*/
+class TileSnapshot {
+public:
+    static constexpr uint32_t version = 1;
+
+    using Buckets = std::unordered_map<std::string, std::shared_ptr<Bucket>>;
+    using LayerGroups = std::vector<std::vector<const RenderLayer*>>;
+
+    class Key {
+    public:
+        OverscaledTileID tileID;
+        uint64_t layersHash;
+        uint64_t dataHash;
+    };
+
+    // Stable across processes and platforms, so that snapshots can be looked up by these
+    // hashes in a cache that outlives the process.
+    static uint64_t hashLayers(const std::vector<Immutable<style::Layer::Impl>>&);
+    static uint64_t hashData(const std::string&);
+
+    // Returns an empty optional if any of the buckets can't be represented. Buckets
+    // must be encoded before they are uploaded, since uploading releases their arrays.
+    static optional<std::string> encode(const Key&,
+                                        const LayerGroups&,
+                                        const Buckets&,
+                                        const FeatureIndex&);
+
+    class Result {
+    public:
+        Buckets buckets;
+        std::unique_ptr<FeatureIndex> featureIndex;
+    };
+
+    // Returns an empty optional if the snapshot is malformed, was written by another
+    // format version, doesn't match the key, or if the layers can no longer be restored.
+    static optional<Result> decode(const char* data,
+                                   std::size_t size,
+                                   const Key&,
+                                   const BucketParameters&,
+                                   const LayerGroups&);
+};
+
+} // namespace mbgl
@@ -22,7 +22,15 @@ void VectorTile::setMetadata(optional<Timestamp> modified_, optional<Timestamp>
 }
 
 void VectorTile::setData(std::shared_ptr<const std::string> data_) {
-    GeometryTile::setData(data_ ? std::make_unique<VectorTileData>(data_) : nullptr);
+    GeometryTile::setData(data_ ? std::make_unique<VectorTileData>(data_) : nullptr, loader.isDataFromCache());
+}
+
+void VectorTile::lookUpSnapshot(uint64_t layersHash, FileSource::SnapshotCallback callback) {
+    loader.getSnapshot(layersHash, std::move(callback));
+}
+
+void VectorTile::putSnapshot(uint64_t layersHash, std::shared_ptr<const std::string> snapshot) {
+    loader.putSnapshot(layersHash, std::move(snapshot));
 }
 
 } // namespace mbgl
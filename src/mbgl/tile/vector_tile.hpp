@@ -19,6 +19,11 @@ public:
     void setMetadata(optional<Timestamp> modified, optional<Timestamp> expires);
     void setData(std::shared_ptr<const std::string> data);
 
+    void putSnapshot(uint64_t layersHash, std::shared_ptr<const std::string>) override;
+
+protected:
+    void lookUpSnapshot(uint64_t layersHash, FileSource::SnapshotCallback) override;
+
 private:
     TileLoader<VectorTile> loader;
 };
@@ -42,6 +42,7 @@ public:
 
     std::unique_ptr<GeometryTileData> clone() const override;
     std::unique_ptr<GeometryTileLayer> getLayer(const std::string& name) const override;
+    std::shared_ptr<const std::string> getEncodedData() const override { return data; }
 
     std::vector<std::string> layerNames() const;
 
@@ -2,6 +2,7 @@
 
 #include <zlib.h>
 
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <stdexcept>
@@ -63,31 +64,58 @@ std::string compress(const std::string &raw) {
 }
 
 std::string decompress(const std::string &raw) {
+    return decompress(raw.data(), raw.size());
+}
+
+// Larger than almost any tile, but small enough that a forged size can't exhaust memory.
+static constexpr std::size_t maxPresizedLength = 8 * 1024 * 1024;
+
+std::string decompress(const char* raw, std::size_t size) {
     z_stream inflate_stream;
     memset(&inflate_stream, 0, sizeof(inflate_stream));
 
     // TODO: reuse z_streams
-    if (inflateInit(&inflate_stream) != Z_OK) {
+    // Accepts both zlib and gzip headers; tiles in MBTiles archives are gzipped.
+    if (inflateInit2(&inflate_stream, MAX_WBITS + 32) != Z_OK) {
         throw std::runtime_error("failed to initialize inflate");
     }
 
-    inflate_stream.next_in = (Bytef *)raw.data();
-    inflate_stream.avail_in = uInt(raw.size());
+    inflate_stream.next_in = (Bytef *)raw;
+    inflate_stream.avail_in = uInt(size);
+
+    // The gzip trailer records the uncompressed size. When we have it, we inflate straight into
+    // a buffer of that size. Zlib streams don't record it, so we inflate those in blocks.
+    std::size_t expected = 0;
+    if (size >= 18 && uint8_t(raw[0]) == 0x1F && uint8_t(raw[1]) == 0x8B) {
+        const auto* trailer = reinterpret_cast<const uint8_t*>(raw + size - 4);
+        expected = std::size_t(trailer[0]) | std::size_t(trailer[1]) << 8 |
+                   std::size_t(trailer[2]) << 16 | std::size_t(trailer[3]) << 24;
+        // The trailer is untrusted input, and the buffer is filled before inflating. Deflate
+        // can't do better than about 1:1032, so anything above that is a bogus size; anything
+        // above the cap is inflated in blocks instead, and only grows as output arrives.
+        if (expected > size * 1032 || expected > maxPresizedLength) {
+            expected = 0;
+        }
+    }
 
-    std::string result;
-    char out[15384];
+    std::string result(expected, '\0');
+    char out[16384];
 
     int code;
     do {
-        inflate_stream.next_out = reinterpret_cast<Bytef *>(out);
-        inflate_stream.avail_out = sizeof(out);
-        code = inflate(&inflate_stream, 0);
-        // result.append(out, sizeof(out) - inflate_stream.avail_out);
-        if (result.size() < inflate_stream.total_out) {
-            result.append(out, inflate_stream.total_out - result.size());
+        if (inflate_stream.total_out < result.size()) {
+            inflate_stream.next_out = reinterpret_cast<Bytef *>(&result[inflate_stream.total_out]);
+            inflate_stream.avail_out = uInt(result.size() - inflate_stream.total_out);
+            code = inflate(&inflate_stream, 0);
+        } else {
+            inflate_stream.next_out = reinterpret_cast<Bytef *>(out);
+            inflate_stream.avail_out = sizeof(out);
+            code = inflate(&inflate_stream, 0);
+            result.append(out, sizeof(out) - inflate_stream.avail_out);
         }
     } while (code == Z_OK);
 
+    result.resize(inflate_stream.total_out);
     inflateEnd(&inflate_stream);
 
     if (code != Z_STREAM_END) {
@@ -2,7 +2,7 @@
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/math/minmax.hpp>
 
-#include <unordered_set>
+#include <cmath>
 
 namespace mbgl {
 
@@ -17,65 +17,83 @@ GridIndex<T>::GridIndex(int32_t extent_, int32_t n_, int32_t padding_) :
     min(-double(padding) / n * extent),
     max(extent + double(padding) / n * extent)
     {
-        cells.resize(d * d);
+        cellOffsets.resize(d * d + 1);
     }
 
 template <class T>
 void GridIndex<T>::insert(T&& t, const BBox& bbox) {
-    size_t uid = elements.size();
-
-    auto cx1 = convertToCellCoord(bbox.min.x);
-    auto cy1 = convertToCellCoord(bbox.min.y);
-    auto cx2 = convertToCellCoord(bbox.max.x);
-    auto cy2 = convertToCellCoord(bbox.max.y);
-
-    int32_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = d * y + x;
-            cells[cellIndex].push_back(uid);
-        }
-    }
-
-    elements.emplace_back(t, bbox);
+    elements.emplace_back(std::move(t), bbox);
+    cellsDirty.store(true, std::memory_order_relaxed);
 }
 
 template <class T>
 std::vector<T> GridIndex<T>::query(const BBox& queryBBox) const {
     std::vector<T> result;
-    std::unordered_set<size_t> seenUids;
-
-    auto cx1 = convertToCellCoord(queryBBox.min.x);
-    auto cy1 = convertToCellCoord(queryBBox.min.y);
-    auto cx2 = convertToCellCoord(queryBBox.max.x);
-    auto cy2 = convertToCellCoord(queryBBox.max.y);
-
-    int32_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = d * y + x;
-            for (auto uid : cells[cellIndex]) {
-                if (seenUids.count(uid) == 0) {
-                    seenUids.insert(uid);
+    query(queryBBox, [&] (const T& t, const BBox&) {
+        result.push_back(t);
+    });
+    return result;
+}
 
-                    auto& pair = elements.at(uid);
-                    auto& bbox = pair.second;
-                    if (queryBBox.min.x <= bbox.max.x &&
-                        queryBBox.min.y <= bbox.max.y &&
-                        queryBBox.max.x >= bbox.min.x &&
-                        queryBBox.max.y >= bbox.min.y) {
+template <class T>
+void GridIndex<T>::ensureCells() const {
+    if (cellsDirty.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(cellsMutex);
+        if (cellsDirty.load(std::memory_order_relaxed)) {
+            buildCells();
+            cellsDirty.store(false, std::memory_order_release);
+        }
+    }
+}
 
-                        result.push_back(pair.first);
-                    }
-                }
+template <class T>
+void GridIndex<T>::buildCells() const {
+    auto forEachCell = [&] (const BBox& bbox, auto fn) {
+        auto cx1 = convertToCellCoord(bbox.min.x);
+        auto cy1 = convertToCellCoord(bbox.min.y);
+        auto cx2 = convertToCellCoord(bbox.max.x);
+        auto cy2 = convertToCellCoord(bbox.max.y);
+
+        for (int32_t x = cx1; x <= cx2; ++x) {
+            for (int32_t y = cy1; y <= cy2; ++y) {
+                fn(d * y + x);
             }
         }
+    };
+
+    // Count the entries of each cell, then turn the counts into offsets.
+    std::fill(cellOffsets.begin(), cellOffsets.end(), 0);
+    for (const auto& element : elements) {
+        forEachCell(element.second, [&] (int32_t cellIndex) {
+            cellOffsets[cellIndex + 1]++;
+        });
+    }
+    for (std::size_t i = 1; i < cellOffsets.size(); ++i) {
+        cellOffsets[i] += cellOffsets[i - 1];
     }
 
-    return result;
+    const uint32_t entryCount = cellOffsets.back();
+    entryElements.resize(entryCount);
+    entryMinX.resize(entryCount);
+    entryMinY.resize(entryCount);
+    entryMaxX.resize(entryCount);
+    entryMaxY.resize(entryCount);
+
+    // Fill in entries in insertion order, so that each cell lists its elements in that order.
+    std::vector<uint32_t> cursors(cellOffsets.begin(), cellOffsets.end() - 1);
+    for (uint32_t uid = 0; uid < elements.size(); ++uid) {
+        const BBox& bbox = elements[uid].second;
+        forEachCell(bbox, [&] (int32_t cellIndex) {
+            const uint32_t entry = cursors[cellIndex]++;
+            entryElements[entry] = uid;
+            entryMinX[entry] = bbox.min.x;
+            entryMinY[entry] = bbox.min.y;
+            entryMaxX[entry] = bbox.max.x;
+            entryMaxY[entry] = bbox.max.y;
+        });
+    }
 }
 
-
 template <class T>
 int32_t GridIndex<T>::convertToCellCoord(int32_t x) const {
     return util::max(0.0, util::min(d - 1.0, std::floor(x * scale) + padding));
@@ -3,8 +3,11 @@
 #include <mapbox/geometry/point.hpp>
 #include <mapbox/geometry/box.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstddef>
+#include <mutex>
 #include <vector>
 
 namespace mbgl {
@@ -19,8 +22,18 @@ public:
     void insert(T&& t, const BBox&);
     std::vector<T> query(const BBox&) const;
 
+    // Calls fn(const T&, const BBox&) once for every element whose box intersects
+    // the query box, in the same order as query(), without allocating.
+    template <class Fn>
+    void query(const BBox&, Fn&&) const;
+
+    // All elements in insertion order, along with the box they were inserted with.
+    const std::vector<std::pair<T, BBox>>& getElements() const { return elements; }
+
 private:
     int32_t convertToCellCoord(int32_t x) const;
+    void buildCells() const;
+    void ensureCells() const;
 
     const int32_t extent;
     const int32_t n;
@@ -31,8 +44,77 @@ private:
     const int32_t max;
 
     std::vector<std::pair<T, BBox>> elements;
-    std::vector<std::vector<size_t>> cells;
 
+    // Cell contents in compressed sparse row layout, rebuilt on the first query after
+    // an insertion: the entries of cell i are [cellOffsets[i], cellOffsets[i + 1]).
+    // Each entry carries a copy of its element's box in separate arrays, so that the
+    // intersection tests for a cell run over contiguous int16 data.
+    // Concurrent queries may race to rebuild the cells; only one of them does, under the
+    // mutex, and the others wait for it.
+    mutable std::atomic<bool> cellsDirty { false };
+    mutable std::mutex cellsMutex;
+    mutable std::vector<uint32_t> cellOffsets;
+    mutable std::vector<uint32_t> entryElements;
+    mutable std::vector<int16_t> entryMinX;
+    mutable std::vector<int16_t> entryMinY;
+    mutable std::vector<int16_t> entryMaxX;
+    mutable std::vector<int16_t> entryMaxY;
 };
 
+template <class T>
+template <class Fn>
+void GridIndex<T>::query(const BBox& queryBBox, Fn&& fn) const {
+    ensureCells();
+
+    const int32_t cx1 = convertToCellCoord(queryBBox.min.x);
+    const int32_t cy1 = convertToCellCoord(queryBBox.min.y);
+    const int32_t cx2 = convertToCellCoord(queryBBox.max.x);
+    const int32_t cy2 = convertToCellCoord(queryBBox.max.y);
+
+    const int16_t qMinX = queryBBox.min.x;
+    const int16_t qMinY = queryBBox.min.y;
+    const int16_t qMaxX = queryBBox.max.x;
+    const int16_t qMaxY = queryBBox.max.y;
+
+    constexpr uint32_t blockSize = 32;
+    uint8_t hits[blockSize];
+
+    for (int32_t x = cx1; x <= cx2; ++x) {
+        for (int32_t y = cy1; y <= cy2; ++y) {
+            const int32_t cellIndex = d * y + x;
+            const uint32_t end = cellOffsets[cellIndex + 1];
+
+            for (uint32_t begin = cellOffsets[cellIndex]; begin < end; begin += blockSize) {
+                const uint32_t count = std::min(blockSize, end - begin);
+                const int16_t* minX = entryMinX.data() + begin;
+                const int16_t* minY = entryMinY.data() + begin;
+                const int16_t* maxX = entryMaxX.data() + begin;
+                const int16_t* maxY = entryMaxY.data() + begin;
+
+                // Kept branch-free so that the compiler can vectorize it.
+                for (uint32_t i = 0; i < count; ++i) {
+                    hits[i] = (qMinX <= maxX[i]) & (qMinY <= maxY[i]) &
+                              (qMaxX >= minX[i]) & (qMaxY >= minY[i]);
+                }
+
+                for (uint32_t i = 0; i < count; ++i) {
+                    if (!hits[i]) {
+                        continue;
+                    }
+
+                    // Elements are listed in every cell they cover. Only report them from
+                    // the first of those cells that this query visits.
+                    const auto& element = elements[entryElements[begin + i]];
+                    if (x != std::max(cx1, convertToCellCoord(element.second.min.x)) ||
+                        y != std::max(cy1, convertToCellCoord(element.second.min.y))) {
+                        continue;
+                    }
+
+                    fn(element.first, element.second);
+                }
+            }
+        }
+    }
+}
+
 } // namespace mbgl
@@ -0,0 +1,21 @@
+#include <mbgl/util/string_indexer.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+StringIdentity StringIndexer::get(const std::string& string) {
+    auto it = identities.emplace(string, StringIdentity(strings.size()));
+    if (it.second) {
+        strings.push_back(string);
+    }
+    return it.first->second;
+}
+
+const std::string& StringIndexer::get(StringIdentity identity) const {
+    assert(identity < strings.size());
+    // Elements of a deque aren't moved when it grows, so the reference stays valid.
+    return strings[identity];
+}
+
+} // namespace mbgl
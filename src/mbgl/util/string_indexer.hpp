@@ -0,0 +1,28 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+using StringIdentity = uint32_t;
+
+// Maps strings to small integer identities that stay valid for the lifetime of the indexer.
+// Meant for names from a small set, such as the layer and source layer IDs of a tile, which
+// would otherwise be copied into every indexed feature. Not thread-safe; an indexer is filled
+// by one thread and may then be read from another once it has been handed over.
+class StringIndexer : private util::noncopyable {
+public:
+    StringIdentity get(const std::string&);
+    const std::string& get(StringIdentity) const;
+
+private:
+    std::unordered_map<std::string, StringIdentity> identities;
+    std::deque<std::string> strings;
+};
+
+} // namespace mbgl
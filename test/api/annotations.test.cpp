@@ -356,6 +356,73 @@ TEST(Annotations, QueryRenderedFeatures) {
     EXPECT_EQ(*features2[0].id, uint64_t(1));
 }
 
+TEST(Annotations, UpdateAcrossTiles) {
+    AnnotationTest test;
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+    test.map.addAnnotationImage(namedMarker("default_marker"));
+    test.map.setLatLngZoom({ 0, 0 }, 3);
+
+    // Only the tiles around the old and new positions of an annotation are regenerated.
+    AnnotationID point = test.map.addAnnotation(SymbolAnnotation { Point<double> { -20, 20 }, "default_marker" });
+    test.map.addAnnotation(SymbolAnnotation { Point<double> { 20, 20 }, "default_marker" });
+    test.map.addAnnotation(LineAnnotation { LineString<double> {{ { -30, -30 }, { -10, -10 } }} });
+    test.frontend.render(test.map);
+
+    test.map.updateAnnotation(point, SymbolAnnotation { Point<double> { 20, -20 }, "default_marker" });
+    test.frontend.render(test.map);
+
+    auto renderer = test.frontend.getRenderer();
+    EXPECT_EQ(0u, renderer->queryRenderedFeatures(test.map.pixelForLatLng({ 20, -20 })).size());
+    EXPECT_EQ(1u, renderer->queryRenderedFeatures(test.map.pixelForLatLng({ -20, 20 })).size());
+    EXPECT_EQ(1u, renderer->queryRenderedFeatures(test.map.pixelForLatLng({ 20, 20 })).size());
+
+    test.map.removeAnnotation(point);
+    test.frontend.render(test.map);
+
+    EXPECT_EQ(0u, renderer->queryRenderedFeatures(test.map.pixelForLatLng({ -20, 20 })).size());
+    EXPECT_EQ(1u, renderer->queryRenderedFeatures(test.map.pixelForLatLng({ 20, 20 })).size());
+}
+
+TEST(Annotations, Bulk) {
+    AnnotationTest test;
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+    test.map.addAnnotationImage(namedMarker("default_marker"));
+    test.map.setLatLngZoom({ 0, 0 }, 3);
+
+    AnnotationIDs ids = test.map.addAnnotations({
+        SymbolAnnotation { Point<double> { -20, 20 }, "default_marker" },
+        SymbolAnnotation { Point<double> { 20, 20 }, "default_marker" },
+        LineAnnotation { LineString<double> {{ { -30, -30 }, { -10, -10 } }} },
+    });
+    ASSERT_EQ(3u, ids.size());
+    EXPECT_EQ(ids[0] + 1, ids[1]);
+    EXPECT_EQ(ids[1] + 1, ids[2]);
+    test.frontend.render(test.map);
+
+    auto renderer = test.frontend.getRenderer();
+    EXPECT_EQ(1u, renderer->queryRenderedFeatures(test.map.pixelForLatLng({ 20, -20 })).size());
+    EXPECT_EQ(1u, renderer->queryRenderedFeatures(test.map.pixelForLatLng({ 20, 20 })).size());
+
+    test.map.updateAnnotations({
+        { ids[0], SymbolAnnotation { Point<double> { 20, -20 }, "default_marker" } },
+        { ids[1], SymbolAnnotation { Point<double> { -20, -20 }, "default_marker" } },
+    });
+    test.frontend.render(test.map);
+
+    EXPECT_EQ(0u, renderer->queryRenderedFeatures(test.map.pixelForLatLng({ 20, -20 })).size());
+    EXPECT_EQ(0u, renderer->queryRenderedFeatures(test.map.pixelForLatLng({ 20, 20 })).size());
+    EXPECT_EQ(1u, renderer->queryRenderedFeatures(test.map.pixelForLatLng({ -20, 20 })).size());
+    EXPECT_EQ(1u, renderer->queryRenderedFeatures(test.map.pixelForLatLng({ -20, -20 })).size());
+
+    test.map.removeAnnotations({ ids[0], ids[2] });
+    test.frontend.render(test.map);
+
+    EXPECT_EQ(0u, renderer->queryRenderedFeatures(test.map.pixelForLatLng({ -20, 20 })).size());
+    EXPECT_EQ(1u, renderer->queryRenderedFeatures(test.map.pixelForLatLng({ -20, -20 })).size());
+}
+
 TEST(Annotations, QueryFractionalZoomLevels) {
     AnnotationTest test;
 
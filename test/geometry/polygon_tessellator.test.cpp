@@ -0,0 +1,69 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/geometry/polygon_tessellator.hpp>
+
+using namespace mbgl;
+
+static const GeometryCollection square {
+    { {0, 0}, {0, 40}, {40, 40}, {40, 0}, {0, 0} }
+};
+
+static const GeometryCollection squareWithHoles {
+    { {0, 0}, {0, 40}, {40, 40}, {40, 0}, {0, 0} },
+    { {30, 30}, {32, 30}, {32, 32}, {30, 30} },
+    { {10, 10}, {20, 10}, {20, 20}, {10, 10} },
+    { {100, 100}, {100, 140}, {140, 140}, {140, 100}, {100, 100} }
+};
+
+TEST(PolygonTessellator, ClassifyRings) {
+    PolygonTessellator tessellator;
+
+    const auto& polygons = tessellator.classifyRings(squareWithHoles, 500);
+    ASSERT_EQ(2u, polygons.size());
+    ASSERT_EQ(3u, polygons[0].size());
+    ASSERT_EQ(1u, polygons[1].size());
+    EXPECT_EQ(squareWithHoles[0].begin(), polygons[0][0].begin());
+    EXPECT_EQ(squareWithHoles[3].begin(), polygons[1][0].begin());
+}
+
+TEST(PolygonTessellator, LimitHoles) {
+    PolygonTessellator tessellator;
+
+    const auto& polygons = tessellator.classifyRings(squareWithHoles, 1);
+    ASSERT_EQ(2u, polygons.size());
+
+    // Keeps the hole with the largest area.
+    ASSERT_EQ(2u, polygons[0].size());
+    EXPECT_EQ(squareWithHoles[2].begin(), polygons[0][1].begin());
+}
+
+TEST(PolygonTessellator, MatchesClassifyRings) {
+    PolygonTessellator tessellator;
+
+    for (const auto& geometry : { square, squareWithHoles, GeometryCollection {} }) {
+        std::vector<GeometryCollection> expected = classifyRings(geometry);
+        for (auto& polygon : expected) {
+            limitHoles(polygon, 1);
+        }
+
+        const auto& polygons = tessellator.classifyRings(geometry, 1);
+        ASSERT_EQ(expected.size(), polygons.size());
+        for (std::size_t i = 0; i < expected.size(); i++) {
+            ASSERT_EQ(expected[i].size(), polygons[i].size());
+            for (std::size_t j = 0; j < expected[i].size(); j++) {
+                EXPECT_EQ(expected[i][j], GeometryCoordinates(polygons[i][j].begin(), polygons[i][j].end()));
+            }
+        }
+    }
+}
+
+TEST(PolygonTessellator, Tessellate) {
+    PolygonTessellator tessellator;
+
+    const auto& indices = tessellator.tessellate(tessellator.classifyRings(square, 500).front());
+    EXPECT_EQ(6u, indices.size());
+
+    // Seven distinct vertices and one hole make seven triangles.
+    const auto& holeIndices = tessellator.tessellate(tessellator.classifyRings(squareWithHoles, 1).front());
+    EXPECT_EQ(21u, holeIndices.size());
+}
@@ -8,12 +8,24 @@
 #include <mbgl/renderer/buckets/raster_bucket.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/renderer/feature_states.hpp>
+#include <mbgl/renderer/render_layer.hpp>
+#include <mbgl/renderer/layers/render_symbol_layer.hpp>
+#include <mbgl/renderer/transition_parameters.hpp>
+#include <mbgl/renderer/property_evaluation_parameters.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/conversion.hpp>
+#include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/style/expression/parsing_context.hpp>
+#include <mbgl/util/rapidjson.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/headless_backend.hpp>
 
 #include <mbgl/map/mode.hpp>
 
+#include <cstring>
+
 namespace mbgl {
 
 template <class Attributes>
@@ -40,6 +52,25 @@ namespace {
 
 PropertyMap properties;
 
+class StubGeometryTileLayer : public GeometryTileLayer {
+public:
+    std::size_t featureCount() const override {
+        return features.size();
+    }
+
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override {
+        fetched.push_back(i);
+        return std::make_unique<StubGeometryTileFeature>(features.at(i));
+    }
+
+    std::string getName() const override {
+        return "water";
+    }
+
+    std::vector<StubGeometryTileFeature> features;
+    mutable std::vector<std::size_t> fetched;
+};
+
 } // namespace
 
 TEST(Buckets, CircleBucket) {
@@ -79,6 +110,62 @@ TEST(Buckets, FillBucket) {
     ASSERT_FALSE(bucket.needsUpload());
 }
 
+TEST(Buckets, FillBucketFeatureState) {
+    HeadlessBackend backend({ 512, 256 });
+    BackendScope scope { backend };
+
+    JSDocument document;
+    document.Parse<0>(R"(["number", ["coalesce", ["feature-state", "opacity"], 0.25]])");
+    const JSValue* value = &document;
+    style::expression::ParsingContext ctx;
+    style::expression::ParseResult parsed = ctx.parse(style::conversion::Convertible(value));
+    ASSERT_TRUE(bool(parsed));
+
+    style::FillLayer layer { "fill", "source" };
+    layer.setSourceLayer("water");
+    layer.setFillOpacity(style::SourceFunction<float>(std::move(*parsed)));
+    auto renderLayer = RenderLayer::create(layer.baseImpl);
+    renderLayer->transition(TransitionParameters { Clock::time_point::max(), style::TransitionOptions() });
+    renderLayer->evaluate(PropertyEvaluationParameters { 0 });
+
+    GeometryCollection polygon { { { 0, 0 }, { 0, 1 }, { 1, 1 } } };
+    StubGeometryTileLayer sourceLayer;
+    sourceLayer.features.push_back({ { uint64_t(1) }, FeatureType::Polygon, polygon, properties });
+    sourceLayer.features.push_back({ { uint64_t(2) }, FeatureType::Polygon, polygon, properties });
+
+    std::vector<std::unique_ptr<GeometryTileFeature>> features;
+    features.push_back(sourceLayer.getFeature(0));
+    features.push_back(sourceLayer.getFeature(1));
+    sourceLayer.fetched.clear();
+
+    gl::Context context;
+    FillBucket bucket { { {0, 0, 0}, MapMode::Still, 1.0 }, { renderLayer.get() } };
+    bucket.addFeatures(features, { polygon, polygon }, { 0, 1 });
+    bucket.upload(context);
+    ASSERT_FALSE(bucket.needsUpload());
+
+    const auto& statistics = bucket.paintPropertyBinders.at("fill").statistics<style::FillOpacity>();
+    EXPECT_EQ(0.25f, *statistics.max());
+
+    // Only the feature whose state changed is fetched and re-evaluated.
+    LayerFeatureStates states;
+    states.set("2", {{ "opacity", 0.75 }});
+    bucket.setFeatureStates(states.changedSince(0), sourceLayer);
+    EXPECT_EQ(std::vector<std::size_t> { 1 }, sourceLayer.fetched);
+    EXPECT_EQ(0.75f, *statistics.max());
+    ASSERT_TRUE(bucket.needsUpload());
+
+    bucket.upload(context);
+    ASSERT_FALSE(bucket.needsUpload());
+
+    // States of features the bucket doesn't contain don't trigger an upload.
+    sourceLayer.fetched.clear();
+    states.set("3", {{ "opacity", 1.0 }});
+    bucket.setFeatureStates(states.changedSince(1), sourceLayer);
+    EXPECT_TRUE(sourceLayer.fetched.empty());
+    EXPECT_FALSE(bucket.needsUpload());
+}
+
 TEST(Buckets, LineBucket) {
     HeadlessBackend backend({ 512, 256 });
     BackendScope scope { backend };
@@ -133,6 +220,61 @@ TEST(Buckets, SymbolBucket) {
     ASSERT_FALSE(bucket.needsUpload());
 }
 
+TEST(Buckets, SymbolBucketFeatureState) {
+    HeadlessBackend backend({ 512, 256 });
+    BackendScope scope { backend };
+
+    JSDocument document;
+    document.Parse<0>(R"(["number", ["coalesce", ["feature-state", "opacity"], 0.25]])");
+    const JSValue* value = &document;
+    style::expression::ParsingContext ctx;
+    style::expression::ParseResult parsed = ctx.parse(style::conversion::Convertible(value));
+    ASSERT_TRUE(bool(parsed));
+
+    style::SymbolLayoutProperties::PossiblyEvaluated layout;
+    style::IconPaintProperties::PossiblyEvaluated iconPaint;
+    style::TextPaintProperties::PossiblyEvaluated textPaint;
+    textPaint.get<style::TextOpacity>() = PossiblyEvaluatedPropertyValue<float>(style::SourceFunction<float>(std::move(*parsed)));
+
+    GeometryCollection point { { { 0, 0 } } };
+    StubGeometryTileLayer sourceLayer;
+    sourceLayer.features.push_back({ { uint64_t(1) }, FeatureType::Point, point, properties });
+    sourceLayer.features.push_back({ { uint64_t(2) }, FeatureType::Point, point, properties });
+    auto first = sourceLayer.getFeature(0);
+    auto second = sourceLayer.getFeature(1);
+    sourceLayer.fetched.clear();
+
+    gl::Context context;
+    SymbolBucket bucket { layout, { { "symbol", { iconPaint, textPaint } } }, 16.0f, 1.0f, 0, false, false };
+
+    // Lays out four text vertices per feature, the way SymbolLayout::place() does.
+    bucket.text.segments.emplace_back(0, 0);
+    for (std::size_t i = 0; i < 8; i++) {
+        bucket.text.vertices.emplace_back(SymbolLayoutVertex {});
+    }
+    bucket.paintPropertyBinders.at("symbol").first.populateVertexVectors(
+        std::vector<FeatureVertexRange> { { first.get(), 0, 0 }, { second.get(), 1, 0 } });
+    bucket.paintPropertyBinders.at("symbol").second.populateVertexVectors(
+        std::vector<FeatureVertexRange> { { first.get(), 0, 4 }, { second.get(), 1, 8 } });
+    bucket.upload(context);
+    ASSERT_FALSE(bucket.needsUpload());
+
+    const auto& statistics = bucket.paintPropertyBinders.at("symbol").second.statistics<style::TextOpacity>();
+    EXPECT_EQ(0.25f, *statistics.max());
+
+    LayerFeatureStates states;
+    states.set("2", {{ "opacity", 0.75 }});
+    bucket.setFeatureStates(states.changedSince(0), sourceLayer);
+    EXPECT_EQ(std::vector<std::size_t> { 1 }, sourceLayer.fetched);
+    EXPECT_EQ(0.75f, *statistics.max());
+    ASSERT_TRUE(bucket.needsUpload());
+
+    // Only the paint vertices are uploaded again; the layout buffers are kept.
+    bucket.upload(context);
+    ASSERT_FALSE(bucket.needsUpload());
+    EXPECT_TRUE(bool(bucket.text.vertexBuffer));
+}
+
 TEST(Buckets, RasterBucket) {
     HeadlessBackend backend({ 512, 256 });
     BackendScope scope { backend };
@@ -152,6 +294,47 @@ TEST(Buckets, RasterBucket) {
     ASSERT_TRUE(bucket.needsUpload());
 }
 
+TEST(Buckets, RasterBucketPacked) {
+    HeadlessBackend backend({ 512, 256 });
+    BackendScope scope { backend };
+
+    gl::Context context;
+
+    PremultipliedImage opaque({ 2, 1 });
+    const uint8_t pixels[] = { 255, 0, 0, 255, 8, 4, 8, 255 };
+    std::copy(std::begin(pixels), std::end(pixels), opaque.data.get());
+
+    auto rgb = packRasterImage(opaque, RasterTextureFormat::RGB);
+    ASSERT_TRUE(bool(rgb));
+    EXPECT_EQ(6u, rgb->bytes());
+    EXPECT_EQ((std::vector<uint8_t>{ 255, 0, 0, 8, 4, 8 }),
+              std::vector<uint8_t>(rgb->data.get(), rgb->data.get() + rgb->bytes()));
+
+    RasterBucket bucket = { std::move(opaque), RasterTextureFormat::RGB565 };
+    ASSERT_TRUE(bucket.hasData());
+    ASSERT_FALSE(bucket.image);
+    ASSERT_TRUE(bool(bucket.packedImage));
+    uint16_t packed[2];
+    std::memcpy(packed, bucket.packedImage->data.get(), sizeof(packed));
+    EXPECT_EQ(uint16_t(0xF800), packed[0]);
+    EXPECT_EQ(uint16_t(0x0821), packed[1]);
+
+    EXPECT_EQ(0u, bucket.getTextureBytes());
+    bucket.upload(context);
+    EXPECT_EQ(4u, bucket.getTextureBytes());
+
+    // Images with transparent pixels keep all four channels.
+    PremultipliedImage transparent({ 2, 1 });
+    transparent.fill(255);
+    transparent.data[7] = 254;
+    EXPECT_FALSE(packRasterImage(transparent, RasterTextureFormat::RGB565));
+
+    RasterBucket rgbaBucket = { std::move(transparent), RasterTextureFormat::RGB565 };
+    ASSERT_TRUE(bool(rgbaBucket.image));
+    rgbaBucket.upload(context);
+    EXPECT_EQ(8u, rgbaBucket.getTextureBytes());
+}
+
 TEST(Buckets, RasterBucketMaskEmpty) {
     RasterBucket bucket{ nullptr };
     bucket.setMask({});
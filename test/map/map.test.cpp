@@ -6,6 +6,7 @@
 #include <mbgl/map/map.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/headless_frontend.hpp>
+#include <mbgl/renderer/renderer.hpp>
 #include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/storage/network_status.hpp>
 #include <mbgl/storage/default_file_source.hpp>
@@ -446,6 +447,23 @@ TEST(Map, AddLayer) {
     test::checkImage("test/fixtures/map/add_layer", test.frontend.render(test.map));
 }
 
+TEST(Map, FrameStatistics) {
+    MapTest<> test;
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+    EXPECT_EQ(0u, test.frontend.getRenderer()->getLastFrameStatistics().drawCalls);
+
+    auto layer = std::make_unique<BackgroundLayer>("background");
+    layer->setBackgroundColor({ { 1, 0, 0, 1 } });
+    test.map.getStyle().addLayer(std::move(layer));
+    test.frontend.render(test.map);
+
+    // A background layer without a pattern is drawn once per tile that covers the viewport.
+    const FrameStatistics statistics = test.frontend.getRenderer()->getLastFrameStatistics();
+    EXPECT_LT(0u, statistics.drawCalls);
+    EXPECT_LE(Duration::zero(), statistics.submissionTime);
+}
+
 TEST(Map, WithoutVAOExtension) {
     MapTest<DefaultFileSource> test { ":memory:", "test/fixtures/api/assets" };
 
@@ -652,3 +670,29 @@ TEST(Map, NoContentTiles) {
                      0.0015,
                      0.1);
 }
+
+TEST(Map, RasterTextureFormat) {
+    util::RunLoop runLoop;
+    ThreadPool threadPool(4);
+    StubFileSource fileSource;
+    HeadlessFrontend frontend { { 512, 512 }, 1, fileSource, threadPool };
+    Map map(frontend, MapObserver::nullObserver(), frontend.getSize(), 1, fileSource, threadPool, MapMode::Still);
+
+    fileSource.response = [] (const Resource&) -> optional<Response> {
+        Response response;
+        response.data = std::make_shared<std::string>(
+            util::read_file("test/fixtures/map/prefetch/tile_green.png"));
+        return { std::move(response) };
+    };
+
+    EXPECT_EQ(RasterTextureFormat::RGBA, map.getRasterTextureFormat());
+    map.setRasterTextureFormat(RasterTextureFormat::RGB565);
+    EXPECT_EQ(RasterTextureFormat::RGB565, map.getRasterTextureFormat());
+
+    map.setPrefetchZoomDelta(0);
+    map.getStyle().loadJSON(util::read_file("test/fixtures/map/prefetch/style.json"));
+    map.setLatLngZoom({ 40.726989, -73.992857 }, 10);
+
+    // Pure green has an exact RGB565 representation.
+    test::checkImage("test/fixtures/map/prefetch", frontend.render(map));
+}
@@ -0,0 +1,34 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/renderer/feature_states.hpp>
+
+using namespace mbgl;
+
+TEST(FeatureStates, ChangedSince) {
+    LayerFeatureStates states;
+    EXPECT_EQ(0u, states.getVersion());
+    EXPECT_TRUE(states.changedSince(0).empty());
+    EXPECT_EQ(nullptr, states.get("a"));
+
+    states.set("a", {{ "hover", true }});
+    states.set("b", {{ "hover", true }});
+    EXPECT_EQ(2u, states.getVersion());
+
+    // Setting merges into the current state.
+    states.set("a", {{ "selected", true }});
+    ASSERT_NE(nullptr, states.get("a"));
+    EXPECT_EQ((FeatureState {{ "hover", true }, { "selected", true }}), *states.get("a"));
+
+    // Each feature is listed once, in the order of its last change.
+    auto changes = states.changedSince(0);
+    ASSERT_EQ(2u, changes.size());
+    EXPECT_EQ("b", changes[0].featureID);
+    EXPECT_EQ("a", changes[1].featureID);
+    EXPECT_EQ(*states.get("a"), changes[1].state);
+
+    changes = states.changedSince(2);
+    ASSERT_EQ(1u, changes.size());
+    EXPECT_EQ("a", changes[0].featureID);
+
+    EXPECT_TRUE(states.changedSince(states.getVersion()).empty());
+}
@@ -108,12 +108,14 @@ TEST(ImageManager, RemoveReleasesBinPackRect) {
 
 class StubImageRequestor : public ImageRequestor {
 public:
-    void onImagesAvailable(ImageMap images, uint64_t imageCorrelationID_) final {
+    void onImagesAvailable(ImageMap images, ImagePositions positions_, uint64_t imageCorrelationID_) final {
+        positions = std::move(positions_);
         if (imagesAvailable && imageCorrelationID == imageCorrelationID_) imagesAvailable(images);
     }
 
     std::function<void (ImageMap)> imagesAvailable;
     uint64_t imageCorrelationID = 0;
+    ImagePositions positions;
 };
 
 TEST(ImageManager, NotifiesRequestorWhenSpriteIsLoaded) {
@@ -148,3 +150,77 @@ TEST(ImageManager, NotifiesRequestorImmediatelyIfDependenciesAreSatisfied) {
 
     ASSERT_TRUE(notified);
 }
+
+TEST(ImageManager, SharesIconsBetweenRequestors) {
+    ImageManager imageManager;
+    imageManager.setLoaded(true);
+    imageManager.addImage(makeMutable<style::Image::Impl>("one", PremultipliedImage({ 16, 16 }), 1));
+    imageManager.addImage(makeMutable<style::Image::Impl>("two", PremultipliedImage({ 16, 16 }), 1));
+
+    StubImageRequestor a;
+    StubImageRequestor b;
+    imageManager.getImages(a, std::make_pair(std::set<std::string> { "one" }, 1));
+    imageManager.getImages(b, std::make_pair(std::set<std::string> { "one", "two" }, 1));
+
+    ASSERT_EQ(1u, a.positions.size());
+    ASSERT_EQ(2u, b.positions.size());
+    EXPECT_EQ(a.positions.at("one").tl(), b.positions.at("one").tl());
+    EXPECT_NE(b.positions.at("one").tl(), b.positions.at("two").tl());
+    const auto one = a.positions.at("one");
+
+    // An icon keeps its place while any requestor still holds it.
+    imageManager.removeRequestor(b);
+    imageManager.getImages(b, std::make_pair(std::set<std::string> { "two" }, 2));
+    imageManager.getImages(a, std::make_pair(std::set<std::string> { "one" }, 2));
+    imageManager.releaseImages(a, 2);
+    EXPECT_EQ(one.tl(), a.positions.at("one").tl());
+
+    // An update of the same size doesn't move the icon.
+    imageManager.updateImage(makeMutable<style::Image::Impl>("one", PremultipliedImage({ 16, 16 }), 1));
+    const auto before = a.positions.at("one");
+    imageManager.getImages(a, std::make_pair(std::set<std::string> { "one" }, 3));
+    imageManager.releaseImages(a, 3);
+    EXPECT_EQ(before.tl(), a.positions.at("one").tl());
+
+    // Once nothing holds an icon anymore, its space is reused.
+    const auto two = b.positions.at("two");
+    imageManager.removeRequestor(b);
+    imageManager.addImage(makeMutable<style::Image::Impl>("three", PremultipliedImage({ 16, 16 }), 1));
+    imageManager.getImages(a, std::make_pair(std::set<std::string> { "one", "three" }, 4));
+    imageManager.releaseImages(a, 4);
+    EXPECT_EQ(two.tl(), a.positions.at("three").tl());
+}
+
+TEST(ImageManager, UpdatesIncompatibleIconsOutOfPlace) {
+    ImageManager imageManager;
+    imageManager.setLoaded(true);
+    imageManager.addImage(makeMutable<style::Image::Impl>("one", PremultipliedImage({ 16, 16 }), 1));
+
+    StubImageRequestor requestor;
+    imageManager.getImages(requestor, std::make_pair(std::set<std::string> { "one" }, 1));
+    const auto before = requestor.positions.at("one");
+
+    // Icons already laid out with the old pixel ratio must keep it, so the new image
+    // doesn't overwrite them even though it has the same size.
+    imageManager.updateImage(makeMutable<style::Image::Impl>("one", PremultipliedImage({ 16, 16 }), 2));
+    imageManager.getImages(requestor, std::make_pair(std::set<std::string> { "one" }, 2));
+    imageManager.releaseImages(requestor, 2);
+    const auto after = requestor.positions.at("one");
+    EXPECT_NE(before.tl(), after.tl());
+    EXPECT_EQ(2.0f, after.pixelRatio);
+}
+
+TEST(ImageManager, ShrinksWhenUnused) {
+    ImageManager imageManager;
+    imageManager.setLoaded(true);
+    imageManager.addImage(makeMutable<style::Image::Impl>("big", PremultipliedImage({ 100, 100 }), 1));
+
+    StubImageRequestor requestor;
+    imageManager.getImages(requestor, std::make_pair(std::set<std::string> { "big" }, 1));
+    ASSERT_EQ(1u, requestor.positions.size());
+    EXPECT_LE(102u, imageManager.getPixelSize().width);
+
+    imageManager.removeRequestor(requestor);
+    EXPECT_EQ(Size(64, 64), imageManager.getPixelSize());
+    EXPECT_EQ(Size(64, 64), imageManager.getAtlasImage().size);
+}
@@ -0,0 +1,77 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/renderer/style_diff.hpp>
+#include <mbgl/style/layers/background_layer.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+using Layers = std::vector<ImmutableLayer>;
+
+Immutable<Layers> makeLayers(Layers layers) {
+    return makeMutable<Layers>(std::move(layers));
+}
+
+ImmutableLayer line(const std::string& id) {
+    return LineLayer(id, "source").baseImpl;
+}
+
+} // namespace
+
+TEST(StyleDiff, Unchanged) {
+    auto layers = makeLayers({ line("a"), line("b") });
+    auto diff = diffLayers(layers, layers);
+    EXPECT_TRUE(diff.added.empty());
+    EXPECT_TRUE(diff.removed.empty());
+    EXPECT_TRUE(diff.changed.empty());
+}
+
+TEST(StyleDiff, Changed) {
+    LineLayer b("b", "source");
+    auto before = makeLayers({ line("a"), b.baseImpl, line("c") });
+    b.setLineWidth(2.0f);
+    auto after = makeLayers({ (*before)[0], b.baseImpl, (*before)[2] });
+
+    auto diff = diffLayers(before, after);
+    EXPECT_TRUE(diff.added.empty());
+    EXPECT_TRUE(diff.removed.empty());
+    ASSERT_EQ(1u, diff.changed.size());
+    EXPECT_EQ((*before)[1], diff.changed.at("b").before);
+    EXPECT_EQ((*after)[1], diff.changed.at("b").after);
+}
+
+TEST(StyleDiff, AddedRemoved) {
+    auto before = makeLayers({ line("a"), line("b"), line("c") });
+    auto after = makeLayers({ (*before)[0], line("d"), (*before)[2] });
+
+    auto diff = diffLayers(before, after);
+    EXPECT_EQ(1u, diff.added.count("d"));
+    EXPECT_EQ(1u, diff.removed.count("b"));
+    EXPECT_TRUE(diff.changed.empty());
+}
+
+TEST(StyleDiff, TypeChanged) {
+    auto before = makeLayers({ line("a") });
+    auto after = makeLayers({ BackgroundLayer("a").baseImpl });
+
+    auto diff = diffLayers(before, after);
+    EXPECT_EQ(1u, diff.added.count("a"));
+    EXPECT_EQ(1u, diff.removed.count("a"));
+    EXPECT_TRUE(diff.changed.empty());
+}
+
+TEST(StyleDiff, Moved) {
+    auto before = makeLayers({ line("a"), line("b"), line("c"), line("d") });
+    auto after = makeLayers({ (*before)[0], (*before)[2], (*before)[3], (*before)[1] });
+
+    // Only the layer that left its place among the others is reported.
+    auto diff = diffLayers(before, after);
+    ASSERT_EQ(1u, diff.added.size());
+    ASSERT_EQ(1u, diff.removed.size());
+    EXPECT_EQ(1u, diff.added.count("b"));
+    EXPECT_EQ(1u, diff.removed.count("b"));
+    EXPECT_TRUE(diff.changed.empty());
+}
@@ -0,0 +1,136 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/fake_file_source.hpp>
+
+#include <mbgl/storage/cache_only_file_source.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/gl/headless_frontend.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+class CacheFileSource : public FakeFileSource {
+public:
+    bool supportsCacheOnlyRequests() const override {
+        return true;
+    }
+};
+
+} // namespace
+
+TEST(CacheOnlyFileSource, RequestsAreCacheOnly) {
+    CacheFileSource cache;
+    CacheOnlyFileSource fs(cache);
+
+    auto req = fs.request(Resource::style("http://example.com/style.json"), [] (Response) {});
+    ASSERT_EQ(1u, cache.requests.size());
+    EXPECT_EQ(Resource::LoadingMethod::CacheOnly, cache.requests.front()->resource.loadingMethod);
+}
+
+TEST(CacheOnlyFileSource, Miss) {
+    CacheFileSource cache;
+    CacheOnlyFileSource fs(cache);
+
+    bool called = false;
+    auto req = fs.request(Resource::tile("http://example.com/{z}-{x}-{y}.vector.pbf", 1, 0, 0, 0, Tileset::Scheme::XYZ), [&] (Response res) {
+        called = true;
+        ASSERT_NE(nullptr, res.error);
+        EXPECT_EQ(Response::Error::Reason::Other, res.error->reason);
+        EXPECT_FALSE(res.noContent);
+    });
+
+    Response miss;
+    miss.noContent = true;
+    miss.error = std::make_unique<Response::Error>(Response::Error::Reason::NotFound, "Not found in offline database");
+    cache.respond(Resource::Tile, miss);
+    EXPECT_TRUE(called);
+}
+
+TEST(CacheOnlyFileSource, Stale) {
+    CacheFileSource cache;
+    CacheOnlyFileSource fs(cache);
+
+    bool called = false;
+    auto req = fs.request(Resource::style("http://example.com/style.json"), [&] (Response res) {
+        called = true;
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("stale", *res.data);
+    });
+
+    Response stale;
+    stale.data = std::make_shared<std::string>("stale");
+    stale.error = std::make_unique<Response::Error>(Response::Error::Reason::NotFound, "Cached resource is unusable");
+    cache.respond(Resource::Style, stale);
+    EXPECT_TRUE(called);
+}
+
+TEST(CacheOnlyFileSource, TileSnapshots) {
+    class SnapshotCacheFileSource : public CacheFileSource {
+    public:
+        bool supportsTileSnapshots() const override {
+            return true;
+        }
+
+        void getTileSnapshot(const Resource&, uint64_t, SnapshotCallback callback) override {
+            callback(stored);
+        }
+
+        void putTileSnapshot(const Resource&, uint64_t, std::shared_ptr<const std::string> snapshot) override {
+            stored = std::move(snapshot);
+        }
+
+        std::shared_ptr<const std::string> stored;
+    };
+
+    CacheFileSource plainCache;
+    EXPECT_FALSE(CacheOnlyFileSource(plainCache).supportsTileSnapshots());
+
+    SnapshotCacheFileSource cache;
+    CacheOnlyFileSource fs(cache);
+    EXPECT_TRUE(fs.supportsTileSnapshots());
+
+    const Resource tile = Resource::tile("http://example.com/{z}-{x}-{y}.vector.pbf", 1, 0, 0, 0, Tileset::Scheme::XYZ);
+    fs.putTileSnapshot(tile, 1, std::make_shared<const std::string>("snapshot"));
+    ASSERT_NE(nullptr, cache.stored);
+
+    std::shared_ptr<const std::string> snapshot;
+    fs.getTileSnapshot(tile, 1, [&] (std::shared_ptr<const std::string> result) {
+        snapshot = std::move(result);
+    });
+    ASSERT_NE(nullptr, snapshot);
+    EXPECT_EQ("snapshot", *snapshot);
+}
+
+// A still image that needs a tile that isn't cached fails rather than waiting for it.
+TEST(CacheOnlyFileSource, StillImageFailsOnMiss) {
+    util::RunLoop loop;
+    ThreadPool threadPool(4);
+    DefaultFileSource cache(":memory:", ".");
+    CacheOnlyFileSource fileSource(cache);
+    HeadlessFrontend frontend { { 256, 256 }, 1, fileSource, threadPool };
+    Map map(frontend, MapObserver::nullObserver(), frontend.getSize(), 1, fileSource, threadPool, MapMode::Still);
+
+    map.getStyle().loadJSON(R"STYLE({
+      "version": 8,
+      "sources": {
+        "mapbox": {
+          "type": "vector",
+          "tiles": ["http://example.com/{z}-{x}-{y}.vector.pbf"]
+        }
+      },
+      "layers": [{
+        "id": "water",
+        "type": "fill",
+        "source": "mapbox",
+        "source-layer": "water"
+      }]
+    })STYLE");
+
+    EXPECT_THROW(frontend.render(map), std::exception);
+}
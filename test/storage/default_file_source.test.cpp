@@ -307,6 +307,182 @@ TEST(DefaultFileSource, OptionalExpired) {
     loop.run();
 }
 
+TEST(DefaultFileSource, CoalesceIdenticalRequests) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    const Resource cachedResource { Resource::Unknown, "http://127.0.0.1:3000/test", {}, Resource::LoadingMethod::CacheOnly };
+    const Resource otherResource { Resource::Unknown, "http://127.0.0.1:3000/other", {}, Resource::LoadingMethod::CacheOnly };
+
+    using namespace std::chrono_literals;
+
+    Response response;
+    response.data = std::make_shared<std::string>("Cached value");
+    response.expires = util::now() + 1h;
+    fs.put(cachedResource, response);
+
+    std::shared_ptr<const std::string> data1;
+    std::shared_ptr<const std::string> data2;
+    bool otherResponded = false;
+
+    std::unique_ptr<AsyncRequest> req1 = fs.request(cachedResource, [&](Response res) {
+        data1 = res.data;
+    });
+    std::unique_ptr<AsyncRequest> req2 = fs.request(cachedResource, [&](Response res) {
+        data2 = res.data;
+    });
+    std::unique_ptr<AsyncRequest> req3 = fs.request(otherResource, [&](Response res) {
+        EXPECT_TRUE(res.noContent);
+        otherResponded = true;
+    });
+
+    // Identical requests share one response buffer; the other one goes to the cache on its own.
+    fs.getDuplicateRequestCount([&](uint64_t count) {
+        EXPECT_EQ(1u, count);
+        loop.stop();
+    });
+
+    loop.run();
+
+    ASSERT_TRUE(data1.get());
+    EXPECT_EQ("Cached value", *data1);
+    EXPECT_EQ(data1, data2);
+    EXPECT_TRUE(otherResponded);
+}
+
+TEST(DefaultFileSource, ResolvedURLsReadCacheSeparately) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+    fs.setAPIBaseURL("http://127.0.0.1:3000");
+    fs.setAccessToken("key");
+
+    const Resource mapboxResource { Resource::Style, "mapbox://styles/user/style", {}, Resource::LoadingMethod::CacheOnly };
+    const Resource resolvedResource { Resource::Style, "http://127.0.0.1:3000/styles/v1/user/style?access_token=key", {}, Resource::LoadingMethod::CacheOnly };
+
+    int responses = 0;
+    auto callback = [&](Response res) {
+        EXPECT_TRUE(res.noContent);
+        responses++;
+    };
+
+    std::unique_ptr<AsyncRequest> req1 = fs.request(mapboxResource, callback);
+    std::unique_ptr<AsyncRequest> req2 = fs.request(resolvedResource, callback);
+
+    // The mapbox:// URL resolves to the other one, but the cache stores them under different
+    // keys, so each reads the cache on its own.
+    fs.getDuplicateRequestCount([&](uint64_t count) {
+        EXPECT_EQ(0u, count);
+        loop.stop();
+    });
+
+    loop.run();
+
+    EXPECT_EQ(2, responses);
+}
+
+TEST(DefaultFileSource, TEST_REQUIRES_SERVER(CoalesceNetworkRequests)) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/delayed" };
+    const Resource networkOnlyResource { Resource::Unknown, "http://127.0.0.1:3000/delayed", {}, Resource::LoadingMethod::NetworkOnly };
+
+    std::vector<std::shared_ptr<const std::string>> data;
+    auto callback = [&](Response res) {
+        EXPECT_EQ(nullptr, res.error);
+        data.push_back(res.data);
+        if (data.size() == 3) {
+            loop.stop();
+        }
+    };
+
+    // The first two are identical. The third skips the cache, but still shares the fetch that
+    // the others make once they miss it.
+    std::unique_ptr<AsyncRequest> req1 = fs.request(resource, callback);
+    std::unique_ptr<AsyncRequest> req2 = fs.request(resource, callback);
+    std::unique_ptr<AsyncRequest> req3 = fs.request(networkOnlyResource, callback);
+
+    loop.run();
+
+    ASSERT_TRUE(data[0].get());
+    EXPECT_EQ("Response", *data[0]);
+    EXPECT_EQ(data[0], data[1]);
+    EXPECT_EQ(data[0], data[2]);
+
+    fs.getDuplicateRequestCount([&](uint64_t count) {
+        EXPECT_EQ(2u, count);
+        loop.stop();
+    });
+
+    loop.run();
+}
+
+TEST(DefaultFileSource, TEST_REQUIRES_SERVER(CoalescedRequestCancel)) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/delayed" };
+
+    std::unique_ptr<AsyncRequest> req1 = fs.request(resource, [&](Response) {
+        ADD_FAILURE() << "Callback should not be called";
+    });
+    std::unique_ptr<AsyncRequest> req2 = fs.request(resource, [&](Response res) {
+        req2.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Response", *res.data);
+        loop.stop();
+    });
+
+    // Cancelling one of the requests leaves the shared one running for the other.
+    req1.reset();
+
+    loop.run();
+}
+
+TEST(DefaultFileSource, TEST_REQUIRES_SERVER(CoalescedRevalidationKeepsData)) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/revalidate-same" };
+
+    using namespace std::chrono_literals;
+
+    // Stale, but usable, so that it is sent right away and then revalidated.
+    Response response;
+    response.data = std::make_shared<std::string>("Response");
+    response.etag = std::string("snowfall");
+    response.expires = util::now() - 1h;
+    fs.put(resource, response);
+
+    std::unique_ptr<AsyncRequest> req1;
+    std::unique_ptr<AsyncRequest> req2;
+
+    req1 = fs.request(resource, [&](Response res) {
+        // The first 304 carries the cached data; the ones after it don't.
+        if (!res.notModified) {
+            return;
+        }
+
+        // A request that joins now is sent the data along with the refreshed expiration.
+        req2 = fs.request(resource, [&](Response res2) {
+            req1.reset();
+            req2.reset();
+
+            EXPECT_EQ(nullptr, res2.error);
+            EXPECT_FALSE(res2.notModified);
+            ASSERT_TRUE(res2.data.get());
+            EXPECT_EQ("Response", *res2.data);
+            EXPECT_TRUE(bool(res2.expires));
+            EXPECT_TRUE(res2.mustRevalidate);
+
+            loop.stop();
+        });
+    });
+
+    loop.run();
+}
+
 TEST(DefaultFileSource, GetBaseURLAndAccessTokenWhilePaused) {
     util::RunLoop loop;
     DefaultFileSource fs(":memory:", ".");
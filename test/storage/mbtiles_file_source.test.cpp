@@ -0,0 +1,117 @@
+#include <mbgl/storage/mbtiles_file_source.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <unistd.h>
+#include <climits>
+#include <gtest/gtest.h>
+
+namespace {
+
+std::string toAbsoluteURL(const std::string& fileName) {
+    char buff[PATH_MAX + 1];
+    char* cwd = getcwd( buff, PATH_MAX + 1 );
+    std::string url = { "mbtiles://" + std::string(cwd) + "/test/fixtures/storage/mbtiles/" + fileName };
+    assert(url.size() <= PATH_MAX);
+    return url;
+}
+
+} // namespace
+
+using namespace mbgl;
+
+TEST(MBTilesFileSource, AcceptsURL) {
+    EXPECT_TRUE(MBTilesFileSource::acceptsURL("mbtiles:///tiles.mbtiles"));
+    EXPECT_FALSE(MBTilesFileSource::acceptsURL("file:///tiles.mbtiles"));
+    EXPECT_FALSE(MBTilesFileSource::acceptsURL("http://example.com/tiles.mbtiles"));
+}
+
+TEST(MBTilesFileSource, TileJSON) {
+    util::RunLoop loop;
+
+    MBTilesFileSource fs;
+
+    const std::string url = toAbsoluteURL("archive.mbtiles");
+    std::unique_ptr<AsyncRequest> req = fs.request(Resource::source(url), [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ(R"({"tilejson":"2.2.0","scheme":"tms","tiles":[")" + url + R"(/{z}/{x}/{y}"],)"
+                  R"("minzoom":0,"maxzoom":1,"name":"Test","attribution":"Test attribution"})",
+                  *res.data);
+        loop.stop();
+    });
+
+    loop.run();
+}
+
+TEST(MBTilesFileSource, Tile) {
+    util::RunLoop loop;
+
+    MBTilesFileSource fs;
+
+    const std::string urlTemplate = toAbsoluteURL("archive.mbtiles") + "/{z}/{x}/{y}";
+
+    // Stored gzipped.
+    std::unique_ptr<AsyncRequest> req1 = fs.request(Resource::tile(urlTemplate, 1, 0, 0, 0, Tileset::Scheme::TMS), [&](Response res) {
+        req1.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("tile 0/0/0", *res.data);
+    });
+
+    // Row 0 is at the bottom of the map in the TMS scheme.
+    std::unique_ptr<AsyncRequest> req2 = fs.request(Resource::tile(urlTemplate, 1, 0, 1, 1, Tileset::Scheme::TMS), [&](Response res) {
+        req2.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("tile 1/0/0", *res.data);
+        loop.stop();
+    });
+
+    loop.run();
+}
+
+TEST(MBTilesFileSource, MissingTile) {
+    util::RunLoop loop;
+
+    MBTilesFileSource fs;
+
+    const std::string urlTemplate = toAbsoluteURL("archive.mbtiles") + "/{z}/{x}/{y}";
+    std::unique_ptr<AsyncRequest> req = fs.request(Resource::tile(urlTemplate, 1, 1, 1, 1, Tileset::Scheme::TMS), [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        EXPECT_TRUE(res.noContent);
+        EXPECT_FALSE(res.data.get());
+        loop.stop();
+    });
+
+    loop.run();
+}
+
+TEST(MBTilesFileSource, NonExistentArchive) {
+    util::RunLoop loop;
+
+    MBTilesFileSource fs;
+
+    std::unique_ptr<AsyncRequest> req = fs.request(Resource::source(toAbsoluteURL("does_not_exist.mbtiles")), [&](Response res) {
+        req.reset();
+        ASSERT_NE(nullptr, res.error);
+        EXPECT_EQ(Response::Error::Reason::NotFound, res.error->reason);
+        ASSERT_FALSE(res.data.get());
+        loop.stop();
+    });
+
+    loop.run();
+}
+
+TEST(MBTilesFileSource, Cancel) {
+    util::RunLoop loop;
+
+    MBTilesFileSource fs;
+
+    fs.request(Resource::source(toAbsoluteURL("archive.mbtiles")), [&](Response) {
+        FAIL() << "Callback should not be called";
+    });
+
+    loop.runOnce();
+}
@@ -219,6 +219,31 @@ TEST(OfflineDatabase, PutTile) {
     EXPECT_EQ("second", *updateGetResult->data);
 }
 
+TEST(OfflineDatabase, PutTileSnapshot) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+
+    Resource resource = Resource::tile("http://example.com/{z}-{x}-{y}.vector.pbf", 1, 0, 0, 0, Tileset::Scheme::XYZ);
+    auto snapshot = std::make_shared<const std::string>("snapshot");
+
+    // Snapshots are only kept for tiles that are in the cache.
+    db.putTileSnapshot(resource, 1, snapshot);
+    EXPECT_EQ(nullptr, db.getTileSnapshot(resource, 1));
+
+    Response response;
+    response.data = std::make_shared<std::string>("tile");
+    db.put(resource, response);
+
+    db.putTileSnapshot(resource, 1, snapshot);
+    ASSERT_NE(nullptr, db.getTileSnapshot(resource, 1));
+    EXPECT_EQ("snapshot", *db.getTileSnapshot(resource, 1));
+    EXPECT_EQ(nullptr, db.getTileSnapshot(resource, 2));
+
+    db.putTileSnapshot(resource, 1, std::make_shared<const std::string>("replaced"));
+    EXPECT_EQ("replaced", *db.getTileSnapshot(resource, 1));
+}
+
 TEST(OfflineDatabase, PutResourceNoContent) {
     using namespace mbgl;
 
@@ -386,6 +411,43 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ConcurrentUse)) {
     thread2.join();
 }
 
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ReadOnlyConnection)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+    deleteFile("test/fixtures/offline_database/offline.db-wal");
+    deleteFile("test/fixtures/offline_database/offline.db-shm");
+
+    OfflineDatabase writer("test/fixtures/offline_database/offline.db");
+    writer.enableConcurrentReads();
+    OfflineDatabase reader("test/fixtures/offline_database/offline.db", OfflineDatabase::ReadOnly);
+
+    Resource resource = Resource::style("http://example.com/");
+    EXPECT_FALSE(bool(reader.get(resource)));
+
+    Response response;
+    response.data = std::make_shared<std::string>("first");
+    writer.put(resource, response);
+
+    std::thread thread([&] {
+        for (auto i = 0; i < 100; i++) {
+            auto res = reader.get(resource);
+            ASSERT_TRUE(res && res->data);
+            EXPECT_TRUE(*res->data == "first" || *res->data == "second");
+        }
+    });
+
+    response.data = std::make_shared<std::string>("second");
+    for (auto i = 0; i < 100; i++) {
+        writer.put(resource, response);
+        writer.markAccessed(resource);
+    }
+
+    thread.join();
+    EXPECT_EQ("second", *reader.get(resource)->data);
+}
+
 static std::shared_ptr<std::string> randomString(size_t size) {
     auto result = std::make_shared<std::string>(size, 0);
     std::mt19937 random;
@@ -415,6 +477,30 @@ TEST(OfflineDatabase, PutReturnsSize) {
     EXPECT_EQ(0u, db.put(Resource::style("http://example.com/noContent"), noContent).second);
 }
 
+TEST(OfflineDatabase, GetReturnsStoredData) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+
+    Response compressible;
+    compressible.data = std::make_shared<std::string>(1024, 'a');
+    db.put(Resource::style("http://example.com/compressible"), compressible);
+    EXPECT_EQ(*compressible.data, *db.get(Resource::style("http://example.com/compressible"))->data);
+
+    Response incompressible;
+    incompressible.data = randomString(1024);
+    db.put(Resource::style("http://example.com/incompressible"), incompressible);
+    EXPECT_EQ(*incompressible.data, *db.get(Resource::style("http://example.com/incompressible"))->data);
+
+    Response empty;
+    empty.data = std::make_shared<std::string>();
+    db.put(Resource::style("http://example.com/empty"), empty);
+    auto res = db.get(Resource::style("http://example.com/empty"));
+    EXPECT_FALSE(res->noContent);
+    ASSERT_TRUE(res->data.get());
+    EXPECT_EQ("", *res->data);
+}
+
 TEST(OfflineDatabase, PutEvictsLeastRecentlyUsedResources) {
     using namespace mbgl;
 
@@ -432,6 +518,27 @@ TEST(OfflineDatabase, PutEvictsLeastRecentlyUsedResources) {
     EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
 }
 
+TEST(OfflineDatabase, TileSnapshotsAreEvictedWithTheirTile) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:", 1024 * 100);
+
+    Response response;
+    response.data = randomString(1024);
+
+    Resource first = Resource::tile("http://example.com/{z}-{x}-{y}.vector.pbf", 1, 0, 0, 0, Tileset::Scheme::XYZ);
+    db.put(first, response);
+    db.putTileSnapshot(first, 1, std::make_shared<const std::string>("snapshot"));
+    ASSERT_NE(nullptr, db.getTileSnapshot(first, 1));
+
+    for (uint32_t i = 1; i <= 100; i++) {
+        db.put(Resource::tile("http://example.com/{z}-{x}-{y}.vector.pbf", 1, i, 0, 7, Tileset::Scheme::XYZ), response);
+    }
+
+    EXPECT_FALSE(bool(db.get(first)));
+    EXPECT_EQ(nullptr, db.getTileSnapshot(first, 1));
+}
+
 TEST(OfflineDatabase, PutRegionResourceDoesNotEvict) {
     using namespace mbgl;
 
@@ -661,7 +768,7 @@ TEST(OfflineDatabase, MigrateFromV2Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion("test/fixtures/offline_database/migrated.db"));
+    EXPECT_EQ(7, databaseUserVersion("test/fixtures/offline_database/migrated.db"));
     EXPECT_LT(databasePageCount("test/fixtures/offline_database/migrated.db"),
               databasePageCount("test/fixtures/offline_database/v2.db"));
 }
@@ -682,7 +789,7 @@ TEST(OfflineDatabase, MigrateFromV3Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion("test/fixtures/offline_database/migrated.db"));
+    EXPECT_EQ(7, databaseUserVersion("test/fixtures/offline_database/migrated.db"));
 }
 
 TEST(OfflineDatabase, MigrateFromV4Schema) {
@@ -701,7 +808,7 @@ TEST(OfflineDatabase, MigrateFromV4Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion("test/fixtures/offline_database/migrated.db"));
+    EXPECT_EQ(7, databaseUserVersion("test/fixtures/offline_database/migrated.db"));
 
     // Journal mode should be DELETE after migration to v5.
     EXPECT_EQ("delete", databaseJournalMode("test/fixtures/offline_database/migrated.db"));
@@ -727,7 +834,7 @@ TEST(OfflineDatabase, MigrateFromV5Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion("test/fixtures/offline_database/migrated.db"));
+    EXPECT_EQ(7, databaseUserVersion("test/fixtures/offline_database/migrated.db"));
 
     EXPECT_EQ((std::vector<std::string>{ "id", "url_template", "pixel_ratio", "z", "x", "y",
                                          "expires", "modified", "etag", "data", "compressed",
@@ -738,6 +845,44 @@ TEST(OfflineDatabase, MigrateFromV5Schema) {
               databaseTableColumns("test/fixtures/offline_database/migrated.db", "resources"));
 }
 
+TEST(OfflineDatabase, MigrateFromV6Schema) {
+    using namespace mbgl;
+
+    // v6.db is a v6 database containing a single tile.
+
+    deleteFile("test/fixtures/offline_database/migrated.db");
+    writeFile("test/fixtures/offline_database/migrated.db", util::read_file("test/fixtures/offline_database/v6.db"));
+
+    {
+        OfflineDatabase db("test/fixtures/offline_database/migrated.db", 0);
+        Resource resource = Resource::tile("http://example.com/{z}-{x}-{y}.vector.pbf", 1, 0, 0, 0, Tileset::Scheme::XYZ);
+        EXPECT_TRUE(bool(db.get(resource)));
+        EXPECT_EQ(nullptr, db.getTileSnapshot(resource, 0));
+    }
+
+    EXPECT_EQ(7, databaseUserVersion("test/fixtures/offline_database/migrated.db"));
+
+    EXPECT_EQ((std::vector<std::string>{ "tile_id", "layers_hash", "data" }),
+              databaseTableColumns("test/fixtures/offline_database/migrated.db", "tile_snapshots"));
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ConcurrentReadsRestoreJournalMode)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    {
+        OfflineDatabase writer("test/fixtures/offline_database/offline.db");
+        writer.enableConcurrentReads();
+        OfflineDatabase reader("test/fixtures/offline_database/offline.db", OfflineDatabase::ReadOnly);
+
+        EXPECT_EQ("wal", databaseJournalMode("test/fixtures/offline_database/offline.db"));
+    }
+
+    EXPECT_EQ("delete", databaseJournalMode("test/fixtures/offline_database/offline.db"));
+}
+
 TEST(OfflineDatabase, DowngradeSchema) {
     using namespace mbgl;
 
@@ -751,7 +896,7 @@ TEST(OfflineDatabase, DowngradeSchema) {
         OfflineDatabase db("test/fixtures/offline_database/migrated.db", 0);
     }
 
-    EXPECT_EQ(6, databaseUserVersion("test/fixtures/offline_database/migrated.db"));
+    EXPECT_EQ(7, databaseUserVersion("test/fixtures/offline_database/migrated.db"));
 
     EXPECT_EQ((std::vector<std::string>{ "id", "url_template", "pixel_ratio", "z", "x", "y",
                                          "expires", "modified", "etag", "data", "compressed",
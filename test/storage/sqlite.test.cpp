@@ -36,3 +36,33 @@ TEST(SQLite, TEST_REQUIRES_WRITE(CantOpenException)) {
         ASSERT_EQ(ex.code, mapbox::sqlite::Exception::Code::CANTOPEN);
     }
 }
+
+TEST(SQLite, Blob) {
+    mapbox::sqlite::Database db(":memory:", mapbox::sqlite::Create | mapbox::sqlite::ReadWrite);
+    db.exec("CREATE TABLE test (data BLOB);");
+
+    mapbox::sqlite::Statement insert = db.prepare("INSERT INTO test (data) VALUES (?1);");
+    insert.bindBlob(1, "\0bytes", 6);
+    insert.run();
+    insert.reset();
+    insert.bindBlob(1, "", 0);
+    insert.run();
+    db.exec("INSERT INTO test (data) VALUES (NULL);");
+
+    mapbox::sqlite::Statement select = db.prepare("SELECT data FROM test ORDER BY rowid;");
+
+    ASSERT_TRUE(select.run());
+    auto blob = select.getBlob(0);
+    ASSERT_NE(nullptr, blob.first);
+    EXPECT_EQ(std::string("\0bytes", 6), std::string(blob.first, blob.second));
+
+    ASSERT_TRUE(select.run());
+    blob = select.getBlob(0);
+    EXPECT_NE(nullptr, blob.first);
+    EXPECT_EQ(0u, blob.second);
+
+    ASSERT_TRUE(select.run());
+    blob = select.getBlob(0);
+    EXPECT_EQ(nullptr, blob.first);
+    EXPECT_EQ(0u, blob.second);
+}
@@ -0,0 +1,134 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/style/conversion.hpp>
+#include <mbgl/util/rapidjson.hpp>
+#include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/style/expression/parsing_context.hpp>
+#include <mbgl/style/expression/compiled_expression.hpp>
+
+#include <rapidjson/document.h>
+
+using namespace mbgl;
+using namespace mbgl::style;
+using namespace mbgl::style::expression;
+
+using namespace std::string_literals;
+
+static std::unique_ptr<Expression> parse(const std::string& json) {
+    JSDocument document;
+    document.Parse<0>(json.c_str());
+    assert(!document.HasParseError());
+    const JSValue* value = &document;
+    ParsingContext ctx;
+    ParseResult parsed = ctx.parse(conversion::Convertible(value));
+    return parsed ? std::move(*parsed) : nullptr;
+}
+
+static const std::vector<StubGeometryTileFeature> features {
+    StubGeometryTileFeature { PropertyMap {} },
+    StubGeometryTileFeature { PropertyMap {{ "x", 3.5 }, { "s", "a"s }, { "b", true }} },
+    StubGeometryTileFeature { PropertyMap {{ "x", uint64_t(7) }, { "s", "b"s }, { "b", false }} },
+    StubGeometryTileFeature { PropertyMap {{ "x", int64_t(-2) }, { "s", "c"s }} },
+    StubGeometryTileFeature { PropertyMap {{ "x", "7"s }, { "s", 1.0 }, { "b", "yes"s }} },
+    StubGeometryTileFeature { PropertyMap {{ "x", 1e9 }, { "s", ""s }} }
+};
+
+static const std::vector<optional<float>> zooms { {}, 0.0f, 4.5f, 10.0f, 22.0f };
+
+static void expectSameResult(const std::string& json) {
+    auto tree = parse(json);
+    ASSERT_TRUE(bool(tree)) << json;
+
+    auto compiled = CompiledExpression::compile(*tree);
+    ASSERT_TRUE(bool(compiled)) << json;
+
+    for (const auto& zoom : zooms) {
+        for (const auto& feature : features) {
+            const EvaluationContext context { zoom, &feature, {} };
+            const EvaluationResult expected = tree->evaluate(context);
+            const EvaluationResult actual = compiled->evaluate(context);
+
+            ASSERT_EQ(bool(expected), bool(actual)) << json;
+            if (expected) {
+                EXPECT_EQ(*expected, *actual) << json;
+            } else {
+                EXPECT_EQ(expected.error().message, actual.error().message) << json;
+            }
+        }
+    }
+}
+
+TEST(CompiledExpression, Constant) {
+    expectSameResult(R"(["+", 1, ["*", 2, 3]])");
+    expectSameResult(R"(["sqrt", 16])");
+    expectSameResult(R"(["concat", "a", "b"])");
+
+    // Out-of-range constants are rejected while parsing, before there is anything to compile.
+    EXPECT_FALSE(bool(parse(R"(["rgba", 300, 0, 0, 1])")));
+}
+
+TEST(CompiledExpression, Properties) {
+    expectSameResult(R"(["get", "x"])");
+    expectSameResult(R"(["has", "x"])");
+    expectSameResult(R"(["number", ["get", "x"]])");
+    expectSameResult(R"(["number", ["get", "s"], ["get", "x"], 0])");
+    expectSameResult(R"(["string", ["get", "s"]])");
+    expectSameResult(R"(["boolean", ["get", "b"]])");
+    expectSameResult(R"(["coalesce", ["get", "missing"], ["get", "x"], 0])");
+}
+
+TEST(CompiledExpression, Math) {
+    expectSameResult(R"(["+", ["zoom"], ["number", ["get", "x"], 0], 1])");
+    expectSameResult(R"(["-", ["number", ["get", "x"], 0]])");
+    expectSameResult(R"(["/", ["number", ["get", "x"], 0], ["+", ["zoom"], 1]])");
+    expectSameResult(R"(["%", ["number", ["get", "x"], 0], 3])");
+    expectSameResult(R"(["^", 2, ["zoom"]])");
+    expectSameResult(R"(["max", ["zoom"], ["number", ["get", "x"], 0]])");
+    expectSameResult(R"(["min", ["zoom"], ["number", ["get", "x"], 0], 5])");
+    expectSameResult(R"(["ln", ["+", ["number", ["get", "x"], 0], 10]])");
+}
+
+TEST(CompiledExpression, Comparison) {
+    expectSameResult(R"([">", ["number", ["get", "x"], 0], ["zoom"]])");
+    expectSameResult(R"(["==", ["to-string", ["get", "s"]], "a"])");
+    expectSameResult(R"(["!=", ["to-number", ["get", "x"]], 7])");
+    expectSameResult(R"(["<", ["string", ["get", "s"], ""], "b"])");
+    expectSameResult(R"(["!", ["boolean", ["get", "b"], false]])");
+    expectSameResult(R"(["case", ["has", "b"], ["get", "x"], ["zoom"]])");
+    expectSameResult(R"(["case", ["boolean", ["get", "b"], false], 1, [">", ["zoom"], 5], 2, 3])");
+}
+
+TEST(CompiledExpression, Coercion) {
+    expectSameResult(R"(["to-string", ["get", "x"]])");
+    expectSameResult(R"(["to-number", ["get", "x"]])");
+    expectSameResult(R"(["to-number", ["get", "s"], ["get", "x"], 0])");
+    expectSameResult(R"(["+", ["to-number", ["get", "b"], -1], ["zoom"]])");
+}
+
+TEST(CompiledExpression, Step) {
+    expectSameResult(R"(["step", ["zoom"], 0, 4, 1, 10, 2])");
+    expectSameResult(R"(["step", ["number", ["get", "x"], 0], "low", 0, "mid", 5, "high"])");
+    expectSameResult(R"(["step", ["get", "x"], 0, 1, 1])");
+}
+
+TEST(CompiledExpression, Interpolate) {
+    expectSameResult(R"(["interpolate", ["linear"], ["zoom"], 0, 0, 10, 100])");
+    expectSameResult(R"(["interpolate", ["exponential", 2], ["zoom"], 1, 1, 5, 10, 20, 40])");
+    expectSameResult(R"(["interpolate", ["linear"], ["zoom"], 5, ["number", ["get", "x"], 0], 15, ["*", 2, ["number", ["get", "x"], 0]]])");
+    expectSameResult(R"(["interpolate", ["linear"], ["zoom"], 0, "red", 10, "blue"])");
+    expectSameResult(R"(["interpolate", ["linear"], ["get", "x"], 0, 0, 10, 1])");
+}
+
+TEST(CompiledExpression, Match) {
+    expectSameResult(R"(["match", ["get", "s"], "a", 1, ["b", "c"], 2, 0])");
+    expectSameResult(R"(["match", ["get", "x"], 7, "seven", [-2, 3], "other", "none"])");
+    expectSameResult(R"(["match", ["string", ["get", "s"], ""], "a", ["zoom"], -1])");
+}
+
+TEST(CompiledExpression, Unsupported) {
+    // Expressions the compiler doesn't cover are left to the tree evaluator.
+    auto tree = parse(R"(["concat", ["to-string", ["get", "x"]], "!"])");
+    ASSERT_TRUE(bool(tree));
+    EXPECT_FALSE(bool(CompiledExpression::compile(*tree)));
+}
@@ -69,3 +69,21 @@ TEST(CompositeFunction, Issue8460) {
     EXPECT_NEAR(600.0f, fn2.evaluate(18.0f, oneInteger, -1.0f), 0.00);
     EXPECT_NEAR(600.0f, fn2.evaluate(19.0f, oneInteger, -1.0f), 0.00);
 }
+
+TEST(CompositeFunction, Batch) {
+    CompositeFunction<float> fn("property", CompositeExponentialStops<float>({
+        {0.0f, {{uint64_t(1), 0.0f}}},
+        {10.0f, {{uint64_t(1), 100.0f}}}
+    }), 5.0f);
+
+    StubGeometryTileFeature other { PropertyMap {{ "property", "x"s }} };
+    std::vector<const StubGeometryTileFeature*> features { &oneInteger, &other };
+
+    const Range<float> zoomRange { 4.0f, 5.0f };
+    const std::vector<Range<float>> result = fn.evaluate(zoomRange, features, -1.0f);
+    ASSERT_EQ(2u, result.size());
+    EXPECT_EQ(fn.evaluate(zoomRange, oneInteger, -1.0f), result[0]);
+    EXPECT_EQ(fn.evaluate(zoomRange, other, -1.0f), result[1]);
+    EXPECT_EQ((Range<float> { 40.0f, 50.0f }), result[0]);
+    EXPECT_EQ((Range<float> { 5.0f, 5.0f }), result[1]);
+}
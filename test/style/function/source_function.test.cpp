@@ -2,6 +2,10 @@
 #include <mbgl/test/stub_geometry_tile_feature.hpp>
 
 #include <mbgl/style/function/source_function.hpp>
+#include <mbgl/style/conversion.hpp>
+#include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/style/expression/parsing_context.hpp>
+#include <mbgl/util/rapidjson.hpp>
 
 using namespace mbgl;
 using namespace mbgl::style;
@@ -95,3 +99,33 @@ TEST(SourceFunction, Categorical) {
     EXPECT_EQ(1.0f, SourceFunction<float>("property", CategoricalStops<float>({{ false, 1.0f }}))
         .evaluate(falseFeature, 0.0f));
 }
+
+TEST(SourceFunction, Batch) {
+    SourceFunction<float> fn("property", CategoricalStops<float>({{ int64_t(1), 1.0f }}), 2.0f);
+    std::vector<const StubGeometryTileFeature*> features { &oneInteger, &oneString, &oneDouble, &trueFeature };
+
+    const std::vector<float> result = fn.evaluate(features, 0.0f);
+    ASSERT_EQ(features.size(), result.size());
+    for (std::size_t i = 0; i < features.size(); i++) {
+        EXPECT_EQ(fn.evaluate(*features[i], 0.0f), result[i]);
+    }
+    EXPECT_EQ((std::vector<float> { 1.0f, 2.0f, 1.0f, 2.0f }), result);
+}
+
+TEST(SourceFunction, FeatureState) {
+    JSDocument document;
+    document.Parse<0>(R"(["number", ["coalesce", ["feature-state", "width"], ["get", "property"]]])");
+    const JSValue* value = &document;
+    expression::ParsingContext ctx;
+    expression::ParseResult parsed = ctx.parse(conversion::Convertible(value));
+    ASSERT_TRUE(bool(parsed));
+
+    SourceFunction<float> fn(std::move(*parsed));
+    EXPECT_FALSE(fn.isFeatureStateConstant());
+    EXPECT_EQ(1.0f, fn.evaluate(oneDouble, 0.0f));
+    EXPECT_EQ(1.0f, fn.evaluate(oneDouble, FeatureState {}, 0.0f));
+    EXPECT_EQ(4.0f, fn.evaluate(oneDouble, FeatureState {{ "width", 4.0 }}, 0.0f));
+
+    EXPECT_TRUE(SourceFunction<float>("property", CategoricalStops<float>({{ int64_t(1), 1.0f }}))
+        .isFeatureStateConstant());
+}
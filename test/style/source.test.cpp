@@ -64,7 +64,8 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        RasterTextureFormat::RGBA
     };
 
     SourceTest() {
@@ -0,0 +1,71 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/collision_grid.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/util/constants.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+CollisionGrid::Entry entry(std::size_t index, CollisionGrid::BBox bbox) {
+    return { bbox, CollisionBox({ 0, 0 }, { 0, 0 }, 0, 0, 0, 0, 0), IndexedSubfeature { index, 0, 0, index } };
+}
+
+std::vector<std::size_t> query(const CollisionGrid& grid, CollisionGrid::BBox bbox) {
+    std::vector<std::size_t> result;
+    grid.query(bbox, [&] (const CollisionGrid::Entry& e) {
+        result.push_back(e.feature.index);
+        return true;
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+CollisionFeature label(float x, float y, std::size_t index) {
+    return CollisionFeature(GeometryCoordinates(), Anchor(x, y, 0, 0), -10, 10, -50, 50, 1, 0,
+                            style::SymbolPlacementType::Point, IndexedSubfeature { index, 0, 0, index },
+                            CollisionFeature::AlignmentType::Curved);
+}
+
+} // namespace
+
+TEST(CollisionGrid, Query) {
+    CollisionGrid grid({ 0, 0, 100, 100 }, 10);
+    grid.insert(entry(0, { 4, 10, 6, 30 }));
+    grid.insert(entry(1, { 4, 10, 30, 12 }));
+    grid.insert(entry(2, { -50, 30, -40, 31 }));
+    grid.insert(entry(3, { -1000, -1000, 1000, 1000 }));
+
+    EXPECT_EQ((std::vector<std::size_t> { 0, 1, 3 }), query(grid, { 4, 10, 5, 11 }));
+    EXPECT_EQ((std::vector<std::size_t> { 0, 1, 3 }), query(grid, { 0, 0, 100, 100 }));
+    EXPECT_EQ((std::vector<std::size_t> { 2, 3 }), query(grid, { -45, 0, -42, 50 }));
+    EXPECT_EQ((std::vector<std::size_t> { 3 }), query(grid, { 200, 200, 300, 300 }));
+
+    // Touching boxes intersect.
+    EXPECT_EQ((std::vector<std::size_t> { 1, 3 }), query(grid, { 30, 12, 40, 20 }));
+}
+
+TEST(CollisionTile, Placement) {
+    CollisionTile tile(PlacementConfig {});
+
+    auto first = label(1000, 1000, 0);
+    EXPECT_EQ(tile.minScale, tile.placeFeature(first, false, false));
+    tile.insertFeature(first, tile.minScale, false);
+
+    // Overlaps the first label at every scale.
+    auto second = label(1000, 1000, 1);
+    EXPECT_GE(tile.placeFeature(second, false, false), tile.maxScale);
+    EXPECT_EQ(tile.minScale, tile.placeFeature(second, true, false));
+
+    auto far = label(util::EXTENT - 1000, util::EXTENT - 1000, 2);
+    EXPECT_EQ(tile.minScale, tile.placeFeature(far, false, false));
+    tile.insertFeature(far, tile.minScale, true);
+
+    auto hits = tile.queryRenderedSymbols({ { 990, 990 }, { 1010, 990 }, { 1010, 1010 }, { 990, 1010 } }, 1);
+    ASSERT_EQ(1u, hits.size());
+    EXPECT_EQ(0u, hits[0].index);
+
+    hits = tile.queryRenderedSymbols({ { 0, 0 }, { util::EXTENT, 0 }, { util::EXTENT, util::EXTENT }, { 0, util::EXTENT } }, 1);
+    EXPECT_EQ(2u, hits.size());
+}
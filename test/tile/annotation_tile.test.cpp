@@ -43,7 +43,8 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        RasterTextureFormat::RGBA
     };
 };
 
@@ -41,7 +41,8 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        RasterTextureFormat::RGBA
     };
 };
 
@@ -37,7 +37,8 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        RasterTextureFormat::RGBA
     };
 };
 
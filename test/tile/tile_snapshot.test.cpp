@@ -0,0 +1,149 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/tile/tile_snapshot.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/renderer/buckets/fill_bucket.hpp>
+#include <mbgl/renderer/render_layer.hpp>
+#include <mbgl/renderer/transition_parameters.hpp>
+#include <mbgl/renderer/property_evaluation_parameters.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/conversion.hpp>
+#include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/style/expression/parsing_context.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+class SnapshotTest {
+public:
+    SnapshotTest() {
+        layer.setSourceLayer("water");
+        renderLayer = RenderLayer::create(layer.baseImpl);
+        renderLayer->transition(TransitionParameters { Clock::time_point::max(), TransitionOptions() });
+        renderLayer->evaluate(PropertyEvaluationParameters { float(tileID.overscaledZ) });
+        groups.push_back({ renderLayer.get() });
+
+        GeometryCollection polygon { { { 0, 0 }, { 0, 100 }, { 100, 100 }, { 0, 0 } } };
+        std::shared_ptr<Bucket> bucket = renderLayer->createBucket(parameters, groups[0]);
+        bucket->addFeature(StubGeometryTileFeature { {}, FeatureType::Polygon, polygon, {} }, polygon);
+        buckets.emplace("fill", bucket);
+
+        featureIndex.setBucketLayerIDs("fill", { "fill" });
+        featureIndex.insert(polygon, 0, featureIndex.intern("water"), featureIndex.intern("fill"));
+    }
+
+    const OverscaledTileID tileID { 10, 0, 10, 163, 395 };
+    const TileSnapshot::Key key { tileID, 42, 7 };
+    const BucketParameters parameters { tileID, MapMode::Still, 1.0 };
+    FillLayer layer { "fill", "source" };
+    std::unique_ptr<RenderLayer> renderLayer;
+    TileSnapshot::LayerGroups groups;
+    TileSnapshot::Buckets buckets;
+    FeatureIndex featureIndex;
+};
+
+} // namespace
+
+TEST(TileSnapshot, RoundTrip) {
+    SnapshotTest test;
+
+    auto snapshot = TileSnapshot::encode(test.key, test.groups, test.buckets, test.featureIndex);
+    ASSERT_TRUE(bool(snapshot));
+    EXPECT_EQ(0u, snapshot->size() % 8);
+
+    auto result = TileSnapshot::decode(snapshot->data(), snapshot->size(), test.key, test.parameters, test.groups);
+    ASSERT_TRUE(bool(result));
+    ASSERT_EQ(1u, result->buckets.size());
+
+    const auto& original = static_cast<const FillBucket&>(*test.buckets.at("fill"));
+    const auto& restored = static_cast<const FillBucket&>(*result->buckets.at("fill"));
+    EXPECT_TRUE(restored.hasData());
+    EXPECT_EQ(original.vertices.byteSize(), restored.vertices.byteSize());
+    EXPECT_EQ(original.lines.vector(), restored.lines.vector());
+    EXPECT_EQ(original.triangles.vector(), restored.triangles.vector());
+    ASSERT_EQ(original.triangleSegments.size(), restored.triangleSegments.size());
+    EXPECT_EQ(original.triangleSegments[0].indexLength, restored.triangleSegments[0].indexLength);
+
+    // Encoding the restored tile yields an identical snapshot.
+    EXPECT_EQ(*snapshot, *TileSnapshot::encode(test.key, test.groups, result->buckets, *result->featureIndex));
+}
+
+TEST(TileSnapshot, Mismatch) {
+    SnapshotTest test;
+
+    auto snapshot = TileSnapshot::encode(test.key, test.groups, test.buckets, test.featureIndex);
+    ASSERT_TRUE(bool(snapshot));
+
+    const TileSnapshot::Key otherLayers { test.tileID, 43, 7 };
+    const TileSnapshot::Key otherData { test.tileID, 42, 8 };
+    const TileSnapshot::Key otherTile { { 10, 0, 10, 163, 396 }, 42, 7 };
+
+    EXPECT_FALSE(TileSnapshot::decode(snapshot->data(), snapshot->size(), otherLayers, test.parameters, test.groups));
+    EXPECT_FALSE(TileSnapshot::decode(snapshot->data(), snapshot->size(), otherData, test.parameters, test.groups));
+    EXPECT_FALSE(TileSnapshot::decode(snapshot->data(), snapshot->size(), otherTile, test.parameters, test.groups));
+    EXPECT_FALSE(TileSnapshot::decode(snapshot->data(), snapshot->size() / 2, test.key, test.parameters, test.groups));
+    EXPECT_FALSE(TileSnapshot::decode(snapshot->data(), 0, test.key, test.parameters, test.groups));
+}
+
+TEST(TileSnapshot, LittleEndian) {
+    SnapshotTest test;
+
+    auto snapshot = TileSnapshot::encode(test.key, test.groups, test.buckets, test.featureIndex);
+    ASSERT_TRUE(bool(snapshot));
+    ASSERT_LE(16u, snapshot->size());
+
+    // The header reads the same whatever the byte order of the host that wrote it.
+    EXPECT_EQ("MBTS", snapshot->substr(0, 4));
+    EXPECT_EQ(std::string("\x01\x00\x00\x00", 4), snapshot->substr(4, 4));
+    EXPECT_EQ(std::string("\x2A\x00\x00\x00\x00\x00\x00\x00", 8), snapshot->substr(8, 8));
+}
+
+TEST(TileSnapshot, FeatureState) {
+    SnapshotTest test;
+
+    auto snapshot = TileSnapshot::encode(test.key, test.groups, test.buckets, test.featureIndex);
+    ASSERT_TRUE(bool(snapshot));
+
+    JSDocument document;
+    document.Parse<0>(R"(["number", ["coalesce", ["feature-state", "opacity"], 0.25]])");
+    const JSValue* value = &document;
+    expression::ParsingContext ctx;
+    expression::ParseResult parsed = ctx.parse(conversion::Convertible(value));
+    ASSERT_TRUE(bool(parsed));
+
+    FillLayer layer { "fill", "source" };
+    layer.setSourceLayer("water");
+    layer.setFillOpacity(SourceFunction<float>(std::move(*parsed)));
+    auto renderLayer = RenderLayer::create(layer.baseImpl);
+    renderLayer->transition(TransitionParameters { Clock::time_point::max(), TransitionOptions() });
+    renderLayer->evaluate(PropertyEvaluationParameters { float(test.tileID.overscaledZ) });
+    const TileSnapshot::LayerGroups groups { { renderLayer.get() } };
+
+    // Buckets whose paint depends on feature state are neither stored nor restored, so
+    // every bucket that can pick up state changes comes from a regular layout.
+    GeometryCollection polygon { { { 0, 0 }, { 0, 100 }, { 100, 100 }, { 0, 0 } } };
+    std::shared_ptr<Bucket> bucket = renderLayer->createBucket(test.parameters, groups[0]);
+    bucket->addFeature(StubGeometryTileFeature { {}, FeatureType::Polygon, polygon, {} }, polygon);
+    EXPECT_FALSE(TileSnapshot::encode(test.key, groups, { { "fill", bucket } }, test.featureIndex));
+    EXPECT_FALSE(TileSnapshot::decode(snapshot->data(), snapshot->size(), test.key, test.parameters, groups));
+}
+
+TEST(TileSnapshot, Hashes) {
+    FillLayer fill { "fill", "source" };
+    fill.setSourceLayer("water");
+    FillLayer other { "fill", "source" };
+    other.setSourceLayer("landuse");
+
+    const std::vector<Immutable<Layer::Impl>> layers { fill.baseImpl };
+    EXPECT_EQ(TileSnapshot::hashLayers(layers), TileSnapshot::hashLayers({ fill.baseImpl }));
+    EXPECT_NE(TileSnapshot::hashLayers(layers), TileSnapshot::hashLayers({ other.baseImpl }));
+    EXPECT_NE(TileSnapshot::hashLayers(layers), TileSnapshot::hashLayers({ fill.baseImpl, other.baseImpl }));
+
+    EXPECT_EQ(TileSnapshot::hashData("tile"), TileSnapshot::hashData("tile"));
+    EXPECT_NE(TileSnapshot::hashData("tile"), TileSnapshot::hashData("tilf"));
+}
@@ -7,6 +7,7 @@
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/style/style.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
@@ -16,14 +17,44 @@
 #include <mbgl/annotation/annotation_manager.hpp>
 #include <mbgl/renderer/image_manager.hpp>
 #include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/util/io.hpp>
 
+#include <map>
 #include <memory>
 
 using namespace mbgl;
 
+// Keeps tile snapshots in memory once they are enabled.
+class SnapshotFileSource : public FakeFileSource {
+public:
+    bool supportsCacheOnlyRequests() const override {
+        return snapshots;
+    }
+
+    bool supportsTileSnapshots() const override {
+        return snapshots;
+    }
+
+    void getTileSnapshot(const Resource& resource, uint64_t layersHash, SnapshotCallback callback) override {
+        auto it = stored.find({ resource.url, layersHash });
+        callback(it == stored.end() ? nullptr : it->second);
+        lookups++;
+    }
+
+    void putTileSnapshot(const Resource& resource, uint64_t layersHash, std::shared_ptr<const std::string> snapshot) override {
+        stored[{ resource.url, layersHash }] = std::move(snapshot);
+        puts++;
+    }
+
+    bool snapshots = false;
+    std::map<std::pair<std::string, uint64_t>, std::shared_ptr<const std::string>> stored;
+    size_t lookups = 0;
+    size_t puts = 0;
+};
+
 class VectorTileTest {
 public:
-    FakeFileSource fileSource;
+    SnapshotFileSource fileSource;
     TransformState transformState;
     util::RunLoop loop;
     ThreadPool threadPool { 1 };
@@ -43,7 +74,8 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        RasterTextureFormat::RGBA
     };
 };
 
@@ -107,3 +139,54 @@ TEST(VectorTile, Issue8542) {
     std::vector<Feature> result;
     tile.querySourceFeatures(result, { { {"layer"} }, {} });
 }
+
+TEST(VectorTile, Snapshot) {
+    VectorTileTest test;
+    test.fileSource.snapshots = true;
+
+    style::FillLayer layer("water", "source");
+    layer.setSourceLayer("water");
+
+    Response response;
+    response.data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+
+    // The tile asks the file source's cache first; answering that request hands it cached data.
+    auto load = [&] (bool fromCache) {
+        VectorTile tile(OverscaledTileID(10, 163, 395), "source", test.tileParameters, test.tileset);
+        tile.setLayers({{ layer.baseImpl }});
+        tile.setPlacementConfig({});
+        if (fromCache) {
+            ASSERT_TRUE(test.fileSource.respond(Resource::Tile, response));
+        } else {
+            tile.setData(response.data);
+        }
+
+        while (!tile.isComplete()) {
+            test.loop.runOnce();
+        }
+
+        ASSERT_TRUE(tile.isRenderable());
+        ASSERT_NE(nullptr, tile.getBucket(*layer.baseImpl));
+
+        // Laying out the same data with other layers doesn't store it again.
+        if (!fromCache) {
+            tile.setLayers({});
+            while (!tile.isComplete()) {
+                test.loop.runOnce();
+            }
+        }
+    };
+
+    // Data that didn't come from the cache can't have a snapshot there, so none is looked up.
+    // Its first layout is stored...
+    load(false);
+    EXPECT_EQ(0u, test.fileSource.lookups);
+    EXPECT_EQ(1u, test.fileSource.puts);
+    EXPECT_EQ(1u, test.fileSource.stored.size());
+
+    // ...and restored when the tile is laid out from cached data, rather than laid out and
+    // stored anew.
+    load(true);
+    EXPECT_EQ(1u, test.fileSource.lookups);
+    EXPECT_EQ(1u, test.fileSource.puts);
+}
@@ -0,0 +1,111 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/compression.hpp>
+
+#include <zlib.h>
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace mbgl;
+
+namespace {
+
+// util::compress() writes zlib streams; tiles in MBTiles archives are gzipped instead.
+std::string gzip(const std::string& raw) {
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("failed to initialize deflate");
+    }
+
+    std::string result(deflateBound(&stream, uLong(raw.size())), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(raw.data()));
+    stream.avail_in = uInt(raw.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&result[0]);
+    stream.avail_out = uInt(result.size());
+    const int code = deflate(&stream, Z_FINISH);
+    result.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    if (code != Z_STREAM_END) {
+        throw std::runtime_error("failed to deflate");
+    }
+    return result;
+}
+
+// Overwrites the uncompressed size that the gzip trailer records.
+std::string withSize(std::string compressed, uint32_t size) {
+    for (std::size_t i = 0; i < 4; i++) {
+        compressed[compressed.size() - 4 + i] = char(size >> (8 * i));
+    }
+    return compressed;
+}
+
+// A few kilobytes of numbers, repeated. It compresses quickly and well, but not so well
+// that the recorded size exceeds what deflate could possibly have produced.
+std::string text(std::size_t size) {
+    std::string block;
+    for (uint32_t i = 0; block.size() < 4096; i++) {
+        block += std::to_string(i * 2654435761u % 1000003) + ' ';
+    }
+
+    std::string result;
+    result.reserve(size + block.size());
+    while (result.size() < size) {
+        result += block;
+    }
+    result.resize(size);
+    return result;
+}
+
+} // namespace
+
+TEST(Compression, ZlibRoundTrip) {
+    const std::string raw = text(100000);
+    const std::string compressed = util::compress(raw);
+    EXPECT_LT(compressed.size(), raw.size());
+    EXPECT_EQ(raw, util::decompress(compressed));
+    EXPECT_EQ(raw, util::decompress(compressed.data(), compressed.size()));
+}
+
+TEST(Compression, GzipRoundTrip) {
+    const std::string raw = text(100000);
+    const std::string compressed = gzip(raw);
+    EXPECT_EQ(raw, util::decompress(compressed.data(), compressed.size()));
+
+    EXPECT_EQ("", util::decompress(gzip("")));
+    EXPECT_EQ("", util::decompress(util::compress("")));
+}
+
+TEST(Compression, GzipWrongSize) {
+    const std::string raw = text(100000);
+    const std::string compressed = gzip(raw);
+
+    // The recorded size is only a hint for the output buffer. Inflating into a buffer that
+    // is too small or too large must not overrun it, and zlib's length check then rejects
+    // the stream.
+    EXPECT_THROW(util::decompress(withSize(compressed, raw.size() - 1000)), std::runtime_error);
+    EXPECT_THROW(util::decompress(withSize(compressed, raw.size() + 1000)), std::runtime_error);
+    EXPECT_THROW(util::decompress(withSize(compressed, 0)), std::runtime_error);
+    EXPECT_THROW(util::decompress(withSize(compressed, 0xFFFFFFFF)), std::runtime_error);
+}
+
+TEST(Compression, PresizeLimit) {
+    // Sizes on both sides of the 8 MiB limit above which the output isn't presized.
+    for (const std::size_t size : { std::size_t(8 * 1024 * 1024 - 1), std::size_t(8 * 1024 * 1024 + 1) }) {
+        const std::string raw = text(size);
+        EXPECT_EQ(raw, util::decompress(gzip(raw))) << size;
+        EXPECT_EQ(raw, util::decompress(util::compress(raw))) << size;
+    }
+}
+
+TEST(Compression, Truncated) {
+    const std::string raw = text(100000);
+    const std::string zlib = util::compress(raw);
+    const std::string gzipped = gzip(raw);
+
+    EXPECT_THROW(util::decompress(zlib.data(), zlib.size() / 2), std::runtime_error);
+    EXPECT_THROW(util::decompress(gzipped.data(), gzipped.size() - 1), std::runtime_error);
+    EXPECT_THROW(util::decompress(std::string("not compressed")), std::runtime_error);
+}
@@ -0,0 +1,77 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/util/grid_index.hpp>
+
+#include <thread>
+
+using namespace mbgl;
+
+namespace {
+
+IndexedSubfeature subfeature(std::size_t index) {
+    return { index, 0, 0, index };
+}
+
+std::vector<std::size_t> indices(const std::vector<IndexedSubfeature>& features) {
+    std::vector<std::size_t> result;
+    for (const auto& feature : features) {
+        result.push_back(feature.index);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(GridIndex, Query) {
+    GridIndex<IndexedSubfeature> grid(100, 10, 0);
+    grid.insert(subfeature(0), { { 4, 10 }, { 6, 30 } });
+    grid.insert(subfeature(1), { { 4, 10 }, { 30, 12 } });
+    grid.insert(subfeature(2), { { -10, 30 }, { -9, 31 } });
+
+    EXPECT_EQ((std::vector<std::size_t> { 0, 1 }), indices(grid.query({ { 4, 10 }, { 5, 11 } })));
+    EXPECT_EQ((std::vector<std::size_t> { 1 }), indices(grid.query({ { 10, 10 }, { 20, 20 } })));
+    EXPECT_EQ((std::vector<std::size_t> { 2 }), indices(grid.query({ { -100, -100 }, { -5, 100 } })));
+    EXPECT_EQ((std::vector<std::size_t> {}), indices(grid.query({ { 50, 50 }, { 60, 60 } })));
+}
+
+TEST(GridIndex, QueryReportsSpanningElementsOnce) {
+    GridIndex<IndexedSubfeature> grid(100, 10, 0);
+    grid.insert(subfeature(0), { { 0, 0 }, { 100, 100 } });
+
+    std::size_t visits = 0;
+    grid.query({ { 20, 20 }, { 80, 80 } }, [&] (const IndexedSubfeature& feature, const GridIndex<IndexedSubfeature>::BBox&) {
+        EXPECT_EQ(0u, feature.index);
+        visits++;
+    });
+    EXPECT_EQ(1u, visits);
+
+    // Inserting after a query makes the new element visible to the next one.
+    grid.insert(subfeature(1), { { 50, 50 }, { 55, 55 } });
+    EXPECT_EQ((std::vector<std::size_t> { 0, 1 }), indices(grid.query({ { 20, 20 }, { 80, 80 } })));
+}
+
+TEST(GridIndex, ConcurrentQueries) {
+    GridIndex<IndexedSubfeature> grid(100, 10, 0);
+    for (std::size_t i = 0; i < 1000; ++i) {
+        const int16_t x = i % 100;
+        grid.insert(subfeature(i), { { x, x }, { int16_t(x + 5), int16_t(x + 5) } });
+    }
+
+    // The first queries after the insertions build the cells; none of them may see a
+    // partially built grid.
+    std::vector<std::size_t> results(8);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        threads.emplace_back([&, i] {
+            results[i] = grid.query({ { 0, 0 }, { 100, 100 } }).size();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (std::size_t result : results) {
+        EXPECT_EQ(1000u, result);
+    }
+}
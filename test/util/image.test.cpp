@@ -3,6 +3,10 @@
 #include <mbgl/util/premultiply.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
+#include <mbgl/util/png_stream_writer.hpp>
+
+#include <cstring>
+#include <sstream>
 
 using namespace mbgl;
 
@@ -34,6 +38,46 @@ TEST(Image, PNGRoundTripAlpha) {
     EXPECT_EQ(128, image.data[3]);
 }
 
+TEST(Image, PNGStreamWriter) {
+    // Wide enough that the compressed data spans several IDAT chunks.
+    PremultipliedImage rgba({ 300, 200 });
+    for (size_t i = 0; i < rgba.bytes(); i += 4) {
+        const uint8_t alpha = (i / 4) % 256;
+        rgba.data[i + 0] = (i * 7) % (alpha + 1);
+        rgba.data[i + 1] = (i * 13) % (alpha + 1);
+        rgba.data[i + 2] = (i * 31) % (alpha + 1);
+        rgba.data[i + 3] = alpha;
+    }
+
+    std::ostringstream out;
+    PNGStreamWriter writer(out, rgba.size);
+    for (uint32_t y = 0; y < rgba.size.height; y++) {
+        writer.writeRow(rgba.data.get() + y * rgba.stride());
+    }
+    writer.finish();
+
+    // The chunks are laid out differently, but the pixels are the same.
+    PremultipliedImage streamed = decodeImage(out.str());
+    PremultipliedImage encoded = decodeImage(encodePNG(rgba));
+    ASSERT_EQ(encoded.size, streamed.size);
+    EXPECT_EQ(0, std::memcmp(encoded.data.get(), streamed.data.get(), encoded.bytes()));
+}
+
+TEST(Image, PNGStreamWriterRowCount) {
+    PremultipliedImage rgba({ 2, 2 });
+
+    std::ostringstream tooFew;
+    PNGStreamWriter short_(tooFew, rgba.size);
+    short_.writeRow(rgba.data.get());
+    EXPECT_THROW(short_.finish(), std::runtime_error);
+
+    std::ostringstream tooMany;
+    PNGStreamWriter long_(tooMany, rgba.size);
+    long_.writeRow(rgba.data.get());
+    long_.writeRow(rgba.data.get());
+    EXPECT_THROW(long_.writeRow(rgba.data.get()), std::runtime_error);
+}
+
 TEST(Image, PNGReadNoProfile) {
     PremultipliedImage image = decodeImage(util::read_file("test/fixtures/image/no_profile.png"));
     EXPECT_EQ(128, image.data[0]);
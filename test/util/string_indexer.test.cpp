@@ -0,0 +1,35 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/string_indexer.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+
+using namespace mbgl;
+
+TEST(StringIndexer, Identity) {
+    StringIndexer indexer;
+    const StringIdentity water = indexer.get("water");
+    const StringIdentity road = indexer.get("road");
+
+    EXPECT_NE(water, road);
+    EXPECT_EQ(water, indexer.get(std::string("water")));
+    EXPECT_EQ("water", indexer.get(water));
+    EXPECT_EQ("road", indexer.get(road));
+
+    // References stay valid while the indexer grows.
+    const std::string& name = indexer.get(water);
+    for (std::size_t i = 0; i < 1000; ++i) {
+        indexer.get(std::to_string(i));
+    }
+    EXPECT_EQ("water", name);
+}
+
+TEST(StringIndexer, FeatureIndex) {
+    FeatureIndex a;
+    const StringIdentity sourceLayer = a.intern("source-layer");
+    EXPECT_EQ(sourceLayer, a.intern("source-layer"));
+    EXPECT_NE(sourceLayer, a.intern("bucket"));
+
+    // Each index has its own table, so names of other tiles don't accumulate.
+    FeatureIndex b;
+    EXPECT_EQ(sourceLayer, b.intern("other-source-layer"));
+}